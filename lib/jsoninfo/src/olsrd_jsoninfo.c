@@ -87,6 +87,7 @@
 #include "common/autobuf.h"
 #include "gateway.h"
 #include "egressTypes.h"
+#include "olsr_cookie.h"
 
 #include "olsrd_jsoninfo.h"
 #include "olsrd_plugin.h"
@@ -132,7 +133,8 @@ static size_t build_http_header(const char *status, const char *mime, uint32_t m
 #define SIW_INTERFACES 0x0080
 #define SIW_2HOP 0x0100
 #define SIW_SGW 0x0200
-#define SIW_RUNTIME_ALL (SIW_NEIGHBORS | SIW_LINKS | SIW_ROUTES | SIW_HNA | SIW_MID | SIW_TOPOLOGY | SIW_GATEWAYS | SIW_INTERFACES | SIW_2HOP | SIW_SGW)
+#define SIW_COOKIES 0x4000
+#define SIW_RUNTIME_ALL (SIW_NEIGHBORS | SIW_LINKS | SIW_ROUTES | SIW_HNA | SIW_MID | SIW_TOPOLOGY | SIW_GATEWAYS | SIW_INTERFACES | SIW_2HOP | SIW_SGW | SIW_COOKIES)
 
 /* these only change at olsrd startup */
 #define SIW_VERSION 0x0400
@@ -530,6 +532,8 @@ static void ipc_action(int fd, void *data __attribute__ ((unused)), unsigned int
           send_what |= SIW_2HOP;
         if (strstr(requ, "/sgw"))
           send_what |= SIW_SGW;
+        if (strstr(requ, "/cookies"))
+          send_what |= SIW_COOKIES;
 
         // specials
         if (strstr(requ, "/version"))
@@ -707,39 +711,34 @@ static void ipc_print_hna(struct autobuf *abuf) {
 }
 
 static void ipc_print_mid(struct autobuf *abuf) {
-  int idx;
   struct mid_entry *entry;
   struct mid_address *alias;
 
   abuf_json_mark_object(true, true, abuf, "mid");
 
   /* MID */
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    entry = mid_set[idx].next;
-
-    while (entry != &mid_set[idx]) {
-      struct ipaddr_str buf, buf2;
-      abuf_json_mark_array_entry(true, abuf);
-      abuf_json_string(abuf, "ipAddress", olsr_ip_to_string(&buf, &entry->main_addr));
-
-      abuf_json_mark_object(true, true, abuf, "aliases");
-      alias = entry->aliases;
-      while (alias) {
-        uint32_t vt = alias->vtime - now_times;
-        int diff = (int) (vt);
+  OLSR_FOR_ALL_MID_ENTRIES(entry) {
+    struct ipaddr_str buf, buf2;
+    abuf_json_mark_array_entry(true, abuf);
+    abuf_json_string(abuf, "ipAddress", olsr_ip_to_string(&buf, &entry->main_addr));
 
-        abuf_json_mark_array_entry(true, abuf);
-        abuf_json_string(abuf, "ipAddress", olsr_ip_to_string(&buf2, &alias->alias));
-        abuf_json_int(abuf, "validityTime", diff);
-        abuf_json_mark_array_entry(false, abuf);
+    abuf_json_mark_object(true, true, abuf, "aliases");
+    alias = entry->aliases;
+    while (alias) {
+      uint32_t vt = alias->vtime - now_times;
+      int diff = (int) (vt);
 
-        alias = alias->next_alias;
-      }
-      abuf_json_mark_object(false, true, abuf, NULL); // aliases
+      abuf_json_mark_array_entry(true, abuf);
+      abuf_json_string(abuf, "ipAddress", olsr_ip_to_string(&buf2, &alias->alias));
+      abuf_json_int(abuf, "validityTime", diff);
       abuf_json_mark_array_entry(false, abuf);
-      entry = entry->next;
+
+      alias = alias->next_alias;
     }
+    abuf_json_mark_object(false, true, abuf, NULL); // aliases
+    abuf_json_mark_array_entry(false, abuf);
   }
+  OLSR_FOR_ALL_MID_ENTRIES_END(entry);
   abuf_json_mark_object(false, true, abuf, NULL); // mid
 }
 
@@ -932,6 +931,39 @@ static void ipc_print_sgw(struct autobuf *abuf) {
 #endif /* __linux__ */
 }
 
+static void ipc_print_cookies(struct autobuf *abuf) {
+  struct olsr_cookie_stats stats;
+  olsr_cookie_t id;
+
+  abuf_json_mark_object(true, true, abuf, "cookies");
+
+  for (id = 1; id < COOKIE_ID_MAX; id++) {
+    if (!olsr_cookie_get_stats(id, &stats)) {
+      continue;
+    }
+
+    abuf_json_mark_array_entry(true, abuf);
+    abuf_json_string(abuf, "name", stats.name);
+    abuf_json_string(abuf, "type", stats.type == OLSR_COOKIE_TYPE_MEMORY ? "memory" : "timer");
+    abuf_json_int(abuf, "usage", stats.usage);
+    abuf_json_int(abuf, "usagePeak", stats.usage_peak);
+    abuf_json_int(abuf, "allocs", stats.allocs);
+    abuf_json_int(abuf, "frees", stats.frees);
+    abuf_json_int(abuf, "allocsPerSecond", stats.alloc_rate);
+    abuf_json_int(abuf, "freesPerSecond", stats.free_rate);
+    if (stats.type == OLSR_COOKIE_TYPE_MEMORY) {
+      abuf_json_int(abuf, "size", stats.size);
+      abuf_json_int(abuf, "freeList", stats.free_list);
+      abuf_json_int(abuf, "slabs", stats.slabs);
+      abuf_json_int(abuf, "bytes", stats.bytes);
+      abuf_json_int(abuf, "bytesPeak", stats.bytes_peak);
+    }
+    abuf_json_mark_array_entry(false, abuf);
+  }
+
+  abuf_json_mark_object(false, true, abuf, NULL);
+}
+
 static void ipc_print_version(struct autobuf *abuf) {
   abuf_json_mark_object(true, false, abuf, "version");
 
@@ -1029,10 +1061,17 @@ static void ipc_print_config(struct autobuf *abuf) {
   // keep all time in ms, so convert these two, which are in seconds
   abuf_json_int(abuf, "pollRate", olsr_cnf->pollrate * 1000);
   abuf_json_int(abuf, "nicChangePollInterval", olsr_cnf->nic_chgs_pollrate * 1000);
+  abuf_json_int(abuf, "inputBatchLimit", olsr_cnf->input_batch_limit);
   abuf_json_boolean(abuf, "clearScreen", olsr_cnf->clear_screen);
   abuf_json_int(abuf, "tcRedundancy", olsr_cnf->tc_redundancy);
   abuf_json_int(abuf, "mprCoverage", olsr_cnf->mpr_coverage);
   abuf_json_boolean(abuf, "dijkstraBinaryHeap", olsr_cnf->dijkstra_binary_heap);
+  abuf_json_boolean(abuf, "dijkstraArrayHeap", olsr_cnf->dijkstra_array_heap);
+  abuf_json_int(abuf, "dijkstraHeapArity", olsr_cnf->dijkstra_heap_arity);
+  abuf_json_boolean(abuf, "dijkstraRadixHeap", olsr_cnf->dijkstra_radix_heap);
+  abuf_json_boolean(abuf, "dijkstraIncremental", olsr_cnf->dijkstra_incremental);
+  abuf_json_boolean(abuf, "dijkstraSnapshot", olsr_cnf->dijkstra_snapshot);
+  abuf_json_boolean(abuf, "dijkstraThread", olsr_cnf->dijkstra_thread);
 
   if (!olsr_cnf->lq_level) {
     abuf_json_boolean(abuf, "useHysteresis", olsr_cnf->use_hysteresis);
@@ -1093,6 +1132,8 @@ static void ipc_print_config(struct autobuf *abuf) {
   abuf_json_string(abuf, "unicastSourceIpAddress", olsr_ip_to_string(&mainaddrbuf, &olsr_cnf->unicast_src_ip));
 
   abuf_json_boolean(abuf, "useSourceIpRoutes", olsr_cnf->use_src_ip_routes);
+  abuf_json_boolean(abuf, "netlinkBatch", olsr_cnf->nl_batch);
+  abuf_json_boolean(abuf, "memorySlabs", olsr_cnf->memory_slabs);
 
   abuf_json_int(abuf, "maxPrefixLength", olsr_cnf->maxplen);
   abuf_json_int(abuf, "ipSize", olsr_cnf->ipsize);
@@ -1360,6 +1401,8 @@ static void send_info(unsigned int send_what, int the_socket) {
       ipc_print_neighbors(&abuf, true);
     if (send_what & SIW_SGW)
       ipc_print_sgw(&abuf);
+    if (send_what & SIW_COOKIES)
+      ipc_print_cookies(&abuf);
 
     if (send_what & SIW_VERSION)
       ipc_print_version(&abuf);
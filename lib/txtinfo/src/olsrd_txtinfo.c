@@ -81,6 +81,7 @@
 #include "lq_plugin.h"
 #include "common/autobuf.h"
 #include "gateway.h"
+#include "olsr_cookie.h"
 
 #include "olsrd_txtinfo.h"
 #include "olsrd_plugin.h"
@@ -118,6 +119,8 @@ static void ipc_print_interface(struct autobuf *);
 
 static void ipc_print_sgw(struct autobuf *);
 
+static void ipc_print_cookies(struct autobuf *);
+
 #define TXT_IPC_BUFSIZE 256
 
 #define SIW_NEIGH 0x0001
@@ -132,6 +135,7 @@ static void ipc_print_sgw(struct autobuf *);
 #define SIW_2HOP 0x0200
 #define SIW_VERSION 0x0400
 #define SIW_SGW 0x0800
+#define SIW_COOKIES 0x1000
 
 /* ALL = neigh link route hna mid topo */
 #define SIW_ALL 0x003F
@@ -346,6 +350,7 @@ ipc_action(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
         if (0 != strstr(requ, "/2ho")) send_what |= SIW_2HOP;
         if (0 != strstr(requ, "/ver")) send_what |= SIW_VERSION;
         if (0 != strstr(requ, "/sgw")) send_what |= SIW_SGW;
+        if (0 != strstr(requ, "/coo")) send_what |= SIW_COOKIES;
       }
     }
 
@@ -629,7 +634,6 @@ ipc_print_sgw(struct autobuf *abuf)
 static void
 ipc_print_mid(struct autobuf *abuf)
 {
-  int idx;
   unsigned short is_first;
   struct mid_entry *entry;
   struct mid_address *alias;
@@ -640,40 +644,36 @@ ipc_print_mid(struct autobuf *abuf)
 #endif /* ACTIVATE_VTIME_TXTINFO */
 
   /* MID */
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    entry = mid_set[idx].next;
-
-    while (entry != &mid_set[idx]) {
+  OLSR_FOR_ALL_MID_ENTRIES(entry) {
 #ifdef ACTIVATE_VTIME_TXTINFO
-      struct ipaddr_str buf, buf2;
+    struct ipaddr_str buf, buf2;
 #else /* ACTIVATE_VTIME_TXTINFO */
-      struct ipaddr_str buf;
-      abuf_puts(abuf, olsr_ip_to_string(&buf, &entry->main_addr));
+    struct ipaddr_str buf;
+    abuf_puts(abuf, olsr_ip_to_string(&buf, &entry->main_addr));
 #endif /* ACTIVATE_VTIME_TXTINFO */
-      alias = entry->aliases;
-      is_first = 1;
+    alias = entry->aliases;
+    is_first = 1;
 
-      while (alias) {
+    while (alias) {
 #ifdef ACTIVATE_VTIME_TXTINFO
-        uint32_t vt = alias->vtime - now_times;
-        int diff = (int)(vt);
+      uint32_t vt = alias->vtime - now_times;
+      int diff = (int)(vt);
 
-        abuf_appendf(abuf, "%s\t%s\t%d.%03d\n", 
-                     olsr_ip_to_string(&buf, &entry->main_addr), 
-                     olsr_ip_to_string(&buf2, &alias->alias),
-                     diff/1000, abs(diff%1000));
+      abuf_appendf(abuf, "%s\t%s\t%d.%03d\n", 
+                   olsr_ip_to_string(&buf, &entry->main_addr), 
+                   olsr_ip_to_string(&buf2, &alias->alias),
+                   diff/1000, abs(diff%1000));
 #else /* ACTIVATE_VTIME_TXTINFO */
-        abuf_appendf(abuf, "%s%s", (is_first ? "\t" : ";"), olsr_ip_to_string(&buf, &alias->alias));
+      abuf_appendf(abuf, "%s%s", (is_first ? "\t" : ";"), olsr_ip_to_string(&buf, &alias->alias));
 #endif /* ACTIVATE_VTIME_TXTINFO */
-        alias = alias->next_alias;
-        is_first = 0;
-      }
-      entry = entry->next;
+      alias = alias->next_alias;
+      is_first = 0;
+    }
 #ifndef ACTIVATE_VTIME_TXTINFO
-      abuf_puts(abuf,"\n");
+    abuf_puts(abuf,"\n");
 #endif /* ACTIVATE_VTIME_TXTINFO */
-    }
   }
+  OLSR_FOR_ALL_MID_ENTRIES_END(entry);
   abuf_puts(abuf, "\n");
 }
 
@@ -774,6 +774,25 @@ ipc_print_interface(struct autobuf *abuf)
   abuf_puts(abuf, "\n");
 }
 
+static void
+ipc_print_cookies(struct autobuf *abuf)
+{
+  struct olsr_cookie_stats stats;
+  olsr_cookie_t id;
+
+  abuf_puts(abuf, "Table: Cookies\nName\tType\tUsage\tPeak\tAllocs/s\tFrees/s\tFree list\tSlabs\tBytes\tPeak bytes\n");
+  for (id = 1; id < COOKIE_ID_MAX; id++) {
+    if (!olsr_cookie_get_stats(id, &stats)) {
+      continue;
+    }
+    abuf_appendf(abuf, "%s\t%s\t%u\t%u\t%u\t%u\t%u\t%u\t%lu\t%lu\n", stats.name,
+                 stats.type == OLSR_COOKIE_TYPE_MEMORY ? "memory" : "timer", stats.usage, stats.usage_peak,
+                 stats.alloc_rate, stats.free_rate, stats.free_list, stats.slabs,
+                 (unsigned long)stats.bytes, (unsigned long)stats.bytes_peak);
+  }
+  abuf_puts(abuf, "\n");
+}
+
 
 static void
 txtinfo_write_data(void *foo __attribute__ ((unused))) {
@@ -864,6 +883,8 @@ send_info(unsigned int send_what, int the_socket)
   if ((send_what & SIW_2HOP) == SIW_2HOP) ipc_print_neigh(&abuf,true);
   /* version */
   if ((send_what & SIW_VERSION) == SIW_VERSION) ipc_print_version(&abuf);
+  /* cookies */
+  if ((send_what & SIW_COOKIES) == SIW_COOKIES) ipc_print_cookies(&abuf);
 
   assert(outbuffer_count < MAX_CLIENTS);
 
@@ -386,6 +386,28 @@ void olsrd_write_cnf_autobuf(struct autobuf *out, struct olsrd_config *cnf) {
   abuf_appendf(out, "%sNicChgsPollInt  %.1f\n",
       cnf->nic_chgs_pollrate == (float)DEF_NICCHGPOLLRT ? "# " : "",
       (double)cnf->nic_chgs_pollrate);
+  abuf_appendf(out,
+    "\n"
+    "# Maximum number of OLSR packets read from one socket before the\n"
+    "# input loop yields to the scheduler (CPU overload protection).\n"
+    "# On Linux the packets are read in batches of up to this size.\n"
+    "# Valid values are %u to %u.\n"
+    "# (default is %u)\n"
+    "\n", MIN_INPUT_BATCH_LIMIT, MAX_INPUT_BATCH_LIMIT, DEF_INPUT_BATCH_LIMIT);
+  abuf_appendf(out, "%sInputBatchLimit %u\n",
+      cnf->input_batch_limit == DEF_INPUT_BATCH_LIMIT ? "# " : "",
+      cnf->input_batch_limit);
+  abuf_appendf(out,
+    "\n"
+    "# Carve the fixed size objects of the memory cookies (TC edges, routes,\n"
+    "# timers, ...) from page sized slabs instead of allocating every object\n"
+    "# on its own. This keeps related objects close together and reduces\n"
+    "# heap fragmentation.\n"
+    "# (default is %s)\n"
+    "\n", DEF_MEMORY_SLABS ? "yes" : "no");
+  abuf_appendf(out, "%sMemorySlabs %s\n",
+      cnf->memory_slabs == DEF_MEMORY_SLABS ? "# " : "",
+      cnf->memory_slabs ? "yes" : "no");
   abuf_appendf(out,
     "\n"
     "# TOS(type of service) value for the IP header of control traffic.\n"
@@ -434,6 +456,16 @@ void olsrd_write_cnf_autobuf(struct autobuf *out, struct olsrd_config *cnf) {
   abuf_appendf(out, "%sSrcIpRoutes %s\n",
       cnf->use_src_ip_routes == DEF_USE_SRCIP_ROUTES ? "# " : "",
       cnf->use_src_ip_routes ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# NetlinkBatch packs the route changes of one update into as few\n"
+    "# rtnetlink messages as possible and collects the kernel answers\n"
+    "# afterwards, instead of waiting for every single route\n"
+    "# (default is \"%s\")\n"
+    "\n", DEF_NETLINK_BATCH ? "yes" : "no");
+  abuf_appendf(out, "%sNetlinkBatch %s\n",
+      cnf->nl_batch == DEF_NETLINK_BATCH ? "# " : "",
+      cnf->nl_batch ? "yes" : "no");
   abuf_appendf(out,
     "\n"
     "# Specify the proto tag to be used for routes olsr inserts into kernel\n"
@@ -1004,6 +1036,66 @@ void olsrd_write_cnf_autobuf(struct autobuf *out, struct olsrd_config *cnf) {
   abuf_appendf(out, "%sDijkstraBinaryHeap %s\n",
       cnf->dijkstra_binary_heap == DEF_DIJKSTRA_BINARY_HEAP ? "# " : "",
       cnf->dijkstra_binary_heap ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# Keep the binary heap of the Dijkstra algorithm in a contiguous array\n"
+    "# instead of a pointer tree, this is faster on large topologies.\n"
+    "# Only used when DijkstraBinaryHeap is enabled.\n"
+    "# (default is %s)\n"
+    "\n", DEF_DIJKSTRA_ARRAY_HEAP ? "yes" : "no");
+  abuf_appendf(out, "%sDijkstraArrayHeap %s\n",
+      cnf->dijkstra_array_heap == DEF_DIJKSTRA_ARRAY_HEAP ? "# " : "",
+      cnf->dijkstra_array_heap ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# Number of children per node of the array heap, 2 is a binary heap.\n"
+    "# A 4-ary or 8-ary heap is faster on dense meshes where better paths\n"
+    "# to already known nodes are found often. Only used when\n"
+    "# DijkstraArrayHeap is enabled. Valid values are %u to %u.\n"
+    "# (default is %u)\n"
+    "\n", MIN_DIJKSTRA_HEAP_ARITY, MAX_DIJKSTRA_HEAP_ARITY, DEF_DIJKSTRA_HEAP_ARITY);
+  abuf_appendf(out, "%sDijkstraHeapArity %u\n",
+      cnf->dijkstra_heap_arity == DEF_DIJKSTRA_HEAP_ARITY ? "# " : "",
+      cnf->dijkstra_heap_arity);
+  abuf_appendf(out,
+    "\n"
+    "# Use a radix heap keyed by the integer path costs when running the\n"
+    "# Dijkstra algorithm. It has amortized constant time operations and\n"
+    "# takes precedence over DijkstraBinaryHeap.\n"
+    "# (default is %s)\n"
+    "\n", DEF_DIJKSTRA_RADIX_HEAP ? "yes" : "no");
+  abuf_appendf(out, "%sDijkstraRadixHeap %s\n",
+      cnf->dijkstra_radix_heap == DEF_DIJKSTRA_RADIX_HEAP ? "# " : "",
+      cnf->dijkstra_radix_heap ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# Repair the shortest path tree of the last Dijkstra run if only link\n"
+    "# costs changed in the topology, instead of recalculating all paths.\n"
+    "# (default is %s)\n"
+    "\n", DEF_DIJKSTRA_INCREMENTAL ? "yes" : "no");
+  abuf_appendf(out, "%sDijkstraIncremental %s\n",
+      cnf->dijkstra_incremental == DEF_DIJKSTRA_INCREMENTAL ? "# " : "",
+      cnf->dijkstra_incremental ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# Run Dijkstra over a packed copy of the topology, which is rebuilt\n"
+    "# only if nodes or links are added or removed. Uses more memory,\n"
+    "# but is faster on large meshes.\n"
+    "# (default is %s)\n"
+    "\n", DEF_DIJKSTRA_SNAPSHOT ? "yes" : "no");
+  abuf_appendf(out, "%sDijkstraSnapshot %s\n",
+      cnf->dijkstra_snapshot == DEF_DIJKSTRA_SNAPSHOT ? "# " : "",
+      cnf->dijkstra_snapshot ? "yes" : "no");
+  abuf_appendf(out,
+    "\n"
+    "# Run Dijkstra on a worker thread, so that packets are still received\n"
+    "# while it runs on large meshes. Only the changed routes are applied\n"
+    "# by the main loop. (Linux only)\n"
+    "# (default is %s)\n"
+    "\n", DEF_DIJKSTRA_THREAD ? "yes" : "no");
+  abuf_appendf(out, "%sDijkstraThread %s\n",
+      cnf->dijkstra_thread == DEF_DIJKSTRA_THREAD ? "# " : "",
+      cnf->dijkstra_thread ? "yes" : "no");
   abuf_appendf(out,
     "\n"
     "################################\n"
@@ -496,6 +496,12 @@ olsrd_sanity_check_cnf(struct olsrd_config *cnf)
     return -1;
   }
 
+  /* Input batch limit */
+  if (cnf->input_batch_limit < MIN_INPUT_BATCH_LIMIT || cnf->input_batch_limit > MAX_INPUT_BATCH_LIMIT) {
+    fprintf(stderr, "Input batch limit %d is not allowed\n", cnf->input_batch_limit);
+    return -1;
+  }
+
   /* TC redundancy */
   if (cnf->tc_redundancy != 2) {
     fprintf(stderr, "Sorry, tc-redundancy 0/1 are not working on 0.5.6. "
@@ -514,6 +520,12 @@ olsrd_sanity_check_cnf(struct olsrd_config *cnf)
     return -1;
   }
 
+  /* Dijkstra heap arity */
+  if (cnf->dijkstra_heap_arity < MIN_DIJKSTRA_HEAP_ARITY || cnf->dijkstra_heap_arity > MAX_DIJKSTRA_HEAP_ARITY) {
+    fprintf(stderr, "Dijkstra heap arity %d is not allowed\n", cnf->dijkstra_heap_arity);
+    return -1;
+  }
+
   /* Link Q and hysteresis cannot be activated at the same time */
   if (cnf->use_hysteresis == true && cnf->lq_level) {
     fprintf(stderr, "Hysteresis and LinkQuality cannot both be active! Deactivate one of them.\n");
@@ -958,10 +970,17 @@ set_default_cnf(struct olsrd_config *cnf, char * configuration_file)
 
   cnf->pollrate = DEF_POLLRATE;
   cnf->nic_chgs_pollrate = DEF_NICCHGPOLLRT;
+  cnf->input_batch_limit = DEF_INPUT_BATCH_LIMIT;
 
   cnf->tc_redundancy = TC_REDUNDANCY;
   cnf->mpr_coverage = MPR_COVERAGE;
   cnf->dijkstra_binary_heap = DEF_DIJKSTRA_BINARY_HEAP;
+  cnf->dijkstra_array_heap = DEF_DIJKSTRA_ARRAY_HEAP;
+  cnf->dijkstra_heap_arity = DEF_DIJKSTRA_HEAP_ARITY;
+  cnf->dijkstra_radix_heap = DEF_DIJKSTRA_RADIX_HEAP;
+  cnf->dijkstra_incremental = DEF_DIJKSTRA_INCREMENTAL;
+  cnf->dijkstra_snapshot = DEF_DIJKSTRA_SNAPSHOT;
+  cnf->dijkstra_thread = DEF_DIJKSTRA_THREAD;
   cnf->lq_level = DEF_LQ_LEVEL;
   cnf->lq_fish = DEF_LQ_FISH;
   cnf->lq_aging = DEF_LQ_AGING;
@@ -1006,6 +1025,8 @@ set_default_cnf(struct olsrd_config *cnf, char * configuration_file)
   smartgw_set_downlink(cnf, DEF_DOWNLINK_SPEED);
 
   cnf->use_src_ip_routes = DEF_USE_SRCIP_ROUTES;
+  cnf->nl_batch = DEF_NETLINK_BATCH;
+  cnf->memory_slabs = DEF_MEMORY_SLABS;
   cnf->set_ip_forward = true;
 
 #ifdef __linux__
@@ -1100,12 +1121,26 @@ olsrd_print_cnf(struct olsrd_config *cnf)
 
   printf("NIC ChangPollrate: %0.2f\n", (double)cnf->nic_chgs_pollrate);
 
+  printf("Input batch limit: %d\n", cnf->input_batch_limit);
+
   printf("TC redundancy    : %d\n", cnf->tc_redundancy);
 
   printf("MPR coverage     : %d\n", cnf->mpr_coverage);
 
   printf("Dijkstra Bin Heap: %s\n", cnf->dijkstra_binary_heap ? "yes" : "no");
 
+  printf("Dijkstra Arr Heap: %s\n", cnf->dijkstra_array_heap ? "yes" : "no");
+
+  printf("Dijkstra Arity   : %d\n", cnf->dijkstra_heap_arity);
+
+  printf("Dijkstra Rdx Heap: %s\n", cnf->dijkstra_radix_heap ? "yes" : "no");
+
+  printf("Dijkstra Incr.   : %s\n", cnf->dijkstra_incremental ? "yes" : "no");
+
+  printf("Dijkstra Snapsh. : %s\n", cnf->dijkstra_snapshot ? "yes" : "no");
+
+  printf("Dijkstra Thread  : %s\n", cnf->dijkstra_thread ? "yes" : "no");
+
   printf("LQ level         : %d\n", cnf->lq_level);
 
   printf("LQ fish eye      : %d\n", cnf->lq_fish);
@@ -1120,6 +1155,10 @@ olsrd_print_cnf(struct olsrd_config *cnf)
 
   printf("Use niit         : %s\n", cnf->use_niit ? "yes" : "no");
 
+  printf("Netlink batching : %s\n", cnf->nl_batch ? "yes" : "no");
+
+  printf("Memory slabs     : %s\n", cnf->memory_slabs ? "yes" : "no");
+
   printf("Smart Gateway    : %s\n", cnf->smart_gw_active ? "yes" : "no");
 
   printf("SmGw. Del Srv Tun: %s\n", cnf->smart_gw_always_remove_server_tunnel ? "yes" : "no");
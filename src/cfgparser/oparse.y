@@ -205,9 +205,16 @@ static int add_ipv6_addr(YYSTYPE ipaddr_arg, YYSTYPE prefixlen_arg)
 %token TOK_HYSTLOWER
 %token TOK_POLLRATE
 %token TOK_NICCHGSPOLLRT
+%token TOK_INPUT_BATCH_LIMIT
 %token TOK_TCREDUNDANCY
 %token TOK_MPRCOVERAGE
 %token TOK_DIJKSTRA_BINARY_HEAP
+%token TOK_DIJKSTRA_ARRAY_HEAP
+%token TOK_DIJKSTRA_HEAP_ARITY
+%token TOK_DIJKSTRA_RADIX_HEAP
+%token TOK_DIJKSTRA_INCREMENTAL
+%token TOK_DIJKSTRA_SNAPSHOT
+%token TOK_DIJKSTRA_THREAD
 %token TOK_LQ_LEVEL
 %token TOK_LQ_FISH
 %token TOK_LQ_AGING
@@ -243,6 +250,8 @@ static int add_ipv6_addr(YYSTYPE ipaddr_arg, YYSTYPE prefixlen_arg)
 %token TOK_SMART_GW_SPEED
 %token TOK_SMART_GW_PREFIX
 %token TOK_SRC_IP_ROUTES
+%token TOK_NETLINK_BATCH
+%token TOK_MEMORY_SLABS
 %token TOK_MAIN_IP
 %token TOK_SET_IPFORWARD
 
@@ -305,9 +314,16 @@ stmt:       idebug
           | fhystlower
           | fpollrate
           | fnicchgspollrt
+          | ainput_batch_limit
           | atcredundancy
           | amprcoverage
           | bdijkstra_binary_heap
+          | bdijkstra_array_heap
+          | adijkstra_heap_arity
+          | bdijkstra_radix_heap
+          | bdijkstra_incremental
+          | bdijkstra_snapshot
+          | bdijkstra_thread
           | alq_level
           | alq_plugin
           | alq_fish
@@ -341,6 +357,8 @@ stmt:       idebug
           | ismart_gw_speed
           | ismart_gw_prefix
           | bsrc_ip_routes
+          | bnl_batch
+          | bmemory_slabs
           | amain_ip
           | bset_ipforward
           | ssgw_egress_ifs
@@ -1244,6 +1262,18 @@ fnicchgspollrt: TOK_NICCHGSPOLLRT TOK_FLOAT
 }
 ;
 
+ainput_batch_limit: TOK_INPUT_BATCH_LIMIT TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Input batch limit %d\n", $2->integer);
+  if ($2->integer < MIN_INPUT_BATCH_LIMIT || $2->integer > MAX_INPUT_BATCH_LIMIT) {
+    fprintf(stderr, "Input batch limit %d is not allowed\n", $2->integer);
+    YYABORT;
+  }
+  olsr_cnf->input_batch_limit = $2->integer;
+  free($2);
+}
+;
+
 atcredundancy: TOK_TCREDUNDANCY TOK_INTEGER
 {
   PARSER_DEBUG_PRINTF("TC redundancy %d\n", $2->integer);
@@ -1268,6 +1298,58 @@ bdijkstra_binary_heap: TOK_DIJKSTRA_BINARY_HEAP TOK_BOOLEAN
 }
 ;
 
+bdijkstra_array_heap: TOK_DIJKSTRA_ARRAY_HEAP TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Array Heap %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->dijkstra_array_heap = $2->boolean;
+  free($2);
+}
+;
+
+adijkstra_heap_arity: TOK_DIJKSTRA_HEAP_ARITY TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Heap Arity %d\n", $2->integer);
+  if ($2->integer < MIN_DIJKSTRA_HEAP_ARITY || $2->integer > MAX_DIJKSTRA_HEAP_ARITY) {
+    fprintf(stderr, "Dijkstra heap arity %d is not allowed\n", $2->integer);
+    YYABORT;
+  }
+  olsr_cnf->dijkstra_heap_arity = $2->integer;
+  free($2);
+}
+;
+
+bdijkstra_radix_heap: TOK_DIJKSTRA_RADIX_HEAP TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Radix Heap %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->dijkstra_radix_heap = $2->boolean;
+  free($2);
+}
+;
+
+bdijkstra_incremental: TOK_DIJKSTRA_INCREMENTAL TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Incremental %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->dijkstra_incremental = $2->boolean;
+  free($2);
+}
+;
+
+bdijkstra_snapshot: TOK_DIJKSTRA_SNAPSHOT TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Snapshot %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->dijkstra_snapshot = $2->boolean;
+  free($2);
+}
+;
+
+bdijkstra_thread: TOK_DIJKSTRA_THREAD TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Dijkstra Thread %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->dijkstra_thread = $2->boolean;
+  free($2);
+}
+;
+
 alq_level: TOK_LQ_LEVEL TOK_INTEGER
 {
   PARSER_DEBUG_PRINTF("Link quality level %d\n", $2->integer);
@@ -1643,6 +1725,22 @@ bsrc_ip_routes: TOK_SRC_IP_ROUTES TOK_BOOLEAN
 }
 ;
 
+bnl_batch: TOK_NETLINK_BATCH TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Netlink batching %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->nl_batch = $2->boolean;
+  free($2);
+}
+;
+
+bmemory_slabs: TOK_MEMORY_SLABS TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Memory Slabs %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->memory_slabs = $2->boolean;
+  free($2);
+}
+;
+
 amain_ip: TOK_MAIN_IP TOK_IPV4_ADDR
 {
   PARSER_DEBUG_PRINTF("Fixed Main IP: %s\n", $2->string);
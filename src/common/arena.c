@@ -0,0 +1,147 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#include <stdlib.h>
+
+#include "common/arena.h"
+
+/**
+ * Alignment of all allocations, the same as guaranteed by malloc()
+ * for the structures handed out by an arena.
+ */
+#define ARENA_ALIGN (2 * sizeof(void *))
+
+/**
+ * Size of the chunk header, rounded up to keep allocations aligned.
+ */
+#define ARENA_HEADER_SIZE ((sizeof(struct arena_chunk) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+/**
+ * allocates a new chunk for an arena
+ * @param size minimum number of usable bytes
+ * @return pointer to the chunk, NULL if out of memory
+ */
+static struct arena_chunk *
+arena_new_chunk(size_t size)
+{
+  struct arena_chunk *chunk;
+
+  if (size < ARENA_CHUNK_SIZE) {
+    size = ARENA_CHUNK_SIZE;
+  }
+
+  chunk = malloc(ARENA_HEADER_SIZE + size);
+  if (chunk) {
+    chunk->next = NULL;
+    chunk->size = size;
+  }
+  return chunk;
+}
+
+/**
+ * allocates a block of memory from an arena
+ * @param arena pointer to arena control structure
+ * @param size number of bytes
+ * @return pointer to the block, NULL if out of memory
+ */
+void *
+arena_alloc(struct arena *arena, size_t size)
+{
+  struct arena_chunk *chunk;
+
+  size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+  if (arena->current == NULL) {
+    arena->first = arena_new_chunk(size);
+    if (arena->first == NULL) {
+      return NULL;
+    }
+    arena->current = arena->first;
+    arena->used = 0;
+  }
+
+  /* move on to the next chunk that is large enough, append one if necessary */
+  chunk = arena->current;
+  while (arena->used + size > chunk->size) {
+    if (chunk->next == NULL) {
+      chunk->next = arena_new_chunk(size);
+      if (chunk->next == NULL) {
+        return NULL;
+      }
+    }
+    chunk = chunk->next;
+    arena->current = chunk;
+    arena->used = 0;
+  }
+
+  arena->used += size;
+  return (char *)chunk + ARENA_HEADER_SIZE + arena->used - size;
+}
+
+/**
+ * releases all allocations of an arena, the chunks are kept
+ * for reuse
+ * @param arena pointer to arena control structure
+ */
+void
+arena_reset(struct arena *arena)
+{
+  arena->current = arena->first;
+  arena->used = 0;
+}
+
+/**
+ * releases all allocations and chunks of an arena
+ * @param arena pointer to arena control structure
+ */
+void
+arena_free(struct arena *arena)
+{
+  struct arena_chunk *chunk;
+
+  while (arena->first) {
+    chunk = arena->first;
+    arena->first = chunk->next;
+    free(chunk);
+  }
+  arena->current = NULL;
+  arena->used = 0;
+}
@@ -0,0 +1,153 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#include <stdlib.h>
+
+#include "common/hash_table.h"
+
+static void hash_table_grow(struct hash_table *table);
+
+/**
+ * Initialize a new hash table
+ * @param table pointer to hash table control structure
+ * @param size initial number of buckets, rounded up to a power of two,
+ *   HASH_TABLE_DEFAULT_SIZE is used if 0
+ * @return 0 if the table was initialized, -1 if out of memory
+ */
+int
+hash_table_init(struct hash_table *table, unsigned int size)
+{
+  unsigned int i;
+
+  table->count = 0;
+  table->size = 1;
+  while (table->size < (size ? size : HASH_TABLE_DEFAULT_SIZE)) {
+    table->size <<= 1;
+  }
+
+  table->buckets = calloc(table->size, sizeof(struct list_node));
+  if (!table->buckets) {
+    table->size = 0;
+    return -1;
+  }
+  for (i = 0; i < table->size; i++) {
+    list_head_init(&table->buckets[i]);
+  }
+  return 0;
+}
+
+/**
+ * Release the bucket array of a hash table. The elements itself
+ * are owned by the caller and will not be touched.
+ * @param table pointer to hash table control structure
+ */
+void
+hash_table_free(struct hash_table *table)
+{
+  free(table->buckets);
+  table->buckets = NULL;
+  table->size = 0;
+  table->count = 0;
+}
+
+/**
+ * Double the number of buckets and rehash all elements. If there is
+ * not enough memory the table keeps its size and just gets slower.
+ * @param table pointer to hash table control structure
+ */
+static void
+hash_table_grow(struct hash_table *table)
+{
+  struct list_node *buckets;
+  unsigned int size = table->size * 2;
+  unsigned int i;
+
+  buckets = calloc(size, sizeof(struct list_node));
+  if (!buckets) {
+    return;
+  }
+  for (i = 0; i < size; i++) {
+    list_head_init(&buckets[i]);
+  }
+
+  for (i = 0; i < table->size; i++) {
+    while (!list_is_empty(&table->buckets[i])) {
+      struct hash_node *node = list2hash_node(table->buckets[i].next);
+
+      list_remove(&node->list);
+      list_add_before(&buckets[node->hash & (size - 1)], &node->list);
+    }
+  }
+
+  free(table->buckets);
+  table->buckets = buckets;
+  table->size = size;
+}
+
+/**
+ * Add an element to the hash table, the table grows if necessary
+ * @param table pointer to hash table control structure
+ * @param node pointer to node of the element
+ * @param hash full hash of the key of the element
+ */
+void
+hash_table_add(struct hash_table *table, struct hash_node *node, uint32_t hash)
+{
+  if (table->count >= table->size) {
+    hash_table_grow(table);
+  }
+
+  node->hash = hash;
+  list_add_after(hash_table_bucket(table, hash), &node->list);
+  table->count++;
+}
+
+/**
+ * Remove an element from the hash table
+ * @param table pointer to hash table control structure
+ * @param node pointer to node of the element
+ */
+void
+hash_table_remove(struct hash_table *table, struct hash_node *node)
+{
+  list_remove(&node->list);
+  table->count--;
+}
@@ -0,0 +1,147 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifndef _HASH_TABLE_H
+#define _HASH_TABLE_H
+
+#include <stdint.h>
+
+#include "common/list.h"
+
+/**
+ * Number of buckets of a new hash table if nothing else is requested.
+ */
+#define HASH_TABLE_DEFAULT_SIZE 128
+
+/**
+ * Element included into a hash table.
+ */
+struct hash_node{
+  /**
+   * Node of the bucket list.
+   */
+  struct list_node list;
+
+  /**
+   * Full hash of the key of the element. The table only uses the
+   * lower bits, the full value is kept to rehash the element without
+   * knowing the key and to skip key compares during lookups.
+   */
+  uint32_t hash;
+};
+
+LISTNODE2STRUCT(list2hash_node, struct hash_node, list);
+
+/**
+ * Manager struct of a chained hash table.
+ * The number of buckets doubles as soon as the table holds more elements
+ * than buckets, so the chains stay short independent of the number of
+ * elements. The table never shrinks, which makes it safe to remove the
+ * current element while walking through the table.
+ */
+struct hash_table{
+  /**
+   * Array of bucket list heads.
+   */
+  struct list_node *buckets;
+
+  /**
+   * Number of buckets, always a power of two.
+   */
+  unsigned int size;
+
+  /**
+   * Number of elements in the table.
+   */
+  unsigned int count;
+};
+
+int hash_table_init(struct hash_table *table, unsigned int size);
+void hash_table_free(struct hash_table *table);
+void hash_table_add(struct hash_table *table, struct hash_node *node, uint32_t hash);
+void hash_table_remove(struct hash_table *table, struct hash_node *node);
+
+/**
+ * @param table pointer to hash table
+ * @param hash full hash of the key
+ * @return head of the bucket list for the hash
+ */
+static inline struct list_node *
+hash_table_bucket(const struct hash_table *table, uint32_t hash)
+{
+  return &table->buckets[hash & (table->size - 1)];
+}
+
+/**
+ * Walk through all elements of a hash table. The current element may be
+ * removed from the table inside the loop, but no element may be added.
+ */
+#define HASH_TABLE_FOR_EACH(table, node) \
+{ \
+  unsigned int _hash_idx; \
+  struct list_node *_hash_next; \
+  for (_hash_idx = 0; _hash_idx < (table)->size; _hash_idx++) { \
+    for (node = (table)->buckets[_hash_idx].next; \
+         node != &(table)->buckets[_hash_idx]; \
+         node = _hash_next) { \
+      _hash_next = node->next;
+#define HASH_TABLE_FOR_EACH_END(node) }}}
+
+/**
+ * Walk through all elements of a hash table with the same hash.
+ */
+#define HASH_TABLE_FOR_EACH_HASH(table, node, hash_val) \
+{ \
+  struct list_node *_hash_head = hash_table_bucket((table), (hash_val)); \
+  for (node = _hash_head->next; node != _hash_head; node = node->next) { \
+    if (list2hash_node(node)->hash != (hash_val)) { \
+      continue; \
+    }
+#define HASH_TABLE_FOR_EACH_HASH_END(node) }}
+
+#endif /* _HASH_TABLE_H */
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
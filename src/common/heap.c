@@ -421,3 +421,206 @@ heap_extract_min(struct bin_heap *heap)
   heap_init_node(min_node);
   return min_node;
 }
+
+/**
+ * Initialize a new array heap struct
+ * @param heap pointer to array heap control structure
+ * @param arity number of children per node, ARRAY_HEAP_DEFAULT_ARITY
+ *   is used if smaller than 2
+ * @param size number of slots preallocated for nodes, 0 to allocate
+ *   on the first insert
+ * @return 0 if the heap was initialized, -1 if out of memory
+ */
+int
+array_heap_init(struct array_heap *heap, unsigned int arity, unsigned int size)
+{
+  heap->count = 0;
+  heap->arity = arity < 2 ? ARRAY_HEAP_DEFAULT_ARITY : arity;
+  heap->size = 0;
+  heap->nodes = NULL;
+
+  if (size) {
+    heap->nodes = calloc(size, sizeof(struct array_heap_node *));
+    if (!heap->nodes) {
+      return -1;
+    }
+    heap->size = size;
+  }
+  return 0;
+}
+
+/**
+ * Release the node array of an array heap. The nodes itself
+ * are owned by the caller and will not be touched.
+ * @param heap pointer to array heap control structure
+ */
+void
+array_heap_free(struct array_heap *heap)
+{
+  free(heap->nodes);
+  heap->nodes = NULL;
+  heap->count = heap->size = 0;
+}
+
+/**
+ * Remove all nodes from an array heap, the node array is kept
+ * for the next inserts.
+ * @param heap pointer to array heap control structure
+ */
+void
+array_heap_clear(struct array_heap *heap)
+{
+  unsigned int i;
+
+  for (i = 0; i < heap->count; i++) {
+    array_heap_init_node(heap->nodes[i]);
+  }
+  heap->count = 0;
+}
+
+/**
+ * Initialize an array heap node
+ * @param node pointer to the heap node
+ */
+void
+array_heap_init_node(struct array_heap_node *node)
+{
+  node->index = ARRAY_HEAP_NOT_ADDED;
+}
+
+/**
+ * moves the node at position index up until its parent is better
+ * @param heap pointer to array heap control structure
+ * @param index position of the node in the array
+ */
+static void
+array_heap_sift_up(struct array_heap *heap, unsigned int index)
+{
+  struct array_heap_node *node = heap->nodes[index];
+  struct array_heap_node *parent;
+
+  while (index > 0) {
+    parent = heap->nodes[(index - 1) / heap->arity];
+    if (parent->key <= node->key) {
+      break;
+    }
+    /* move the parent down into the hole */
+    heap->nodes[index] = parent;
+    parent->index = index;
+    index = (index - 1) / heap->arity;
+  }
+  heap->nodes[index] = node;
+  node->index = index;
+}
+
+/**
+ * moves the node at position index down until its children are worse
+ * @param heap pointer to array heap control structure
+ * @param index position of the node in the array
+ */
+static void
+array_heap_sift_down(struct array_heap *heap, unsigned int index)
+{
+  struct array_heap_node *node = heap->nodes[index];
+  struct array_heap_node *child;
+  unsigned int child_index, first, last, i;
+
+  while ((first = heap->arity * index + 1) < heap->count) {
+    last = first + heap->arity;
+    if (last > heap->count) {
+      last = heap->count;
+    }
+
+    /* pick the best child */
+    child_index = first;
+    child = heap->nodes[first];
+    for (i = first + 1; i < last; i++) {
+      if (heap->nodes[i]->key < child->key) {
+        child_index = i;
+        child = heap->nodes[i];
+      }
+    }
+    if (node->key <= child->key) {
+      break;
+    }
+    /* move the child up into the hole */
+    heap->nodes[index] = child;
+    child->index = index;
+    index = child_index;
+  }
+  heap->nodes[index] = node;
+  node->index = index;
+}
+
+/**
+ * updates the heap after node's key value be changed to a better value
+ * @param heap pointer to array heap control structure
+ * @param node pointer to the node changed
+ */
+void
+array_heap_decrease_key(struct array_heap *heap, struct array_heap_node *node)
+{
+  array_heap_sift_up(heap, node->index);
+}
+
+/**
+ * updates the heap after node's key value be changed to a worse value
+ * @param heap pointer to array heap control structure
+ * @param node pointer to the node changed
+ */
+void
+array_heap_increase_key(struct array_heap *heap, struct array_heap_node *node)
+{
+  array_heap_sift_down(heap, node->index);
+}
+
+/**
+ * inserts the node in the array heap, the array grows if necessary
+ * @param heap pointer to array heap control structure
+ * @param node pointer to node that will be inserted
+ * @return 0 if the node was inserted, -1 if out of memory
+ */
+int
+array_heap_insert(struct array_heap *heap, struct array_heap_node *node)
+{
+  if (heap->count == heap->size) {
+    struct array_heap_node **nodes;
+    unsigned int size = heap->size ? heap->size * 2 : 64;
+
+    nodes = realloc(heap->nodes, size * sizeof(struct array_heap_node *));
+    if (!nodes) {
+      return -1;
+    }
+    heap->nodes = nodes;
+    heap->size = size;
+  }
+
+  heap->nodes[heap->count] = node;
+  array_heap_sift_up(heap, heap->count++);
+  return 0;
+}
+
+/**
+ * deletes and returns the best node from array heap
+ * @param heap pointer to array heap control structure
+ * @return the pointer to best node, NULL if the heap is empty
+ */
+struct array_heap_node *
+array_heap_extract_min(struct array_heap *heap)
+{
+  struct array_heap_node *min_node;
+
+  if (!heap->count) {
+    return NULL;
+  }
+
+  min_node = heap->nodes[0];
+  heap->count--;
+  if (heap->count) {
+    /* the last node goes to the root position */
+    heap->nodes[0] = heap->nodes[heap->count];
+    array_heap_sift_down(heap, 0);
+  }
+  array_heap_init_node(min_node);
+  return min_node;
+}
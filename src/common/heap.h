@@ -148,6 +148,103 @@ heap_is_node_added(struct bin_heap *heap, struct heap_node *node)
   return false;
 }
 
+/**
+ * Marker for an array heap node which is not stored in any heap.
+ */
+#define ARRAY_HEAP_NOT_ADDED ((unsigned int)-1)
+
+/**
+ * Number of children per node of an array heap if the caller
+ * does not request a specific arity (2 is a binary heap).
+ */
+#ifndef ARRAY_HEAP_DEFAULT_ARITY
+#define ARRAY_HEAP_DEFAULT_ARITY 2
+#endif /* ARRAY_HEAP_DEFAULT_ARITY */
+
+/**
+ * Element included into an array backed d-ary heap.
+ */
+struct array_heap_node{
+  /**
+   * node's key based on the link cost type.
+   */
+  olsr_linkcost key;
+
+  /**
+   * Position of the node in the heap array,
+   * ARRAY_HEAP_NOT_ADDED if the node is not in the heap.
+   */
+  unsigned int index;
+};
+
+/**
+ * Manager struct of the array backed d-ary heap.
+ * The nodes are kept in a contiguous array in heap order,
+ * the children of the node at position i are at d*i+1 up to d*i+d.
+ * A wider heap is flatter, so decrease-key has less levels to climb
+ * while extract-min compares more children per level.
+ */
+struct array_heap{
+  /**
+   * Number of nodes in the heap.
+   */
+  unsigned int count;
+
+  /**
+   * Number of children per node (d), 2 for a binary heap.
+   */
+  unsigned int arity;
+
+  /**
+   * Number of allocated slots in the node array.
+   */
+  unsigned int size;
+
+  /**
+   * Array of pointers to the nodes, NULL if nothing is allocated.
+   */
+  struct array_heap_node **nodes;
+};
+
+int array_heap_init(struct array_heap *heap, unsigned int arity, unsigned int size);
+void array_heap_free(struct array_heap *heap);
+void array_heap_clear(struct array_heap *heap);
+void array_heap_init_node(struct array_heap_node *node);
+void array_heap_decrease_key(struct array_heap *heap, struct array_heap_node *node);
+void array_heap_increase_key(struct array_heap *heap, struct array_heap_node *node);
+int array_heap_insert(struct array_heap *heap, struct array_heap_node *node);
+struct array_heap_node *array_heap_extract_min(struct array_heap *heap);
+
+/**
+ * @param heap pointer to array heap
+ * @return size of heap, 0 if is empty
+ */
+static INLINE unsigned int
+array_heap_get_size(struct array_heap *heap)
+{
+  return heap->count;
+}
+
+/**
+ * @param heap pointer to array heap
+ * @return true if the heap is empty, false otherwise
+ */
+static INLINE bool
+array_heap_is_empty(struct array_heap *heap)
+{
+  return heap->count == 0;
+}
+
+/**
+ * @param node pointer to node of the heap
+ * @return true if node is currently in a heap, false otherwise
+ */
+static INLINE bool
+array_heap_is_node_added(struct array_heap_node *node)
+{
+  return node && node->index != ARRAY_HEAP_NOT_ADDED;
+}
+
 #define HEAPNODE2STRUCT(funcname, structname, heapnodename) \
 static inline structname * funcname (struct heap_node *ptr)\
 {\
@@ -157,4 +254,13 @@ static inline structname * funcname (struct heap_node *ptr)\
       NULL); \
 }
 
+#define ARRAYHEAPNODE2STRUCT(funcname, structname, heapnodename) \
+static inline structname * funcname (struct array_heap_node *ptr)\
+{\
+  return( \
+    ptr ? \
+      (structname *) (((size_t) ptr) - offsetof(structname, heapnodename)) : \
+      NULL); \
+}
+
 #endif /* _HEAP_H */
@@ -0,0 +1,175 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#include "common/radix_heap.h"
+
+LISTNODE2STRUCT(bucket2radix_heap_node, struct radix_heap_node, bucket_node);
+
+/**
+ * calculates the bucket of a key relative to the last extracted key
+ * @param heap pointer to radix heap control structure
+ * @param key key of the node
+ * @return 0 if the key equals the last extracted key, otherwise
+ *   the position of the highest bit that differs plus one
+ */
+static unsigned int
+radix_heap_bucket(struct radix_heap *heap, olsr_linkcost key)
+{
+  olsr_linkcost diff = key ^ heap->last_key;
+  unsigned int bucket = 0;
+
+  while (diff) {
+    diff >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+/**
+ * Initialize a new radix heap struct
+ * @param heap pointer to radix heap control structure
+ */
+void
+radix_heap_init(struct radix_heap *heap)
+{
+  unsigned int i;
+
+  heap->count = 0;
+  heap->last_key = 0;
+  for (i = 0; i < RADIX_HEAP_BUCKETS; i++) {
+    list_head_init(&heap->buckets[i]);
+  }
+}
+
+/**
+ * Initialize a radix heap node
+ * @param node pointer to the heap node
+ */
+void
+radix_heap_init_node(struct radix_heap_node *node)
+{
+  node->bucket = 0;
+  list_node_init(&node->bucket_node);
+}
+
+/**
+ * puts the node into the bucket matching its key
+ * @param heap pointer to radix heap control structure
+ * @param node pointer to node
+ */
+static void
+radix_heap_add_bucket(struct radix_heap *heap, struct radix_heap_node *node)
+{
+  node->bucket = radix_heap_bucket(heap, node->key);
+  list_add_before(&heap->buckets[node->bucket], &node->bucket_node);
+}
+
+/**
+ * inserts the node in the radix heap, the key must not be smaller
+ * than the key of the last extracted node
+ * @param heap pointer to radix heap control structure
+ * @param node pointer to node that will be inserted
+ */
+void
+radix_heap_insert(struct radix_heap *heap, struct radix_heap_node *node)
+{
+  radix_heap_add_bucket(heap, node);
+  heap->count++;
+}
+
+/**
+ * updates the heap after node's key value be changed to a better value,
+ * the key must not be smaller than the key of the last extracted node
+ * @param heap pointer to radix heap control structure
+ * @param node pointer to the node changed
+ */
+void
+radix_heap_decrease_key(struct radix_heap *heap, struct radix_heap_node *node)
+{
+  list_remove(&node->bucket_node);
+  radix_heap_add_bucket(heap, node);
+}
+
+/**
+ * deletes and returns the best node from radix heap
+ * @param heap pointer to radix heap control structure
+ * @return the pointer to best node, NULL if the heap is empty
+ */
+struct radix_heap_node *
+radix_heap_extract_min(struct radix_heap *heap)
+{
+  struct radix_heap_node *node;
+  struct list_node *list_node, *next_node;
+  struct list_node redistribute;
+  unsigned int i;
+
+  if (!heap->count) {
+    return NULL;
+  }
+
+  if (list_is_empty(&heap->buckets[0])) {
+    /* find the first non empty bucket */
+    for (i = 1; list_is_empty(&heap->buckets[i]); i++);
+
+    /* its minimum becomes the new reference key */
+    list_node = heap->buckets[i].next;
+    heap->last_key = bucket2radix_heap_node(list_node)->key;
+    for (list_node = list_node->next; list_node != &heap->buckets[i]; list_node = list_node->next) {
+      node = bucket2radix_heap_node(list_node);
+      if (node->key < heap->last_key) {
+        heap->last_key = node->key;
+      }
+    }
+
+    /* all nodes of the bucket move to smaller buckets */
+    list_head_init(&redistribute);
+    list_merge(&redistribute, &heap->buckets[i]);
+    for (list_node = redistribute.next; list_node != &redistribute; list_node = next_node) {
+      next_node = list_node->next;
+      radix_heap_add_bucket(heap, bucket2radix_heap_node(list_node));
+    }
+  }
+
+  list_node = heap->buckets[0].next;
+  list_remove(list_node);
+  heap->count--;
+  return bucket2radix_heap_node(list_node);
+}
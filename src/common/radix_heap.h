@@ -0,0 +1,138 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifndef _RADIX_HEAP_H
+#define _RADIX_HEAP_H
+
+#include <stddef.h>
+
+#include "olsr_types.h"
+#include "common/list.h"
+
+/**
+ * Number of buckets of a radix heap, one for the keys equal to the
+ * last extracted key and one for each bit of the link cost type.
+ */
+#define RADIX_HEAP_BUCKETS (sizeof(olsr_linkcost) * 8 + 1)
+
+/**
+ * Element included into a radix heap.
+ */
+struct radix_heap_node{
+  /**
+   * node's key based on the link cost type.
+   */
+  olsr_linkcost key;
+
+  /**
+   * Bucket the node is currently stored in.
+   */
+  unsigned int bucket;
+
+  /**
+   * Node of the bucket list, not on a list if the node is not in the heap.
+   */
+  struct list_node bucket_node;
+};
+
+/**
+ * Manager struct of a monotone radix heap.
+ * The extracted keys must never decrease and no key smaller than the
+ * last extracted one may be inserted, which is always true for the
+ * candidate set of Dijkstra with non negative link costs.
+ * Bucket i > 0 holds the nodes whose key differs from the last
+ * extracted key first in bit i-1, so every node moves at most once
+ * per bit of the key and all operations are amortized O(1) for a
+ * fixed key width.
+ */
+struct radix_heap{
+  /**
+   * Number of nodes in the heap.
+   */
+  unsigned int count;
+
+  /**
+   * Key of the last extracted node.
+   */
+  olsr_linkcost last_key;
+
+  /**
+   * Bucket lists of the heap.
+   */
+  struct list_node buckets[RADIX_HEAP_BUCKETS];
+};
+
+void radix_heap_init(struct radix_heap *heap);
+void radix_heap_init_node(struct radix_heap_node *node);
+void radix_heap_insert(struct radix_heap *heap, struct radix_heap_node *node);
+void radix_heap_decrease_key(struct radix_heap *heap, struct radix_heap_node *node);
+struct radix_heap_node *radix_heap_extract_min(struct radix_heap *heap);
+
+/**
+ * @param heap pointer to radix heap
+ * @return size of heap, 0 if is empty
+ */
+static inline unsigned int
+radix_heap_get_size(struct radix_heap *heap)
+{
+  return heap->count;
+}
+
+/**
+ * @param heap pointer to radix heap
+ * @return true if the heap is empty, false otherwise
+ */
+static inline bool
+radix_heap_is_empty(struct radix_heap *heap)
+{
+  return heap->count == 0;
+}
+
+#define RADIXHEAPNODE2STRUCT(funcname, structname, heapnodename) \
+static inline structname * funcname (struct radix_heap_node *ptr)\
+{\
+  return( \
+    ptr ? \
+      (structname *) (((size_t) ptr) - offsetof(structname, heapnodename)) : \
+      NULL); \
+}
+
+#endif /* _RADIX_HEAP_H */
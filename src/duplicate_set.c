@@ -41,7 +41,6 @@
 
 #include "duplicate_set.h"
 #include "ipcalc.h"
-#include "common/avl.h"
 #include "olsr.h"
 #include "mid_set.h"
 #include "scheduler.h"
@@ -49,22 +48,71 @@
 
 static void olsr_cleanup_duplicate_entry(void *unused);
 
-struct avl_tree duplicate_set;
+struct hash_table duplicate_set;
 struct timer_entry *duplicate_cleanup_timer;
 
+/*
+ * Ring of expiry buckets, indexed by generation modulo DUP_EXPIRY_BUCKETS.
+ * Every cleanup run advances the generation by one and only looks at the
+ * bucket of the new generation.
+ */
+static struct list_node dup_expiry_buckets[DUP_EXPIRY_BUCKETS];
+static uint32_t dup_generation;
+
 void
 olsr_init_duplicate_set(void)
 {
-  avl_init(&duplicate_set, olsr_cnf->ip_version == AF_INET ? &avl_comp_ipv4 : &avl_comp_ipv6);
+  int i;
+
+  if (hash_table_init(&duplicate_set, HASHSIZE)) {
+    olsr_exit(__func__, EXIT_FAILURE);
+  }
+  for (i = 0; i < DUP_EXPIRY_BUCKETS; i++) {
+    list_head_init(&dup_expiry_buckets[i]);
+  }
+  dup_generation = 0;
 
   olsr_set_timer(&duplicate_cleanup_timer, DUPLICATE_CLEANUP_INTERVAL, DUPLICATE_CLEANUP_JITTER, OLSR_TIMER_PERIODIC,
                  &olsr_cleanup_duplicate_entry, NULL, 0);
 }
 
+/**
+ * Queue a duplicate entry into the expiry bucket of a generation.
+ * Does nothing if the entry is already queued there.
+ */
+static void
+olsr_queue_duplicate_entry(struct dup_entry *entry, uint32_t gen)
+{
+  if (entry->expiry_gen == gen && list_node_on_list(&entry->expiry_node)) {
+    return;
+  }
+  if (list_node_on_list(&entry->expiry_node)) {
+    list_remove(&entry->expiry_node);
+  }
+  entry->expiry_gen = gen;
+  list_add_before(&dup_expiry_buckets[gen % DUP_EXPIRY_BUCKETS], &entry->expiry_node);
+}
+
+static struct dup_entry *
+olsr_lookup_duplicate_entry(const union olsr_ip_addr *ip)
+{
+  struct list_node *node;
+  uint32_t hash = olsr_ip_hash(ip);
+
+  HASH_TABLE_FOR_EACH_HASH(&duplicate_set, node, hash) {
+    struct dup_entry *entry = list2dupentry(node);
+    if (ipequal(&entry->ip, ip)) {
+      return entry;
+    }
+  }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
+  return NULL;
+}
+
 void olsr_cleanup_duplicates(union olsr_ip_addr *orig) {
   struct dup_entry *entry;
 
-  entry = (struct dup_entry *)avl_find(&duplicate_set, orig);
+  entry = olsr_lookup_duplicate_entry(orig);
   if (entry != NULL) {
     entry->too_low_counter = DUP_MAX_TOO_LOW - 2;
   }
@@ -76,27 +124,43 @@ olsr_create_duplicate_entry(void *ip, uint16_t seqnr)
   struct dup_entry *entry;
   entry = olsr_malloc(sizeof(struct dup_entry), "New duplicate entry");
   if (entry != NULL) {
+    memset(&entry->ip, 0, sizeof(entry->ip));
     memcpy(&entry->ip, ip, olsr_cnf->ip_version == AF_INET ? sizeof(entry->ip.v4) : sizeof(entry->ip.v6));
     entry->seqnr = seqnr;
     entry->too_low_counter = 0;
-    entry->avl.key = &entry->ip;
     entry->array = 0;
+    list_node_init(&entry->expiry_node);
+    entry->expiry_gen = 0;
   }
   return entry;
 }
 
+/**
+ * Expire the entries of the next generation. Entries refreshed since
+ * they were queued have already moved to a later bucket, so only expired
+ * entries are touched. The cleanup timer is jittered, an entry that is
+ * not timed out yet is carried over to the following generation.
+ */
 static void
 olsr_cleanup_duplicate_entry(void __attribute__ ((unused)) * unused)
 {
-  struct dup_entry *entry;
+  struct list_node *bucket, *node, *next;
+
+  dup_generation++;
+  bucket = &dup_expiry_buckets[dup_generation % DUP_EXPIRY_BUCKETS];
+
+  for (node = bucket->next; node != bucket; node = next) {
+    struct dup_entry *entry = expiry2dupentry(node);
+    next = node->next;
 
-  OLSR_FOR_ALL_DUP_ENTRIES(entry) {
     if (TIMED_OUT(entry->valid_until)) {
-      avl_delete(&duplicate_set, &entry->avl);
+      list_remove(&entry->expiry_node);
+      hash_table_remove(&duplicate_set, &entry->dup_hash);
       free(entry);
+    } else {
+      olsr_queue_duplicate_entry(entry, dup_generation + 1);
     }
   }
-  OLSR_FOR_ALL_DUP_ENTRIES_END(entry);
 }
 
 int olsr_seqno_diff(uint16_t seqno1, uint16_t seqno2) {
@@ -112,14 +176,29 @@ int olsr_seqno_diff(uint16_t seqno1, uint16_t seqno2) {
   return diff;
 }
 
+#ifndef NODEBUG
+/**
+ * Format the main address of an originator. Only used as an argument of
+ * OLSR_PRINTF, so the MID lookup is only done if the message is printed.
+ */
+static const char *
+olsr_dup_main_addr_to_string(struct ipaddr_str *buf, const union olsr_ip_addr *ip)
+{
+  const union olsr_ip_addr *mainIp = mid_lookup_main_addr(ip);
+
+  return olsr_ip_to_string(buf, mainIp != NULL ? mainIp : ip);
+}
+#endif /* NODEBUG */
+
 int
 olsr_message_is_duplicate(union olsr_message *m)
 {
   struct dup_entry *entry;
   int diff;
-  void *mainIp;
   uint32_t valid_until;
+#ifndef NODEBUG
   struct ipaddr_str buf;
+#endif /* NODEBUG */
   uint16_t seqnr;
   void *ip;
 
@@ -131,20 +210,15 @@ olsr_message_is_duplicate(union olsr_message *m)
     ip = &m->v6.originator;
   }
 
-  // get main address
-  mainIp = mid_lookup_main_addr(ip);
-  if (mainIp == NULL) {
-    mainIp = ip;
-  }
-
   valid_until = GET_TIMESTAMP(DUPLICATE_VTIME);
 
-  entry = (struct dup_entry *)avl_find(&duplicate_set, ip);
+  entry = olsr_lookup_duplicate_entry(ip);
   if (entry == NULL) {
     entry = olsr_create_duplicate_entry(ip, seqnr);
     if (entry != NULL) {
-      avl_insert(&duplicate_set, &entry->avl, 0);
+      hash_table_add(&duplicate_set, &entry->dup_hash, olsr_ip_hash(&entry->ip));
       entry->valid_until = valid_until;
+      olsr_queue_duplicate_entry(entry, dup_generation + DUP_EXPIRY_GENERATIONS);
     }
     return false;               // okay, we process this package
   }
@@ -154,6 +228,7 @@ olsr_message_is_duplicate(union olsr_message *m)
   if (valid_until > entry->valid_until) {
     entry->valid_until = valid_until;
   }
+  olsr_queue_duplicate_entry(entry, dup_generation + DUP_EXPIRY_GENERATIONS);
 
   diff = olsr_seqno_diff(seqnr, entry->seqnr);
   if (diff < -31) {
@@ -166,7 +241,7 @@ olsr_message_is_duplicate(union olsr_message *m)
       entry->array = 1;
       return false;             /* start with a new sequence number, so NO duplicate */
     }
-    OLSR_PRINTF(9, "blocked 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+    OLSR_PRINTF(9, "blocked 0x%x from %s\n", seqnr, olsr_dup_main_addr_to_string(&buf, ip));
     return true;                /* duplicate ! */
   }
 
@@ -175,11 +250,11 @@ olsr_message_is_duplicate(union olsr_message *m)
     uint32_t bitmask = 1 << ((uint32_t) (-diff));
 
     if ((entry->array & bitmask) != 0) {
-      OLSR_PRINTF(9, "blocked 0x%x (diff=%d,mask=%08x) from %s\n", seqnr, diff, entry->array, olsr_ip_to_string(&buf, mainIp));
+      OLSR_PRINTF(9, "blocked 0x%x (diff=%d,mask=%08x) from %s\n", seqnr, diff, entry->array, olsr_dup_main_addr_to_string(&buf, ip));
       return true;              /* duplicate ! */
     }
     entry->array |= bitmask;
-    OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+    OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_dup_main_addr_to_string(&buf, ip));
     return false;               /* no duplicate */
   } else if (diff < 32) {
     entry->array <<= (uint32_t) diff;
@@ -188,7 +263,7 @@ olsr_message_is_duplicate(union olsr_message *m)
   }
   entry->array |= 1;
   entry->seqnr = seqnr;
-  OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+  OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_dup_main_addr_to_string(&buf, ip));
   return false;                 /* no duplicate */
 }
 
@@ -205,7 +280,7 @@ olsr_print_duplicate_table(void)
               olsr_wallclock_string(), ipwidth, "Node IP", "DupArray", "VTime");
 
   OLSR_FOR_ALL_DUP_ENTRIES(entry) {
-    OLSR_PRINTF(1, "%-*s %08x %s\n", ipwidth, olsr_ip_to_string(&addrbuf, (union olsr_ip_addr *)(entry->avl.key)),
+    OLSR_PRINTF(1, "%-*s %08x %s\n", ipwidth, olsr_ip_to_string(&addrbuf, &entry->ip),
                 entry->array, olsr_clock_string(entry->valid_until));
   } OLSR_FOR_ALL_DUP_ENTRIES_END(entry);
 }
@@ -45,15 +45,29 @@
 #include "defs.h"
 #include "olsr.h"
 #include "mantissa.h"
-#include "common/avl.h"
+#include "hashing.h"
+#include "common/list.h"
+#include "common/hash_table.h"
 
 #define DUPLICATE_CLEANUP_INTERVAL 15000
 #define DUPLICATE_CLEANUP_JITTER 25
 #define DUPLICATE_VTIME 120000
 #define DUP_MAX_TOO_LOW 16
 
+/*
+ * Entries expire in generations of DUPLICATE_CLEANUP_INTERVAL. A refreshed
+ * entry is queued DUP_EXPIRY_GENERATIONS ahead of the current one, which
+ * covers DUPLICATE_VTIME plus the partially elapsed current interval.
+ * One more bucket than generations keeps the target bucket of a refresh
+ * apart from the bucket that is cleaned next.
+ */
+#define DUP_EXPIRY_GENERATIONS (DUPLICATE_VTIME / DUPLICATE_CLEANUP_INTERVAL + 1)
+#define DUP_EXPIRY_BUCKETS (DUP_EXPIRY_GENERATIONS + 1)
+
 struct dup_entry {
-  struct avl_node avl;
+  struct hash_node dup_hash;           /* hashed by originator address */
+  struct list_node expiry_node;        /* member of an expiry bucket */
+  uint32_t expiry_gen;                 /* generation of the expiry bucket */
   union olsr_ip_addr ip;
   uint16_t seqnr;
   uint16_t too_low_counter;
@@ -61,7 +75,8 @@ struct dup_entry {
   uint32_t valid_until;
 };
 
-AVLNODE2STRUCT(duptree2dupentry, struct dup_entry, avl);
+LISTNODE2STRUCT(list2dupentry, struct dup_entry, dup_hash.list);
+LISTNODE2STRUCT(expiry2dupentry, struct dup_entry, expiry_node);
 
 void olsr_init_duplicate_set(void);
 void olsr_cleanup_duplicates(union olsr_ip_addr *orig);
@@ -76,12 +91,12 @@ void olsr_print_duplicate_table(void);
 
 #define OLSR_FOR_ALL_DUP_ENTRIES(dup) \
 { \
-  struct avl_node *dup_tree_node, *next_dup_tree_node; \
-  for (dup_tree_node = avl_walk_first(&duplicate_set); \
-    dup_tree_node; dup_tree_node = next_dup_tree_node) { \
-    next_dup_tree_node = avl_walk_next(dup_tree_node); \
-    dup = duptree2dupentry(dup_tree_node);
-#define OLSR_FOR_ALL_DUP_ENTRIES_END(dup) }}
+  struct list_node *_dup_node; \
+  HASH_TABLE_FOR_EACH(&duplicate_set, _dup_node) \
+    dup = list2dupentry(_dup_node);
+#define OLSR_FOR_ALL_DUP_ENTRIES_END(dup) HASH_TABLE_FOR_EACH_END(_dup_node) }
+
+extern struct hash_table duplicate_set;
 
 #endif /* DUPLICATE_SET_2_H_ */
 
@@ -74,7 +74,7 @@ generate_hello(void *p)
   if (queue_hello(&hellopacket, ifn))
     net_output(ifn);
 
-  olsr_free_hello_packet(&hellopacket);
+  arena_reset(&olsr_msg_arena);
 
 }
 
@@ -90,7 +90,7 @@ generate_tc(void *p)
     set_buffer_timer(ifn);
   }
 
-  olsr_free_tc_packet(&tcpacket);
+  arena_reset(&olsr_msg_arena);
 }
 
 void
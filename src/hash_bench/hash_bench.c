@@ -0,0 +1,339 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/*
+ * Address hash benchmark.
+ *
+ * Compares the address family specific hash functions selected by
+ * olsr_init_hashing() with the generic Jenkins hash they replaced.
+ * For several synthetic address sets it measures the time per hash and
+ * how evenly the addresses spread over hash tables of different sizes.
+ * Build it with "make hash_bench".
+ */
+
+#include "defs.h"
+#include "olsr.h"
+#include "olsr_cfg.h"
+#include "hashing.h"
+
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* defined by main.c in olsrd */
+struct olsr_cookie_info *def_timer_ci = NULL;
+
+enum hash_bench_keyset {
+  HASH_BENCH_V4_SEQUENTIAL,
+  HASH_BENCH_V4_SUBNETS,
+  HASH_BENCH_V4_RANDOM,
+  HASH_BENCH_V6_SEQUENTIAL,
+  HASH_BENCH_V6_EUI64,
+  HASH_BENCH_V6_RANDOM,
+  HASH_BENCH_KEYSET_COUNT
+};
+
+struct hash_bench_keyset_info {
+  const char *name;
+  int ip_version;
+};
+
+static const struct hash_bench_keyset_info hash_bench_keysets[HASH_BENCH_KEYSET_COUNT] = {
+  { "v4/sequential", AF_INET },
+  { "v4/subnets",    AF_INET },
+  { "v4/random",     AF_INET },
+  { "v6/sequential", AF_INET6 },
+  { "v6/eui64",      AF_INET6 },
+  { "v6/random",     AF_INET6 },
+};
+
+/* number of addresses hashed if none is given on the command line */
+static const unsigned int hash_bench_default_sizes[] = { 1000, 6000, 50000 };
+
+/* table sizes the distribution is checked for, 0 is the next power of two */
+static const unsigned int hash_bench_table_sizes[] = { HASHSIZE, 4096, 0 };
+
+#define HASH_BENCH_TABLE_COUNT (sizeof(hash_bench_table_sizes) / sizeof(hash_bench_table_sizes[0]))
+
+#define HASH_BENCH_MAX_KEYS 0x1000000
+
+/* total number of hashes a measurement aims for */
+#define HASH_BENCH_WORK 20000000
+
+static union olsr_ip_addr *bench_keys;
+static unsigned int *bench_buckets;
+static uint32_t bench_random_state;
+
+/*
+ * Small xorshift generator, so that a seed gives the same
+ * addresses on every platform.
+ */
+static uint32_t
+bench_random(void)
+{
+  bench_random_state ^= bench_random_state << 13;
+  bench_random_state ^= bench_random_state >> 17;
+  bench_random_state ^= bench_random_state << 5;
+  return bench_random_state;
+}
+
+static double
+bench_now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void
+bench_build(enum hash_bench_keyset keyset, unsigned int count)
+{
+  unsigned int i, j;
+
+  memset(bench_keys, 0, count * sizeof(*bench_keys));
+  for (i = 0; i < count; i++) {
+    union olsr_ip_addr *addr = &bench_keys[i];
+
+    switch (keyset) {
+    case HASH_BENCH_V4_SEQUENTIAL:
+      /* 10.0.0.1, 10.0.0.2, ... */
+      addr->v4.s_addr = htonl(0x0a000001 + i);
+      break;
+    case HASH_BENCH_V4_SUBNETS:
+      /* one router per /24: 10.0.0.1, 10.0.1.1, ... */
+      addr->v4.s_addr = htonl(0x0a000001 + (i << 8));
+      break;
+    case HASH_BENCH_V4_RANDOM:
+      addr->v4.s_addr = bench_random();
+      break;
+    case HASH_BENCH_V6_SEQUENTIAL:
+      /* 2001:db8::1, 2001:db8::2, ... */
+      addr->v6.s6_addr[0] = 0x20;
+      addr->v6.s6_addr[1] = 0x01;
+      addr->v6.s6_addr[2] = 0x0d;
+      addr->v6.s6_addr[3] = 0xb8;
+      addr->v6.s6_addr[12] = (i + 1) >> 24;
+      addr->v6.s6_addr[13] = (i + 1) >> 16;
+      addr->v6.s6_addr[14] = (i + 1) >> 8;
+      addr->v6.s6_addr[15] = i + 1;
+      break;
+    case HASH_BENCH_V6_EUI64:
+      /* a few /64 prefixes with interface ids built from random MACs of one vendor */
+      addr->v6.s6_addr[0] = 0x20;
+      addr->v6.s6_addr[1] = 0x01;
+      addr->v6.s6_addr[2] = 0x0d;
+      addr->v6.s6_addr[3] = 0xb8;
+      addr->v6.s6_addr[7] = i % 16;
+      addr->v6.s6_addr[8] = 0x02;
+      addr->v6.s6_addr[9] = 0x1b;
+      addr->v6.s6_addr[10] = 0x63;
+      addr->v6.s6_addr[11] = 0xff;
+      addr->v6.s6_addr[12] = 0xfe;
+      addr->v6.s6_addr[13] = bench_random();
+      addr->v6.s6_addr[14] = bench_random();
+      addr->v6.s6_addr[15] = bench_random();
+      break;
+    default:
+      for (j = 0; j < sizeof(addr->v6.s6_addr); j++) {
+        addr->v6.s6_addr[j] = bench_random();
+      }
+      break;
+    }
+  }
+}
+
+/*
+ * Sum of the squared chain lengths relative to the one expected for
+ * a perfectly random hash, 1.0 is as good as random.
+ */
+static void
+bench_distribution(uint32_t (*hash)(const union olsr_ip_addr *), unsigned int count, unsigned int size,
+                   double *quality, unsigned int *max_chain)
+{
+  unsigned int i;
+  double squares = 0;
+
+  memset(bench_buckets, 0, size * sizeof(*bench_buckets));
+  for (i = 0; i < count; i++) {
+    bench_buckets[hash(&bench_keys[i]) & (size - 1)]++;
+  }
+
+  *max_chain = 0;
+  for (i = 0; i < size; i++) {
+    squares += (double)bench_buckets[i] * bench_buckets[i];
+    if (bench_buckets[i] > *max_chain) {
+      *max_chain = bench_buckets[i];
+    }
+  }
+  *quality = squares / (count + (double)count * (count - 1) / size);
+}
+
+static double
+bench_speed(uint32_t (*hash)(const union olsr_ip_addr *), unsigned int count)
+{
+  unsigned int rounds = HASH_BENCH_WORK / count + 1;
+  unsigned int i, j;
+  volatile uint32_t sink;
+  uint32_t sum = 0;
+  double start;
+
+  start = bench_now();
+  for (j = 0; j < rounds; j++) {
+    for (i = 0; i < count; i++) {
+      sum += hash(&bench_keys[i]);
+    }
+  }
+  sink = sum;
+  (void)sink;
+  return (bench_now() - start) * 1e9 / ((double)rounds * count);
+}
+
+static void
+bench_keyset(enum hash_bench_keyset keyset, unsigned int count)
+{
+  static const char *const names[2] = { "jenkins", "specialized" };
+  uint32_t (*hashes[2])(const union olsr_ip_addr *);
+  unsigned int i, t, size;
+
+  olsr_cnf->ip_version = hash_bench_keysets[keyset].ip_version;
+  olsr_cnf->ipsize = olsr_cnf->ip_version == AF_INET ? sizeof(struct in_addr) : sizeof(struct in6_addr);
+  olsr_init_hashing();
+
+  /* the old hash switched on the address family for every call, so does the reference */
+  hashes[0] = olsr_ip_hash_jenkins;
+  hashes[1] = olsr_ip_hash;
+
+  bench_build(keyset, count);
+  for (i = 0; i < 2; i++) {
+    printf("%-14s %8u %-12s %8.2f", hash_bench_keysets[keyset].name, count, names[i], bench_speed(hashes[i], count));
+    for (t = 0; t < HASH_BENCH_TABLE_COUNT; t++) {
+      double quality;
+      unsigned int max_chain;
+
+      size = hash_bench_table_sizes[t];
+      if (!size) {
+        for (size = 1; size < count; size <<= 1);
+      }
+      bench_distribution(hashes[i], count, size, &quality, &max_chain);
+      printf("  %6u %5.2f %4u", size, quality, max_chain);
+    }
+    printf("\n");
+  }
+}
+
+static void
+bench_usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-n addresses] [-s seed]\n"
+          "  -n  number of addresses, default 1000, 6000 and 50000\n"
+          "  -s  seed of the address generator, default 1\n", name);
+  exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char *argv[])
+{
+  unsigned int keys = 0, max_keys, i;
+  int opt, k;
+
+  bench_random_state = 1;
+  while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+    switch (opt) {
+    case 'n':
+      keys = strtoul(optarg, NULL, 0);
+      if (keys < 1 || keys > HASH_BENCH_MAX_KEYS) {
+        bench_usage(argv[0]);
+      }
+      break;
+    case 's':
+      bench_random_state = strtoul(optarg, NULL, 0);
+      if (!bench_random_state) {
+        bench_random_state = 1;
+      }
+      break;
+    default:
+      bench_usage(argv[0]);
+      break;
+    }
+  }
+
+  olsr_cnf = olsrd_get_default_cnf(strdup(argv[0]));
+  olsr_cnf->debug_level = 0;
+
+  max_keys = keys ? keys : hash_bench_default_sizes[sizeof(hash_bench_default_sizes) / sizeof(hash_bench_default_sizes[0]) - 1];
+  bench_keys = calloc(max_keys, sizeof(*bench_keys));
+  bench_buckets = calloc(2 * max_keys + HASHSIZE + 4096, sizeof(*bench_buckets));
+  if (!bench_keys || !bench_buckets) {
+    fprintf(stderr, "Out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%-14s %8s %-12s %8s", "addresses", "count", "hash", "ns/hash");
+  for (i = 0; i < HASH_BENCH_TABLE_COUNT; i++) {
+    printf("  %6s %5s %4s", "size", "chi", "max");
+  }
+  printf("\n");
+
+  for (k = 0; k < HASH_BENCH_KEYSET_COUNT; k++) {
+    if (keys) {
+      bench_keyset(k, keys);
+      continue;
+    }
+    for (i = 0; i < sizeof(hash_bench_default_sizes) / sizeof(hash_bench_default_sizes[0]); i++) {
+      bench_keyset(k, hash_bench_default_sizes[i]);
+    }
+  }
+
+  free(bench_keys);
+  free(bench_buckets);
+  return EXIT_SUCCESS;
+}
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -43,6 +43,13 @@
 #include "hashing.h"
 #include "defs.h"
 
+#include <string.h>
+
+static uint32_t olsr_ip_hash_default(const union olsr_ip_addr *);
+
+/* hash function of the configured address family, see olsr_init_hashing() */
+uint32_t (*olsr_ip_hash)(const union olsr_ip_addr *) = olsr_ip_hash_default;
+
 /*
  * Taken from lookup2.c by Bob Jenkins.  (http://burtleburtle.net/bob/c/lookup2.c).
  * --------------------------------------------------------------------
@@ -136,12 +143,14 @@ jenkins_hash(const uint8_t * k, uint32_t length)
 }
 
 /**
- * Hashing function. Creates a key based on an IP address.
+ * Hashing function. Creates a key based on an IP address with the
+ * generic Jenkins hash. Only used as reference for the specialized
+ * hash functions.
  * @param address the address to hash
- * @return the hash(a value in the (0 to HASHMASK-1) range)
+ * @return the full 32 bit hash
  */
 uint32_t
-olsr_ip_hashing(const union olsr_ip_addr * address)
+olsr_ip_hash_jenkins(const union olsr_ip_addr * address)
 {
   uint32_t hash;
 
@@ -157,7 +166,113 @@ olsr_ip_hashing(const union olsr_ip_addr * address)
     break;
 
   }
-  return hash & HASHMASK;
+  return hash;
+}
+
+/*
+ * Finalizers of MurmurHash3 by Austin Appleby, public domain.
+ * Every input bit affects every output bit, so the lower bits used
+ * as hash table index are as good as the upper ones.
+ */
+static inline uint32_t
+olsr_hash_fmix32(uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+  return h;
+}
+
+static inline uint64_t
+olsr_hash_fmix64(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Hash an IPv4 address. The address is a single word, so
+ * this is just the finalizer applied to it.
+ * @param address the address to hash
+ * @return the full 32 bit hash
+ */
+uint32_t
+olsr_ip_hash_ipv4(const union olsr_ip_addr * address)
+{
+  return olsr_hash_fmix32(address->v4.s_addr);
+}
+
+/**
+ * Hash an IPv6 address. Both halves are loaded as 64 bit words, the
+ * first one is spread by a multiplication before they are combined.
+ * @param address the address to hash
+ * @return the full 32 bit hash
+ */
+uint32_t
+olsr_ip_hash_ipv6(const union olsr_ip_addr * address)
+{
+  uint64_t prefix, iid, h;
+
+  memcpy(&prefix, &address->v6.s6_addr[0], sizeof(prefix));
+  memcpy(&iid, &address->v6.s6_addr[8], sizeof(iid));
+
+  h = olsr_hash_fmix64(prefix * 0x9e3779b97f4a7c15ULL ^ iid);
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+/**
+ * Hash function used until olsr_init_hashing() picked the one
+ * of the configured address family. Gives the same results.
+ * @param address the address to hash
+ * @return the full 32 bit hash
+ */
+static uint32_t
+olsr_ip_hash_default(const union olsr_ip_addr * address)
+{
+  switch (olsr_cnf->ip_version) {
+  case AF_INET:
+    return olsr_ip_hash_ipv4(address);
+  case AF_INET6:
+    return olsr_ip_hash_ipv6(address);
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Select the hash function of the configured address family.
+ */
+void
+olsr_init_hashing(void)
+{
+  switch (olsr_cnf->ip_version) {
+  case AF_INET:
+    olsr_ip_hash = olsr_ip_hash_ipv4;
+    break;
+  case AF_INET6:
+    olsr_ip_hash = olsr_ip_hash_ipv6;
+    break;
+  default:
+    olsr_ip_hash = olsr_ip_hash_default;
+    break;
+  }
+}
+
+/**
+ * Hashing function. Creates a key based on an IP address.
+ * @param address the address to hash
+ * @return the hash(a value in the (0 to HASHMASK-1) range)
+ */
+uint32_t
+olsr_ip_hashing(const union olsr_ip_addr * address)
+{
+  return olsr_ip_hash(address) & HASHMASK;
 }
 
 /*
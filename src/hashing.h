@@ -47,6 +47,13 @@
 
 #include "olsr_types.h"
 
+/* full 32 bit hash of an address, see struct hash_table */
+extern uint32_t (*olsr_ip_hash)(const union olsr_ip_addr *);
+
+void olsr_init_hashing(void);
+uint32_t olsr_ip_hash_ipv4(const union olsr_ip_addr *);
+uint32_t olsr_ip_hash_ipv6(const union olsr_ip_addr *);
+uint32_t olsr_ip_hash_jenkins(const union olsr_ip_addr *);
 uint32_t olsr_ip_hashing(const union olsr_ip_addr *);
 
 #endif /* _OLSR_HASHING */
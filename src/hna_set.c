@@ -49,7 +49,7 @@
 #include "gateway.h"
 #include "duplicate_handler.h"
 
-struct hna_entry hna_set[HASHSIZE];
+struct hash_table hna_set;
 struct olsr_cookie_info *hna_net_timer_cookie = NULL;
 struct olsr_cookie_info *hna_entry_mem_cookie = NULL;
 struct olsr_cookie_info *hna_net_mem_cookie = NULL;
@@ -62,11 +62,8 @@ static bool olsr_delete_hna_net_entry(struct hna_net *net_to_delete);
 int
 olsr_init_hna_set(void)
 {
-  int idx;
-
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    hna_set[idx].next = &hna_set[idx];
-    hna_set[idx].prev = &hna_set[idx];
+  if (hash_table_init(&hna_set, HASHSIZE)) {
+    olsr_exit(__func__, EXIT_FAILURE);
   }
 
   hna_net_timer_cookie = olsr_alloc_cookie("HNA Network", OLSR_COOKIE_TYPE_TIMER);
@@ -125,16 +122,19 @@ olsr_lookup_hna_net(const struct hna_net *nets, const union olsr_ip_addr *net, u
 struct hna_entry *
 olsr_lookup_hna_gw(const union olsr_ip_addr *gw)
 {
-  struct hna_entry *tmp_hna;
-  uint32_t hash = olsr_ip_hashing(gw);
+  struct list_node *node;
+  uint32_t hash = olsr_ip_hash(gw);
 
   /* Check for registered entry */
 
-  for (tmp_hna = hna_set[hash].next; tmp_hna != &hna_set[hash]; tmp_hna = tmp_hna->next) {
+  HASH_TABLE_FOR_EACH_HASH(&hna_set, node, hash) {
+    struct hna_entry *tmp_hna = list2hna(node);
+
     if (ipequal(&tmp_hna->A_gateway_addr, gw)) {
       return tmp_hna;
     }
   }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
 
   /* Not found */
   return NULL;
@@ -151,7 +151,6 @@ struct hna_entry *
 olsr_add_hna_entry(const union olsr_ip_addr *addr)
 {
   struct hna_entry *new_entry;
-  uint32_t hash;
 
   new_entry = olsr_cookie_malloc(hna_entry_mem_cookie);
 
@@ -163,12 +162,7 @@ olsr_add_hna_entry(const union olsr_ip_addr *addr)
   new_entry->networks.prev = &new_entry->networks;
 
   /* queue */
-  hash = olsr_ip_hashing(addr);
-
-  hna_set[hash].next->prev = new_entry;
-  new_entry->next = hna_set[hash].next;
-  hna_set[hash].next = new_entry;
-  new_entry->prev = &hna_set[hash];
+  hash_table_add(&hna_set, &new_entry->hna_hash, olsr_ip_hash(addr));
 
   return new_entry;
 }
@@ -240,7 +234,7 @@ olsr_delete_hna_net_entry(struct hna_net *net_to_delete) {
 
   /* Delete hna_gw if empty */
   if (hna_gw->networks.next == &hna_gw->networks) {
-    DEQUEUE_ELEM(hna_gw);
+    hash_table_remove(&hna_set, &hna_gw->hna_hash);
     olsr_cookie_free(hna_entry_mem_cookie, hna_gw);
     removed_entry = true;
   }
@@ -313,7 +307,7 @@ void
 olsr_print_hna_set(void)
 {
   /* The whole function doesn't do anything else. */
-  int idx;
+  struct hna_entry *tmp_hna;
   struct tm * nowtm;
   struct timeval now;
   const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
@@ -330,23 +324,20 @@ olsr_print_hna_set(void)
   else
     OLSR_PRINTF(1, "IP net/prefixlen               GW IP\n");
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    struct hna_entry *tmp_hna = hna_set[idx].next;
-    /* Check all entrys */
-    while (tmp_hna != &hna_set[idx]) {
-      /* Check all networks */
-      struct hna_net *tmp_net = tmp_hna->networks.next;
+  /* Check all entrys */
+  OLSR_FOR_ALL_HNA_ENTRIES(tmp_hna) {
+    /* Check all networks */
+    struct hna_net *tmp_net = tmp_hna->networks.next;
 
-      while (tmp_net != &tmp_hna->networks) {
-        struct ipaddr_str buf;
-        OLSR_PRINTF(1, "%-*s ", ipwidthprefix, olsr_ip_prefix_to_string(&tmp_net->hna_prefix));
-        OLSR_PRINTF(1, "%-*s\n", ipwidth, olsr_ip_to_string(&buf, &tmp_hna->A_gateway_addr));
+    while (tmp_net != &tmp_hna->networks) {
+      struct ipaddr_str buf;
+      OLSR_PRINTF(1, "%-*s ", ipwidthprefix, olsr_ip_prefix_to_string(&tmp_net->hna_prefix));
+      OLSR_PRINTF(1, "%-*s\n", ipwidth, olsr_ip_to_string(&buf, &tmp_hna->A_gateway_addr));
 
-        tmp_net = tmp_net->next;
-      }
-      tmp_hna = tmp_hna->next;
+      tmp_net = tmp_net->next;
     }
   }
+  OLSR_FOR_ALL_HNA_ENTRIES_END(tmp_hna);
 }
 #endif /* NODEBUG */
 
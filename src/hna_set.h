@@ -46,6 +46,7 @@
 #include "olsr_types.h"
 #include "olsr_protocol.h"
 #include "mantissa.h"
+#include "common/hash_table.h"
 
 #include <time.h>
 
@@ -64,22 +65,19 @@ struct hna_net {
 struct hna_entry {
   union olsr_ip_addr A_gateway_addr;
   struct hna_net networks;
-  struct hna_entry *next;
-  struct hna_entry *prev;
+  struct hash_node hna_hash;           /* hashed by A_gateway_addr */
 };
 
+LISTNODE2STRUCT(list2hna, struct hna_entry, hna_hash.list);
+
 #define OLSR_FOR_ALL_HNA_ENTRIES(hna) \
 { \
-  int _idx; \
-  for (_idx = 0; _idx < HASHSIZE; _idx++) { \
-    struct hna_entry *_next; \
-    for(hna = hna_set[_idx].next; \
-        hna != &hna_set[_idx]; \
-        hna = _next) { \
-      _next = hna->next;
-#define OLSR_FOR_ALL_HNA_ENTRIES_END(hna) }}}
-
-extern struct hna_entry hna_set[HASHSIZE];
+  struct list_node *_hna_node; \
+  HASH_TABLE_FOR_EACH(&hna_set, _hna_node) \
+    hna = list2hna(_hna_node);
+#define OLSR_FOR_ALL_HNA_ENTRIES_END(hna) HASH_TABLE_FOR_EACH_END(_hna_node) }
+
+extern struct hash_table hna_set;
 
 int olsr_init_hna_set(void);
 void olsr_cleanup_hna(union olsr_ip_addr *orig);
@@ -177,6 +177,9 @@ struct interface_olsr {
   /* index in TTL array for fish-eye */
   int ttl_index;
 
+  /* generation of the LQ TC neighbour cache last sent on this if */
+  uint32_t lq_tc_generation;
+
   /* Hello's are sent immediately normally, this flag prefers to send TC's */
   bool immediate_send_tc;
 
@@ -60,6 +60,9 @@ int olsr_ioctl_del_route6(const struct rt_entry *rt);
     const struct olsr_ip_prefix *dst, bool set, bool del_similar, bool blackhole);
 
   int rtnetlink_register_socket(int);
+
+  bool olsr_os_route_batch_add(struct rt_entry *rt, bool set);
+  void olsr_os_route_batch_flush(void (*done)(struct rt_entry *, bool, int));
 #endif /* __linux__ */
 
 void olsr_os_niit_4to6_route(const struct olsr_ip_prefix *dst_v4, bool set);
@@ -56,7 +56,9 @@
 #include "olsr_spf.h"
 #include "net_olsr.h"
 #include "ipcalc.h"
+#include "lq_packet.h"
 #include "lq_plugin.h"
+#include "lq_mpr.h"
 
 /* head node for all link sets */
 struct list_node link_entry_head;
@@ -67,6 +69,10 @@ void
 signal_link_changes(bool val)
 {                               /* XXX ugly */
   link_changes = val;
+
+  if (val) {
+    olsr_lq_tc_invalidate();
+  }
 }
 
 /* Prototypes. */
@@ -102,6 +108,9 @@ void olsr_reset_all_links(void) {
     link->neighbor->status = NOT_SYM;
   } OLSR_FOR_ALL_LINK_ENTRIES_END(link)
 
+  /* every neighbor lost its symmetric status */
+  olsr_lq_mpr_mark_all_dirty();
+
 
   OLSR_FOR_ALL_LINK_ENTRIES(link) {
     olsr_expire_link_sym_timer(link);
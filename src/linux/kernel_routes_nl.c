@@ -63,13 +63,14 @@
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <net/if.h>
+#include <poll.h>
 
 /*
  * The ARM compile complains about alignment. Copied
  * from /usr/include/linux/netlink.h and adapted for ARM
  */
 #define MY_NLMSG_NEXT(nlh,len)   ((len) -= NLMSG_ALIGN((nlh)->nlmsg_len), \
-          (struct nlmsghdr*)ARM_NOWARN_ALIGN((((char*)(nlh)) + NLMSG_ALIGN((nlh)->nlmsg_len)))
+          (struct nlmsghdr*)ARM_NOWARN_ALIGN((((char*)(nlh)) + NLMSG_ALIGN((nlh)->nlmsg_len))))
 
 
 static void rtnetlink_read(int sock, void *, unsigned int);
@@ -86,6 +87,32 @@ struct olsr_ipadd_req {
   char buf[256];
 };
 
+/* maximum number of route requests sent with a single sendmsg() */
+#define NL_BATCH_CHUNK 128
+
+/* longest wait in milliseconds for the next answer to a batch chunk */
+#define NL_BATCH_ACK_TIMEOUT 1000
+
+/* a route change waiting in the netlink batch */
+struct olsr_rt_batch_entry {
+  struct rt_entry *rt;
+  size_t offset;                       /* position of the request in the batch buffer */
+  bool set;
+  bool answered;
+  int err;
+};
+
+static struct {
+  char *buf;
+  size_t len, size;
+  struct olsr_rt_batch_entry *entry;
+  unsigned int count, entry_size;
+  uint32_t seq;                        /* sequence number of the first entry */
+} rt_batch;
+
+/* sequence number of the last request sent on the rtnetlink socket */
+static uint32_t olsr_netlink_seq;
+
 int rtnetlink_register_socket(int rtnl_mgrp)
 {
   int sock = socket(AF_NETLINK,SOCK_RAW,NETLINK_ROUTE);
@@ -224,6 +251,8 @@ olsr_netlink_send(struct nlmsghdr *nl_hdr)
   msg.msg_iov = &iov;
   msg.msg_iovlen = 1;
 
+  nl_hdr->nlmsg_seq = ++olsr_netlink_seq;
+
   iov.iov_base = nl_hdr;
   iov.iov_len = nl_hdr->nlmsg_len;
   ret = sendmsg(olsr_cnf->rtnl_s, &msg, 0);
@@ -234,17 +263,20 @@ olsr_netlink_send(struct nlmsghdr *nl_hdr)
 
   iov.iov_base = rcvbuf;
   iov.iov_len = sizeof(rcvbuf);
-  ret = recvmsg(olsr_cnf->rtnl_s, &msg, 0);
-  if (ret <= 0) {
-    olsr_syslog(OLSR_LOG_ERR, "Error while reading answer to netlink message (%d: %s)", errno, strerror(errno));
-    return -1;
-  }
+  do {
+    ret = recvmsg(olsr_cnf->rtnl_s, &msg, 0);
+    if (ret <= 0) {
+      olsr_syslog(OLSR_LOG_ERR, "Error while reading answer to netlink message (%d: %s)", errno, strerror(errno));
+      return -1;
+    }
 
-  h = (struct nlmsghdr *)ARM_NOWARN_ALIGN(rcvbuf);
-  if (!NLMSG_OK(h, (unsigned int)ret)) {
-    olsr_syslog(OLSR_LOG_ERR, "Received netlink message was malformed (ret=%d, %u)", ret, h->nlmsg_len);
-    return -1;
-  }
+    h = (struct nlmsghdr *)ARM_NOWARN_ALIGN(rcvbuf);
+    if (!NLMSG_OK(h, (unsigned int)ret)) {
+      olsr_syslog(OLSR_LOG_ERR, "Received netlink message was malformed (ret=%d, %u)", ret, h->nlmsg_len);
+      return -1;
+    }
+    /* skip late answers to an earlier netlink batch */
+  } while (h->nlmsg_seq != nl_hdr->nlmsg_seq);
 
   if (h->nlmsg_type != NLMSG_ERROR) {
     olsr_syslog(OLSR_LOG_INFO,
@@ -338,13 +370,11 @@ int olsr_os_ifip(int ifindex, union olsr_ip_addr *ip, bool create) {
   return olsr_add_ip(ifindex, ip, NULL, create);
 }
 
-int olsr_new_netlink_route(unsigned char family, uint32_t rttable, unsigned int flags, unsigned char scope, int if_index, int metric, int protocol,
-    const union olsr_ip_addr *src, const union olsr_ip_addr *gw, const struct olsr_ip_prefix *dst,
-    bool set, bool del_similar, bool blackhole) {
+static void olsr_netlink_route_req(struct olsr_rtreq *req, unsigned char family, uint32_t rttable, unsigned int flags, unsigned char scope,
+    int if_index, int metric, int protocol, const union olsr_ip_addr *src, const union olsr_ip_addr *gw,
+    const struct olsr_ip_prefix *dst, bool set, bool del_similar, bool blackhole) {
 
-  struct olsr_rtreq req;
   int family_size;
-  int err;
 
   if (0) {
     struct ipaddr_str buf1, buf2;
@@ -356,88 +386,99 @@ int olsr_new_netlink_route(unsigned char family, uint32_t rttable, unsigned int
   }
   family_size = family == AF_INET ? sizeof(struct in_addr) : sizeof(struct in6_addr);
 
-  memset(&req, 0, sizeof(req));
+  memset(req, 0, sizeof(*req));
 
-  req.r.rtm_flags = flags;
-  req.r.rtm_family = family;
+  req->r.rtm_flags = flags;
+  req->r.rtm_family = family;
 #ifndef __ANDROID__
   if (rttable < 256)
-    req.r.rtm_table = rttable;
+    req->r.rtm_table = rttable;
   else {
-    req.r.rtm_table = RT_TABLE_UNSPEC;
-    olsr_netlink_addreq(&req.n, sizeof(req), RTA_TABLE, &rttable, sizeof(rttable));
+    req->r.rtm_table = RT_TABLE_UNSPEC;
+    olsr_netlink_addreq(&req->n, sizeof(*req), RTA_TABLE, &rttable, sizeof(rttable));
   }
 #else
-  req.r.rtm_table = rttable;
+  req->r.rtm_table = rttable;
 #endif
 
-  req.n.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
-  req.n.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+  req->n.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+  req->n.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
 
   if (set) {
-    req.n.nlmsg_flags |= NLM_F_CREATE | NLM_F_REPLACE;
-    req.n.nlmsg_type = RTM_NEWROUTE;
+    req->n.nlmsg_flags |= NLM_F_CREATE | NLM_F_REPLACE;
+    req->n.nlmsg_type = RTM_NEWROUTE;
   } else {
-    req.n.nlmsg_type = RTM_DELROUTE;
+    req->n.nlmsg_type = RTM_DELROUTE;
   }
 
   /* RTN_UNSPEC would be the wildcard, but blackhole broadcast or nat roules should usually not conflict */
   /* -> olsr only adds deletes unicast routes */
   if (blackhole) {
-    req.r.rtm_type = RTN_BLACKHOLE;
+    req->r.rtm_type = RTN_BLACKHOLE;
   } else {
-    req.r.rtm_type = RTN_UNICAST;
+    req->r.rtm_type = RTN_UNICAST;
   }
 
-  req.r.rtm_dst_len = dst->prefix_len;
+  req->r.rtm_dst_len = dst->prefix_len;
 
   if (set) {
     /* add protocol for setting a route */
-    req.r.rtm_protocol = protocol;
+    req->r.rtm_protocol = protocol;
   }
 
   /* calculate scope of operation */
   if (!set && del_similar) {
     /* as wildcard for fuzzy deletion */
-    req.r.rtm_scope = RT_SCOPE_NOWHERE;
+    req->r.rtm_scope = RT_SCOPE_NOWHERE;
   }
   else {
     /* for all our routes */
-    req.r.rtm_scope = scope;
+    req->r.rtm_scope = scope;
   }
 
   if ((set || !del_similar) && !blackhole) {
     /* add interface*/
-    olsr_netlink_addreq(&req.n, sizeof(req), RTA_OIF, &if_index, sizeof(if_index));
+    olsr_netlink_addreq(&req->n, sizeof(*req), RTA_OIF, &if_index, sizeof(if_index));
   }
 
   if (set && src != NULL) {
     /* add src-ip */
-    olsr_netlink_addreq(&req.n, sizeof(req), RTA_PREFSRC, src, family_size);
+    olsr_netlink_addreq(&req->n, sizeof(*req), RTA_PREFSRC, src, family_size);
   }
 
   if (metric >= 0) {
     /* add metric */
-    olsr_netlink_addreq(&req.n, sizeof(req), RTA_PRIORITY, &metric, sizeof(metric));
+    olsr_netlink_addreq(&req->n, sizeof(*req), RTA_PRIORITY, &metric, sizeof(metric));
   }
 
   if (gw) {
     /* add gateway */
-    olsr_netlink_addreq(&req.n, sizeof(req), RTA_GATEWAY, gw, family_size);
+    olsr_netlink_addreq(&req->n, sizeof(*req), RTA_GATEWAY, gw, family_size);
   }
   else {
     if ( dst->prefix_len == 32 ) {
       /* use destination as gateway, to 'force' linux kernel to do proper source address selection */
-      olsr_netlink_addreq(&req.n, sizeof(req), RTA_GATEWAY, &dst->prefix, family_size);
+      olsr_netlink_addreq(&req->n, sizeof(*req), RTA_GATEWAY, &dst->prefix, family_size);
     }
     else {
       /*do not use onlink on such routes(no gateway, but no hostroute aswell) -  e.g. smartgateway default route over an ptp tunnel interface*/
-      req.r.rtm_flags &= (~RTNH_F_ONLINK);
+      req->r.rtm_flags &= (~RTNH_F_ONLINK);
     }
   }
 
    /* add destination */
-  olsr_netlink_addreq(&req.n, sizeof(req), RTA_DST, &dst->prefix, family_size);
+  olsr_netlink_addreq(&req->n, sizeof(*req), RTA_DST, &dst->prefix, family_size);
+}
+
+int olsr_new_netlink_route(unsigned char family, uint32_t rttable, unsigned int flags, unsigned char scope, int if_index, int metric, int protocol,
+    const union olsr_ip_addr *src, const union olsr_ip_addr *gw, const struct olsr_ip_prefix *dst,
+    bool set, bool del_similar, bool blackhole) {
+
+  struct olsr_rtreq req;
+  int err;
+
+  olsr_netlink_route_req(&req, family, rttable, flags, scope, if_index, metric, protocol, src, gw, dst,
+      set, del_similar, blackhole);
 
   err = olsr_netlink_send(&req.n);
   if (err) {
@@ -493,54 +534,62 @@ void olsr_os_inetgw_tunnel_route(uint32_t if_idx, bool ipv4, bool set, uint8_t t
   }
 }
 
-static int olsr_os_process_rt_entry(unsigned char af_family, const struct rt_entry *rt, bool set) {
+/* the parameters of the kernel route that mirrors a rt_entry */
+struct olsr_rt_params {
   int metric;
   uint32_t table;
   const struct rt_nexthop *nexthop;
   union olsr_ip_addr *src;
   bool hostRoute;
-  int err;
+};
 
+static void olsr_os_rt_params(const struct rt_entry *rt, bool set, struct olsr_rt_params *p) {
   /* calculate metric */
   if (FIBM_FLAT == olsr_cnf->fib_metric) {
-    metric = olsr_cnf->fib_metric_default;
+    p->metric = olsr_cnf->fib_metric_default;
   }
   else {
-    metric = set ? rt->rt_best->rtp_metric.hops : rt->rt_metric.hops;
+    p->metric = set ? rt->rt_best->rtp_metric.hops : rt->rt_metric.hops;
   }
 
   if (olsr_cnf->smart_gw_active && is_prefix_inetgw(&rt->rt_dst)) {
     /* make space for the tunnel gateway route */
-    metric += 2;
+    p->metric += 2;
   }
 
   /* get table */
-  table = is_prefix_inetgw(&rt->rt_dst)
+  p->table = is_prefix_inetgw(&rt->rt_dst)
       ? olsr_cnf->rt_table_default : olsr_cnf->rt_table;
 
   /* get next hop */
   if (rt->rt_best && set) {
-    nexthop = &rt->rt_best->rtp_nexthop;
+    p->nexthop = &rt->rt_best->rtp_nexthop;
   }
   else {
-    nexthop = &rt->rt_nexthop;
+    p->nexthop = &rt->rt_nexthop;
   }
 
   /* detect 1-hop hostroute */
-  hostRoute = rt->rt_dst.prefix_len == olsr_cnf->ipsize * 8
-      && ipequal(&nexthop->gateway, &rt->rt_dst.prefix);
+  p->hostRoute = rt->rt_dst.prefix_len == olsr_cnf->ipsize * 8
+      && ipequal(&p->nexthop->gateway, &rt->rt_dst.prefix);
 
   /* get src ip */
   if (olsr_cnf->use_src_ip_routes) {
-    src = &olsr_cnf->unicast_src_ip;
+    p->src = &olsr_cnf->unicast_src_ip;
   }
   else {
-    src = NULL;
+    p->src = NULL;
   }
+}
 
-  /* create route */
-  err = olsr_new_netlink_route(af_family, table, RTNH_F_ONLINK, RT_SCOPE_UNIVERSE, nexthop->iif_index, metric, olsr_cnf->rt_proto,
-      src, hostRoute ? NULL : &nexthop->gateway, &rt->rt_dst, set, false, false);
+/* try to repair a failed route change, returns the final error code */
+static int olsr_os_resolve_rt_error(unsigned char af_family, const struct rt_entry *rt, bool set,
+    const struct olsr_rt_params *p, int err) {
+  const struct rt_nexthop *nexthop = p->nexthop;
+  union olsr_ip_addr *src = p->src;
+  uint32_t table = p->table;
+  int metric = p->metric;
+  bool hostRoute = p->hostRoute;
 
   /* resolve "File exist" (17) propblems (on orig and autogen routes)*/
   if (set && err == 17) {
@@ -602,6 +651,19 @@ static int olsr_os_process_rt_entry(unsigned char af_family, const struct rt_ent
   return err;
 }
 
+static int olsr_os_process_rt_entry(unsigned char af_family, const struct rt_entry *rt, bool set) {
+  struct olsr_rt_params p;
+  int err;
+
+  olsr_os_rt_params(rt, set, &p);
+
+  /* create route */
+  err = olsr_new_netlink_route(af_family, p.table, RTNH_F_ONLINK, RT_SCOPE_UNIVERSE, p.nexthop->iif_index, p.metric,
+      olsr_cnf->rt_proto, p.src, p.hostRoute ? NULL : &p.nexthop->gateway, &rt->rt_dst, set, false, false);
+
+  return olsr_os_resolve_rt_error(af_family, rt, set, &p, err);
+}
+
 /**
  * Insert a route in the kernel routing table
  *
@@ -657,6 +719,205 @@ olsr_ioctl_del_route6(const struct rt_entry *rt)
   OLSR_PRINTF(2, "KERN: Deleting %s\n", olsr_rt_to_string(rt));
   return olsr_os_process_rt_entry(AF_INET6, rt, false);
 }
+
+/**
+ * Queue a route change in the netlink batch instead of sending it
+ * right away. The request is built from the current state of the
+ * rt_entry, the answer of the kernel is reported by
+ * olsr_os_route_batch_flush().
+ *
+ * @param rt the route to add or remove
+ * @param set true to add the route, false to remove it
+ *
+ * @return true if the change was queued, false if the caller has
+ *   to process it synchronously
+ */
+bool
+olsr_os_route_batch_add(struct rt_entry *rt, bool set)
+{
+  struct olsr_rt_batch_entry *entry;
+  struct olsr_rt_params p;
+  struct olsr_rtreq req;
+  size_t len;
+  void *ptr;
+
+  olsr_os_rt_params(rt, set, &p);
+  olsr_netlink_route_req(&req, olsr_cnf->ip_version, p.table, RTNH_F_ONLINK, RT_SCOPE_UNIVERSE, p.nexthop->iif_index,
+      p.metric, olsr_cnf->rt_proto, p.src, p.hostRoute ? NULL : &p.nexthop->gateway, &rt->rt_dst, set, false, false);
+  len = NLMSG_ALIGN(req.n.nlmsg_len);
+
+  if (rt_batch.len + len > rt_batch.size) {
+    ptr = realloc(rt_batch.buf, rt_batch.size * 2 + sizeof(req));
+    if (!ptr) {
+      return false;
+    }
+    rt_batch.buf = ptr;
+    rt_batch.size = rt_batch.size * 2 + sizeof(req);
+  }
+  if (rt_batch.count == rt_batch.entry_size) {
+    ptr = realloc(rt_batch.entry, (rt_batch.entry_size * 2 + 16) * sizeof(*rt_batch.entry));
+    if (!ptr) {
+      return false;
+    }
+    rt_batch.entry = ptr;
+    rt_batch.entry_size = rt_batch.entry_size * 2 + 16;
+  }
+
+  entry = &rt_batch.entry[rt_batch.count++];
+  entry->rt = rt;
+  entry->offset = rt_batch.len;
+  entry->set = set;
+  entry->answered = false;
+  entry->err = -1;
+
+  memcpy(rt_batch.buf + rt_batch.len, &req, req.n.nlmsg_len);
+  rt_batch.len += len;
+  return true;
+}
+
+/* send the batch entries first to last-1 with a single sendmsg() */
+static bool
+olsr_netlink_batch_send(unsigned int first, unsigned int last)
+{
+  struct sockaddr_nl nladdr;
+  struct msghdr msg;
+  struct iovec iov;
+  unsigned int i;
+  size_t end;
+
+  for (i = first; i < last; i++) {
+    struct nlmsghdr *h = (struct nlmsghdr *)ARM_NOWARN_ALIGN(rt_batch.buf + rt_batch.entry[i].offset);
+    h->nlmsg_seq = rt_batch.seq + i;
+  }
+  end = last < rt_batch.count ? rt_batch.entry[last].offset : rt_batch.len;
+
+  memset(&nladdr, 0, sizeof(nladdr));
+  memset(&msg, 0, sizeof(msg));
+
+  nladdr.nl_family = AF_NETLINK;
+
+  msg.msg_name = &nladdr;
+  msg.msg_namelen = sizeof(nladdr);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  iov.iov_base = rt_batch.buf + rt_batch.entry[first].offset;
+  iov.iov_len = end - rt_batch.entry[first].offset;
+
+  if (sendmsg(olsr_cnf->rtnl_s, &msg, 0) <= 0) {
+    olsr_syslog(OLSR_LOG_ERR, "Cannot send data to netlink socket (%d: %s)", errno, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Collect the answers to the batch entries first to last-1.
+ *
+ * This runs synchronously right after the chunk is sent, the kernel
+ * answers route requests immediately and process_routes.c needs the
+ * results before it continues with the RIB. A lost answer must not
+ * stall the main loop, so every wait is limited to NL_BATCH_ACK_TIMEOUT
+ * and unanswered entries are reported as failed.
+ */
+static void
+olsr_netlink_batch_collect(unsigned int first, unsigned int last)
+{
+  char rcvbuf[4096];
+  unsigned int pending = last - first;
+  struct pollfd pfd;
+  struct nlmsghdr *h;
+  struct nlmsgerr *l_err;
+  unsigned int idx;
+  int len;
+
+  pfd.fd = olsr_cnf->rtnl_s;
+  pfd.events = POLLIN;
+
+  while (pending > 0) {
+    len = poll(&pfd, 1, NL_BATCH_ACK_TIMEOUT);
+    if (len == 0) {
+      olsr_syslog(OLSR_LOG_ERR, "Timeout, missing %u answers to netlink batch", pending);
+      return;
+    }
+    if (len > 0) {
+      len = recv(olsr_cnf->rtnl_s, rcvbuf, sizeof(rcvbuf), MSG_DONTWAIT);
+    }
+    if (len < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+      continue;
+    }
+    if (len <= 0) {
+      olsr_syslog(OLSR_LOG_ERR, "Missing %u answers to netlink batch (%d: %s)", pending, errno, strerror(errno));
+      return;
+    }
+
+    for (h = (struct nlmsghdr *)ARM_NOWARN_ALIGN(rcvbuf); NLMSG_OK(h, (unsigned int)len); h = MY_NLMSG_NEXT(h, len)) {
+      if (h->nlmsg_type != NLMSG_ERROR || NLMSG_LENGTH(sizeof(struct nlmsgerr)) > h->nlmsg_len) {
+        continue;
+      }
+
+      /* match the answer to its request, ignore everything that is not ours */
+      idx = h->nlmsg_seq - rt_batch.seq;
+      if (idx < first || idx >= last || rt_batch.entry[idx].answered) {
+        continue;
+      }
+
+      l_err = (struct nlmsgerr *)NLMSG_DATA(h);
+      rt_batch.entry[idx].answered = true;
+      rt_batch.entry[idx].err = -l_err->error;
+      pending--;
+    }
+  }
+}
+
+/**
+ * Send all queued route changes to the kernel, a chunk of requests per
+ * sendmsg(), and collect the answers afterwards. Failed changes get the
+ * same repair attempts as synchronous ones, then the final result of
+ * every change is reported in queue order.
+ *
+ * @param done callback for the result of each queued change
+ */
+void
+olsr_os_route_batch_flush(void (*done)(struct rt_entry *, bool, int))
+{
+  struct olsr_rt_batch_entry *entry;
+  struct olsr_rt_params p;
+  unsigned int first, last, i;
+
+  if (rt_batch.count == 0) {
+    return;
+  }
+
+  rt_batch.seq = olsr_netlink_seq + 1;
+  olsr_netlink_seq += rt_batch.count;
+
+  for (first = 0; first < rt_batch.count; first = last) {
+    last = first + NL_BATCH_CHUNK;
+    if (last > rt_batch.count) {
+      last = rt_batch.count;
+    }
+
+    if (olsr_netlink_batch_send(first, last)) {
+      olsr_netlink_batch_collect(first, last);
+    }
+  }
+
+  for (i = 0; i < rt_batch.count; i++) {
+    entry = &rt_batch.entry[i];
+    if (entry->err != 0 && entry->answered) {
+      olsr_syslog(OLSR_LOG_ERR, ". error: %s route to %s (%s %d)", entry->set ? "add" : "del",
+          olsr_ip_prefix_to_string(&entry->rt->rt_dst), strerror(entry->err), entry->err);
+
+      olsr_os_rt_params(entry->rt, entry->set, &p);
+      entry->err = olsr_os_resolve_rt_error(olsr_cnf->ip_version, entry->rt, entry->set, &p, entry->err);
+    }
+    done(entry->rt, entry->set, entry->err);
+  }
+
+  rt_batch.count = 0;
+  rt_batch.len = 0;
+}
 #endif /* __linux__ */
 
 /*
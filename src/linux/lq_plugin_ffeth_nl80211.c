@@ -91,6 +91,7 @@ struct lq_handler lq_etx_ffeth_nl80211_handler = {
   &lq_initialize_ffeth_nl80211,
   &lq_calc_cost_ffeth_nl80211,
   &lq_calc_cost_ffeth_nl80211,
+  NULL,
 
   &lq_packet_loss_worker_ffeth_nl80211,
 
@@ -45,6 +45,7 @@
 
 #ifdef __linux__
 #define __BSD_SOURCE 1
+#define _GNU_SOURCE 1
 
 #include "../net_os.h"
 #include "../ipcalc.h"
@@ -53,6 +54,9 @@
 #include "kernel_tunnel.h"
 
 #include <net/if.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <linux/filter.h>
 
 #include <sys/ioctl.h>
 #include <sys/utsname.h>
@@ -579,6 +583,101 @@ getsocket6(int bufspace, struct interface_olsr *ifp)
   return sock;
 }
 
+/**
+ *Creates the nonblocking socket that sends the packets of all
+ *interfaces, see olsr_sendto_batch(). It is bound to the OLSR port
+ *but not to a device, each packet selects its interface and source
+ *address with a PKTINFO control message. A socket filter drops all
+ *incoming packets, they are read from the interface sockets.
+ *@return the FD of the socket or -1 on error.
+ */
+int
+getbatchsocket(void)
+{
+  static struct sock_filter drop_all = BPF_STMT(BPF_RET | BPF_K, 0);
+  struct sock_fprog filter = { 1, &drop_all };
+  union {
+    struct sockaddr_in v4;
+    struct sockaddr_in6 v6;
+  } sin;
+  socklen_t sinlen;
+  int precedence = IPTOS_PREC(olsr_cnf->tos);
+  int tos_bits = olsr_cnf->tos;
+  int on = 1;
+  int sock = socket(olsr_cnf->ip_version, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    perror("socket");
+    syslog(LOG_ERR, "socket: %m");
+    return -1;
+  }
+
+  if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) < 0) {
+    perror("setsockopt(SO_ATTACH_FILTER)");
+    syslog(LOG_ERR, "setsockopt SO_ATTACH_FILTER: %m");
+    close(sock);
+    return -1;
+  }
+
+  if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0) {
+    perror("SO_REUSEADDR failed");
+    close(sock);
+    return -1;
+  }
+
+  if (setsockopt(sock, SOL_SOCKET, SO_PRIORITY, (char *)&precedence, sizeof(precedence)) < 0) {
+    perror("setsockopt(SO_PRIORITY)");
+    syslog(LOG_ERR, "setsockopt SO_PRIORITY: %m");
+  }
+
+  memset(&sin, 0, sizeof(sin));
+  if (olsr_cnf->ip_version == AF_INET) {
+    if (setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) < 0) {
+      perror("setsockopt");
+      syslog(LOG_ERR, "setsockopt SO_BROADCAST: %m");
+      close(sock);
+      return -1;
+    }
+    if (setsockopt(sock, IPPROTO_IP, IP_TOS, (char *)&tos_bits, sizeof(tos_bits)) < 0) {
+      perror("setsockopt(IP_TOS)");
+      syslog(LOG_ERR, "setsockopt IP_TOS: %m");
+    }
+
+    sin.v4.sin_family = AF_INET;
+    sin.v4.sin_port = htons(olsr_cnf->olsrport);
+    sinlen = sizeof(sin.v4);
+  } else {
+    if (setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on)) < 0) {
+      perror("setsockopt(IPV6_V6ONLY)");
+      syslog(LOG_ERR, "setsockopt(IPV6_V6ONLY): %m");
+    }
+    if (setsockopt(sock, IPPROTO_IPV6, IPV6_TCLASS, (char *)&tos_bits, sizeof(tos_bits)) < 0) {
+      perror("setsockopt(IPV6_TCLASS)");
+      syslog(LOG_ERR, "setsockopt IPV6_TCLASS: %m");
+    }
+
+    sin.v6.sin6_family = AF_INET6;
+    sin.v6.sin6_port = htons(olsr_cnf->olsrport);
+    sinlen = sizeof(sin.v6);
+  }
+
+  if (bind(sock, (struct sockaddr *)&sin, sinlen) < 0) {
+    perror("bind");
+    syslog(LOG_ERR, "bind: %m");
+    close(sock);
+    return -1;
+  }
+
+  on = fcntl(sock, F_GETFL);
+  if (on == -1) {
+    syslog(LOG_ERR, "fcntl (F_GETFL): %m\n");
+  } else {
+    if (fcntl(sock, F_SETFL, on | O_NONBLOCK) == -1) {
+      syslog(LOG_ERR, "fcntl O_NONBLOCK: %m\n");
+    }
+  }
+  return sock;
+}
+
 int
 join_mcast(struct interface_olsr *ifs, int sock)
 {
@@ -666,6 +765,90 @@ olsr_sendto(int s, const void *buf, size_t len, int flags, const struct sockaddr
   return sendto(s, buf, len, flags, to, tolen);
 }
 
+/**
+ * Send up to count datagrams on a socket with a single sendmmsg(2)
+ * call. Falls back to sendmsg(2) if the kernel does not support
+ * sendmmsg(2). Packets with an if_index get an IP_PKTINFO or
+ * IPV6_PKTINFO control message, so an unbound socket can send
+ * the packets of all interfaces in one call.
+ *
+ * @param s socket to send on
+ * @param pkts array of packet descriptors
+ * @param count number of descriptors, at most OLSR_SEND_BATCH_MAX are used
+ * @param flags flags for sendmmsg(2)
+ * @return number of datagrams sent, -1 if the first one failed
+ */
+int
+olsr_sendto_batch(int s, const struct olsr_send_packet *pkts, unsigned int count, int flags)
+{
+  static bool no_sendmmsg = false;
+  struct mmsghdr msgs[OLSR_SEND_BATCH_MAX];
+  struct iovec iov[OLSR_SEND_BATCH_MAX];
+  union {
+    char buf[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+    struct cmsghdr align;
+  } control[OLSR_SEND_BATCH_MAX];
+  unsigned int i;
+  int n;
+
+  if (count > OLSR_SEND_BATCH_MAX) {
+    count = OLSR_SEND_BATCH_MAX;
+  }
+
+  memset(msgs, 0, sizeof(msgs[0]) * count);
+  for (i = 0; i < count; i++) {
+    iov[i].iov_base = pkts[i].buf;
+    iov[i].iov_len = pkts[i].len;
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = pkts[i].to;
+    msgs[i].msg_hdr.msg_namelen = pkts[i].tolen;
+
+    if (pkts[i].if_index > 0) {
+      struct cmsghdr *cmsg;
+
+      memset(&control[i], 0, sizeof(control[i]));
+      msgs[i].msg_hdr.msg_control = control[i].buf;
+      cmsg = (struct cmsghdr *)control[i].buf;
+
+      if (pkts[i].to->sa_family == AF_INET) {
+        struct in_pktinfo *pi = (struct in_pktinfo *)CMSG_DATA(cmsg);
+
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(*pi));
+        pi->ipi_ifindex = pkts[i].if_index;
+        pi->ipi_spec_dst = pkts[i].from.v4;
+        msgs[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(*pi));
+      } else {
+        struct in6_pktinfo *pi6 = (struct in6_pktinfo *)CMSG_DATA(cmsg);
+
+        cmsg->cmsg_level = IPPROTO_IPV6;
+        cmsg->cmsg_type = IPV6_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(*pi6));
+        pi6->ipi6_ifindex = pkts[i].if_index;
+        pi6->ipi6_addr = pkts[i].from.v6;
+        msgs[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(*pi6));
+      }
+    }
+  }
+
+  if (!no_sendmmsg) {
+    n = sendmmsg(s, msgs, count, flags);
+    if (n >= 0 || errno != ENOSYS) {
+      return n;
+    }
+    no_sendmmsg = true;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (sendmsg(s, &msgs[i].msg_hdr, flags) < 0) {
+      return i == 0 ? -1 : (int)i;
+    }
+  }
+  return count;
+}
+
 /**
  * Wrapper for recvfrom(2)
  */
@@ -676,6 +859,63 @@ olsr_recvfrom(int s, void *buf, size_t len, int flags, struct sockaddr * from, s
   return recvfrom(s, buf, len, flags, from, fromlen);
 }
 
+/**
+ * Read up to count datagrams from a non-blocking socket with a single
+ * recvmmsg(2) call. Falls back to recvfrom(2) if the kernel does not
+ * support recvmmsg(2).
+ *
+ * @param s socket to read from
+ * @param pkts array of packet descriptors, buf and buflen must be set
+ * @param count number of descriptors, at most OLSR_RECV_BATCH_MAX are used
+ * @return number of datagrams read, -1 on error
+ */
+int
+olsr_recvfrom_batch(int s, struct olsr_recv_packet *pkts, unsigned int count)
+{
+  static bool no_recvmmsg = false;
+  struct mmsghdr msgs[OLSR_RECV_BATCH_MAX];
+  struct iovec iov[OLSR_RECV_BATCH_MAX];
+  unsigned int i;
+  int n;
+
+  if (count > OLSR_RECV_BATCH_MAX) {
+    count = OLSR_RECV_BATCH_MAX;
+  }
+
+  if (!no_recvmmsg) {
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (i = 0; i < count; i++) {
+      iov[i].iov_base = pkts[i].buf;
+      iov[i].iov_len = pkts[i].buflen;
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &pkts[i].from;
+      msgs[i].msg_hdr.msg_namelen = sizeof(pkts[i].from);
+    }
+
+    n = recvmmsg(s, msgs, count, MSG_DONTWAIT, NULL);
+    if (n >= 0) {
+      for (i = 0; i < (unsigned int)n; i++) {
+        pkts[i].fromlen = msgs[i].msg_hdr.msg_namelen;
+        pkts[i].len = msgs[i].msg_len;
+      }
+      return n;
+    }
+    if (errno != ENOSYS) {
+      return -1;
+    }
+    no_recvmmsg = true;
+  }
+
+  pkts[0].fromlen = sizeof(pkts[0].from);
+  n = recvfrom(s, pkts[0].buf, pkts[0].buflen, MSG_DONTWAIT, (struct sockaddr *)&pkts[0].from, &pkts[0].fromlen);
+  if (n < 0) {
+    return -1;
+  }
+  pkts[0].len = n;
+  return 1;
+}
+
 /**
  * Wrapper for select(2)
  */
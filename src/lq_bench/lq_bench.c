@@ -0,0 +1,372 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/*
+ * Link quality handler benchmark.
+ *
+ * Measures the per-message cost of parsing and building the link quality
+ * part of HELLO and TC messages for every built-in lq handler. Each
+ * operation is timed through the olsr_*_lq_pair() wrappers the daemon
+ * uses and, for reference, through the handler table directly. In a
+ * build with "make LQ_STATIC=<handler>" the wrappers call the selected
+ * handler inline, so the two columns differ only for that handler.
+ * tc/recost compares the batch olsr_calc_tc_costs() with one
+ * calc_tc_cost() call per edge.
+ * Build it with "make lq_bench".
+ */
+
+#include "defs.h"
+#include "olsr.h"
+#include "olsr_cfg.h"
+#include "olsr_cookie.h"
+#include "scheduler.h"
+#include "lq_plugin.h"
+#include "common/arena.h"
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* defined by main.c in olsrd */
+struct olsr_cookie_info *def_timer_ci = NULL;
+
+enum lq_bench_op {
+  LQ_BENCH_TC_PARSE,
+  LQ_BENCH_TC_BUILD,
+  LQ_BENCH_TC_RECOST,
+  LQ_BENCH_HELLO_PARSE,
+  LQ_BENCH_HELLO_BUILD,
+  LQ_BENCH_OP_COUNT
+};
+
+static const char *const lq_bench_op_names[LQ_BENCH_OP_COUNT] = {
+  "tc/parse", "tc/build", "tc/recost", "hello/parse", "hello/build"
+};
+
+static const char *const lq_bench_handlers[] = {
+  "etx_ff", "etx_ffeth", "etx_float", "etx_fpm"
+};
+
+/* neighbors per message if none is given on the command line */
+static const unsigned int lq_bench_default_sizes[] = { 4, 32, 128 };
+
+#define LQ_BENCH_MAX_ENTRIES 4096
+
+/* all lq pairs on the wire are 4 bytes */
+#define LQ_BENCH_PAIR_SIZE 4
+
+/* total number of entries a measurement aims for */
+#define LQ_BENCH_WORK 20000000
+
+static uint8_t *bench_wire;
+static struct tc_edge_entry **bench_edges;
+static struct tc_mpr_addr **bench_mprs;
+static struct hello_neighbor **bench_hellos;
+static struct lq_hello_neighbor **bench_lq_hellos;
+static const void **bench_lqs;
+static olsr_linkcost *bench_costs;
+static struct arena bench_arena;
+static uint32_t bench_random_state;
+
+/*
+ * Small xorshift generator, so that a seed gives the same
+ * messages on every platform.
+ */
+static uint32_t
+bench_random(void)
+{
+  bench_random_state ^= bench_random_state << 13;
+  bench_random_state ^= bench_random_state >> 17;
+  bench_random_state ^= bench_random_state << 5;
+  return bench_random_state;
+}
+
+static double
+bench_now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/*
+ * Fill the wire buffer with random lq pairs and parse it once, so the
+ * build operations start from the same link qualities.
+ */
+static void
+bench_build(unsigned int count)
+{
+  const uint8_t *curr;
+  unsigned int i;
+
+  arena_reset(&bench_arena);
+  for (i = 0; i < count * LQ_BENCH_PAIR_SIZE; i++) {
+    bench_wire[i] = bench_random();
+  }
+
+  curr = bench_wire;
+  for (i = 0; i < count; i++) {
+    bench_edges[i] = olsr_arena_malloc(&bench_arena, sizeof(struct tc_edge_entry) + active_lq_handler->tc_lq_size,
+                                       "lq_bench edge");
+    bench_mprs[i] = olsr_arena_tc_mpr_addr(&bench_arena, "lq_bench mpr");
+    bench_hellos[i] = olsr_arena_hello_neighbor(&bench_arena, "lq_bench hello");
+    bench_lq_hellos[i] = olsr_arena_lq_hello_neighbor(&bench_arena, "lq_bench lq hello");
+
+    active_lq_handler->deserialize_tc_lq(&curr, bench_edges[i]->linkquality);
+    bench_lqs[i] = bench_edges[i]->linkquality;
+    memcpy(bench_mprs[i]->linkquality, bench_edges[i]->linkquality, active_lq_handler->tc_lq_size);
+    memcpy(bench_lq_hellos[i]->linkquality, bench_edges[i]->linkquality, active_lq_handler->tc_lq_size);
+  }
+}
+
+/*
+ * Run one operation over a message of count entries, either through
+ * the olsr_*_lq_pair() wrappers or through the handler table.
+ */
+static uint32_t
+bench_message(enum lq_bench_op op, bool table, unsigned int count)
+{
+  const uint8_t *curr = bench_wire;
+  uint8_t *buff = bench_wire;
+  uint32_t sum = 0;
+  unsigned int i;
+
+  switch (op) {
+  case LQ_BENCH_TC_PARSE:
+    for (i = 0; i < count; i++) {
+      if (table) {
+        active_lq_handler->deserialize_tc_lq(&curr, bench_edges[i]->linkquality);
+        sum += active_lq_handler->calc_tc_cost(bench_edges[i]->linkquality);
+      } else {
+        olsr_deserialize_tc_lq_pair(&curr, bench_edges[i]);
+        sum += olsr_calc_tc_cost(bench_edges[i]);
+      }
+    }
+    break;
+  case LQ_BENCH_TC_BUILD:
+    for (i = 0; i < count; i++) {
+      if (table) {
+        buff += active_lq_handler->serialize_tc_lq(buff, bench_mprs[i]->linkquality);
+      } else {
+        buff += olsr_serialize_tc_lq_pair(buff, bench_mprs[i]);
+      }
+    }
+    break;
+  case LQ_BENCH_TC_RECOST:
+    if (table) {
+      for (i = 0; i < count; i++) {
+        bench_costs[i] = active_lq_handler->calc_tc_cost(bench_lqs[i]);
+      }
+    } else {
+      olsr_calc_tc_costs(bench_costs, bench_lqs, count);
+    }
+    for (i = 0; i < count; i++) {
+      sum += bench_costs[i];
+    }
+    break;
+  case LQ_BENCH_HELLO_PARSE:
+    for (i = 0; i < count; i++) {
+      if (table) {
+        active_lq_handler->deserialize_hello_lq(&curr, bench_hellos[i]->linkquality);
+        bench_hellos[i]->cost = active_lq_handler->calc_hello_cost(bench_hellos[i]->linkquality);
+      } else {
+        olsr_deserialize_hello_lq_pair(&curr, bench_hellos[i]);
+      }
+      sum += bench_hellos[i]->cost;
+    }
+    break;
+  default:
+    for (i = 0; i < count; i++) {
+      if (table) {
+        buff += active_lq_handler->serialize_hello_lq(buff, bench_lq_hellos[i]->linkquality);
+      } else {
+        buff += olsr_serialize_hello_lq_pair(buff, bench_lq_hellos[i]);
+      }
+    }
+    break;
+  }
+  return sum + (uint32_t)(buff - bench_wire);
+}
+
+static double
+bench_speed(enum lq_bench_op op, bool table, unsigned int count)
+{
+  unsigned int rounds = LQ_BENCH_WORK / count + 1;
+  unsigned int j;
+  volatile uint32_t sink;
+  uint32_t sum = 0;
+  double start;
+
+  start = bench_now();
+  for (j = 0; j < rounds; j++) {
+    sum += bench_message(op, table, count);
+  }
+  sink = sum;
+  (void)sink;
+  return (bench_now() - start) * 1e9 / rounds;
+}
+
+static void
+bench_handler(const char *name, unsigned int count)
+{
+  struct lq_handler_node *node;
+  int op;
+
+  node = (struct lq_handler_node *)avl_find(&lq_handler_tree, name);
+  if (node == NULL) {
+    fprintf(stderr, "Unknown lq handler %s\n", name);
+    exit(EXIT_FAILURE);
+  }
+
+  /* the per-entry functions do not depend on the handler state, so no initialize() */
+  active_lq_handler = node->handler;
+  bench_build(count);
+
+  for (op = 0; op < LQ_BENCH_OP_COUNT; op++) {
+    double wrapper = bench_speed(op, false, count);
+    double table = bench_speed(op, true, count);
+
+    printf("%-10s %-12s %8u %10.1f %10.1f %8.2f\n", name, lq_bench_op_names[op], count,
+           wrapper, table, wrapper / count);
+  }
+}
+
+static void
+bench_usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-n entries] [-s seed]\n"
+          "  -n  neighbors per message, default 4, 32 and 128\n"
+          "  -s  seed of the lq generator, default 1\n", name);
+  exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char *argv[])
+{
+  unsigned int entries = 0, max_entries, i, h;
+  int opt;
+
+  bench_random_state = 1;
+  while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+    switch (opt) {
+    case 'n':
+      entries = strtoul(optarg, NULL, 0);
+      if (entries < 1 || entries > LQ_BENCH_MAX_ENTRIES) {
+        bench_usage(argv[0]);
+      }
+      break;
+    case 's':
+      bench_random_state = strtoul(optarg, NULL, 0);
+      if (!bench_random_state) {
+        bench_random_state = 1;
+      }
+      break;
+    default:
+      bench_usage(argv[0]);
+      break;
+    }
+  }
+
+  olsr_cnf = olsrd_get_default_cnf(strdup(argv[0]));
+  olsr_cnf->debug_level = 0;
+  olsr_cnf->lq_level = 2;
+
+  /* registers all built-in handlers and activates the default one */
+  olsr_init_timers();
+  def_timer_ci = olsr_alloc_cookie("Default Timer Cookie", OLSR_COOKIE_TYPE_TIMER);
+  init_lq_handler_tree();
+
+  max_entries = entries ? entries : lq_bench_default_sizes[sizeof(lq_bench_default_sizes) / sizeof(lq_bench_default_sizes[0]) - 1];
+  bench_wire = calloc(max_entries, LQ_BENCH_PAIR_SIZE);
+  bench_edges = calloc(max_entries, sizeof(*bench_edges));
+  bench_mprs = calloc(max_entries, sizeof(*bench_mprs));
+  bench_hellos = calloc(max_entries, sizeof(*bench_hellos));
+  bench_lq_hellos = calloc(max_entries, sizeof(*bench_lq_hellos));
+  bench_lqs = calloc(max_entries, sizeof(*bench_lqs));
+  bench_costs = calloc(max_entries, sizeof(*bench_costs));
+  if (!bench_wire || !bench_edges || !bench_mprs || !bench_hellos || !bench_lq_hellos || !bench_lqs || !bench_costs) {
+    fprintf(stderr, "Out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+#ifdef LQ_STATIC_FF
+  printf("lq handler called inline: etx_ff\n");
+#elif defined LQ_STATIC_FFETH
+  printf("lq handler called inline: etx_ffeth\n");
+#elif defined LQ_STATIC_FLOAT
+  printf("lq handler called inline: etx_float\n");
+#elif defined LQ_STATIC_FPM
+  printf("lq handler called inline: etx_fpm\n");
+#else
+  printf("lq handler called inline: none\n");
+#endif
+  printf("%-10s %-12s %8s %10s %10s %8s\n", "handler", "operation", "entries", "ns/msg", "table", "ns/entry");
+
+  for (h = 0; h < sizeof(lq_bench_handlers) / sizeof(lq_bench_handlers[0]); h++) {
+    if (entries) {
+      bench_handler(lq_bench_handlers[h], entries);
+      continue;
+    }
+    for (i = 0; i < sizeof(lq_bench_default_sizes) / sizeof(lq_bench_default_sizes[0]); i++) {
+      bench_handler(lq_bench_handlers[h], lq_bench_default_sizes[i]);
+    }
+  }
+
+  arena_free(&bench_arena);
+  free(bench_wire);
+  free(bench_edges);
+  free(bench_mprs);
+  free(bench_hellos);
+  free(bench_lq_hellos);
+  free(bench_lqs);
+  free(bench_costs);
+  return EXIT_SUCCESS;
+}
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -47,122 +47,278 @@
 #include "scheduler.h"
 #include "lq_plugin.h"
 
+/*
+ * 2 hop neighbors whose inputs to the MPR selection changed since the
+ * last run. Only these are evaluated again, unless a change which can
+ * not be tracked per entry (like a MID update) requests a full run.
+ */
+static struct list_node lq_mpr_dirty_list = { &lq_mpr_dirty_list, &lq_mpr_dirty_list };
+
+static bool lq_mpr_all_dirty = true;
+
+/**
+ * Queue a 2 hop neighbor for the next LQ-MPR run.
+ *
+ * @param neigh2 the 2 hop neighbor
+ */
 void
-olsr_calculate_lq_mpr(void)
+olsr_lq_mpr_mark_dirty(struct neighbor_2_entry *neigh2)
 {
-  struct neighbor_2_entry *neigh2;
-  struct neighbor_list_entry *walker;
-  int i, k;
-  struct neighbor_entry *neigh;
-  olsr_linkcost best, best_1hop;
-  bool mpr_changes = false;
+  if (!list_node_on_list(&neigh2->mpr_dirty_node)) {
+    list_add_before(&lq_mpr_dirty_list, &neigh2->mpr_dirty_node);
+  }
+}
 
-  OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
+/**
+ * Queue all 2 hop neighbors depending on a 1 hop neighbor, used
+ * when its status changes or it is removed.
+ *
+ * @param neigh the 1 hop neighbor
+ */
+void
+olsr_lq_mpr_mark_neighbor(struct neighbor_entry *neigh)
+{
+  struct neighbor_2_list_entry *two_hop_list;
+  struct neighbor_2_entry *neigh2;
 
-    /* Memorize previous MPR status. */
+  for (two_hop_list = neigh->neighbor_2_list.next; two_hop_list != &neigh->neighbor_2_list; two_hop_list = two_hop_list->next) {
+    olsr_lq_mpr_mark_dirty(two_hop_list->neighbor_2);
+  }
 
-    neigh->was_mpr = neigh->is_mpr;
+  /* the neighbor might be a 2 hop neighbor, too */
+  neigh2 = olsr_lookup_two_hop_neighbor_table(&neigh->neighbor_main_addr);
+  if (neigh2 != NULL) {
+    olsr_lq_mpr_mark_dirty(neigh2);
+  }
+}
 
-    /* Clear current MPR status. */
+/**
+ * Evaluate all 2 hop neighbors in the next LQ-MPR run.
+ */
+void
+olsr_lq_mpr_mark_all_dirty(void)
+{
+  lq_mpr_all_dirty = true;
+}
 
-    neigh->is_mpr = false;
+/**
+ * Queue the 2 hop neighbors whose path cost over a neighbor differs
+ * from the one seen by the last LQ-MPR run. Called after a HELLO of
+ * the neighbor has been processed.
+ *
+ * @param neigh the 1 hop neighbor
+ */
+void
+olsr_lq_mpr_check_paths(struct neighbor_entry *neigh)
+{
+  struct neighbor_2_list_entry *two_hop_list;
+  struct neighbor_list_entry *walker;
 
-    /* In this pass we are only interested in WILL_ALWAYS neighbours */
+  for (two_hop_list = neigh->neighbor_2_list.next; two_hop_list != &neigh->neighbor_2_list; two_hop_list = two_hop_list->next) {
+    struct neighbor_2_entry *neigh2 = two_hop_list->neighbor_2;
 
-    if (neigh->status == NOT_SYM || neigh->willingness != WILL_ALWAYS) {
-      continue;
+    for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next) {
+      if (walker->neighbor == neigh && walker->path_linkcost != walker->mpr_path_linkcost) {
+        olsr_lq_mpr_mark_dirty(neigh2);
+        break;
+      }
     }
+  }
+}
 
-    neigh->is_mpr = true;
+/**
+ * Drop the MPR selection of a 1 hop neighbor entry of a 2 hop
+ * neighbor before the entry is removed.
+ *
+ * @param neigh2 the 2 hop neighbor
+ * @param walker the entry which will be removed
+ */
+void
+olsr_lq_mpr_forget_link(struct neighbor_2_entry *neigh2, struct neighbor_list_entry *walker)
+{
+  if (walker->mpr_selected) {
+    walker->neighbor->lq_mpr_count--;
+    walker->mpr_selected = false;
+  }
+  olsr_lq_mpr_mark_dirty(neigh2);
+}
 
-    if (neigh->is_mpr != neigh->was_mpr) {
-      mpr_changes = true;
-    }
+/**
+ * Drop the MPR selections and the queue entry of a 2 hop neighbor
+ * before it is removed.
+ *
+ * @param neigh2 the 2 hop neighbor
+ */
+void
+olsr_lq_mpr_forget(struct neighbor_2_entry *neigh2)
+{
+  struct neighbor_list_entry *walker;
 
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next) {
+    if (walker->mpr_selected) {
+      walker->neighbor->lq_mpr_count--;
+      walker->mpr_selected = false;
+    }
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
+  if (list_node_on_list(&neigh2->mpr_dirty_node)) {
+    list_remove(&neigh2->mpr_dirty_node);
+  }
+}
 
-  for (i = 0; i < HASHSIZE; i++) {
-    /* loop through all 2-hop neighbours */
+/**
+ * Cost of the direct link to a 2 hop neighbor which is a symmetric
+ * neighbor, too. An MPR is only chosen for a path better than this.
+ *
+ * @param neigh2 the 2 hop neighbor
+ * @return the link cost, LINK_COST_BROKEN if there is no such neighbor
+ * and 0 if there is no link to it, so that no MPR is chosen
+ */
+static olsr_linkcost
+olsr_lq_mpr_best_1hop(const struct neighbor_2_entry *neigh2)
+{
+  struct neighbor_entry *neigh;
+  struct link_entry *lnk;
+
+  neigh = olsr_lookup_neighbor_table(&neigh2->neighbor_2_addr);
+  if (neigh == NULL || neigh->status != SYM) {
+    return LINK_COST_BROKEN;
+  }
 
-    for (neigh2 = two_hop_neighbortable[i].next; neigh2 != &two_hop_neighbortable[i]; neigh2 = neigh2->next) {
-      best_1hop = LINK_COST_BROKEN;
+  lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
+  return lnk ? lnk->linkcost : 0;
+}
 
-      /* check whether this 2-hop neighbour is also a neighbour */
+/**
+ * Choose the MPRs covering a single 2 hop neighbor and replace
+ * the previous choice for it.
+ *
+ * @param neigh2 the 2 hop neighbor
+ */
+static void
+olsr_lq_mpr_select(struct neighbor_2_entry *neigh2)
+{
+  struct neighbor_list_entry *walker, *best_walker;
+  olsr_linkcost best, best_1hop;
+  int k;
 
-      neigh = olsr_lookup_neighbor_table(&neigh2->neighbor_2_addr);
+  /* forget the previous choice and remember the inputs of this one */
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next) {
+    if (walker->mpr_selected) {
+      walker->neighbor->lq_mpr_count--;
+      walker->mpr_selected = false;
+    }
+    walker->mpr_path_linkcost = walker->path_linkcost;
+  }
 
-      /* if it's a neighbour and also symmetric, then examine
-         the link quality */
+  best_1hop = olsr_lq_mpr_best_1hop(neigh2);
+  neigh2->mpr_best_1hop = best_1hop;
 
-      if (neigh != NULL && neigh->status == SYM) {
-        /* if the direct link is better than the best route via
-         * an MPR, then prefer the direct link and do not select
-         * an MPR for this 2-hop neighbour */
+  /* if the direct link is better than the best route via
+   * an MPR, then prefer the direct link and do not select
+   * an MPR for this 2-hop neighbour */
 
-        /* determine the link quality of the direct link */
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
+    if (walker->path_linkcost < best_1hop)
+      break;
 
-        struct link_entry *lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
+  if (walker == &neigh2->neighbor_2_nblist)
+    return;
 
-        if (!lnk)
-          continue;
+  /* find the connecting 1-hop neighbours with the
+   * best total link qualities */
 
-        best_1hop = lnk->linkcost;
+  /* mark all 1-hop neighbours as not selected */
 
-        /* see wether we find a better route via an MPR */
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
+    walker->neighbor->skip = false;
 
-        for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-          if (walker->path_linkcost < best_1hop)
-            break;
+  for (k = 0; k < olsr_cnf->mpr_coverage; k++) {
+    /* look for the best 1-hop neighbour that we haven't
+     * yet selected */
 
-        /* we've reached the end of the list, so we haven't found
-         * a better route via an MPR - so, skip MPR selection for
-         * this 1-hop neighbor */
+    best_walker = NULL;
+    best = LINK_COST_BROKEN;
 
-        if (walker == &neigh2->neighbor_2_nblist)
-          continue;
+    for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
+      if (walker->neighbor->status == SYM && !walker->neighbor->skip && walker->path_linkcost < best) {
+        best_walker = walker;
+        best = walker->path_linkcost;
       }
 
-      /* find the connecting 1-hop neighbours with the
-       * best total link qualities */
+    /* Found a 1-hop neighbor that we haven't previously selected.
+     * Use it as MPR only when the 2-hop path through it is better than
+     * any existing 1-hop path. */
+    if ((best_walker != NULL) && (best < best_1hop)) {
+      best_walker->mpr_selected = true;
+      best_walker->neighbor->lq_mpr_count++;
+      best_walker->neighbor->skip = true;
+    }
 
-      /* mark all 1-hop neighbours as not selected */
+    /* no neighbour found => the requested MPR coverage cannot
+     * be satisfied => stop */
 
-      for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-        walker->neighbor->skip = false;
+    else
+      break;
+  }
+}
 
-      for (k = 0; k < olsr_cnf->mpr_coverage; k++) {
-        /* look for the best 1-hop neighbour that we haven't
-         * yet selected */
+void
+olsr_calculate_lq_mpr(void)
+{
+  struct neighbor_2_entry *neigh2;
+  struct neighbor_entry *neigh;
+  unsigned int touched = 0;
+  bool mpr_changes = false;
 
-        neigh = NULL;
-        best = LINK_COST_BROKEN;
+  if (lq_mpr_all_dirty) {
 
-        for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-          if (walker->neighbor->status == SYM && !walker->neighbor->skip && walker->path_linkcost < best) {
-            neigh = walker->neighbor;
-            best = walker->path_linkcost;
-          }
+    /* loop through all 2-hop neighbours */
+    OLSR_FOR_ALL_NBR2_ENTRIES(neigh2) {
+      olsr_lq_mpr_select(neigh2);
+      touched++;
+    }
+    OLSR_FOR_ALL_NBR2_ENTRIES_END(neigh2);
 
-        /* Found a 1-hop neighbor that we haven't previously selected.
-         * Use it as MPR only when the 2-hop path through it is better than
-         * any existing 1-hop path. */
-        if ((neigh != NULL) && (best < best_1hop)) {
-          neigh->is_mpr = true;
-          neigh->skip = true;
+    while (!list_is_empty(&lq_mpr_dirty_list)) {
+      list_remove(lq_mpr_dirty_list.next);
+    }
+    lq_mpr_all_dirty = false;
+  } else {
+
+    /* pick up cost changes of the direct links to 2-hop neighbours */
+    OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
+      neigh2 = olsr_lookup_two_hop_neighbor_table(&neigh->neighbor_main_addr);
+      if (neigh2 != NULL && olsr_lq_mpr_best_1hop(neigh2) != neigh2->mpr_best_1hop) {
+        olsr_lq_mpr_mark_dirty(neigh2);
+      }
+    }
+    OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
 
-          if (neigh->is_mpr != neigh->was_mpr)
-            mpr_changes = true;
-        }
+    while (!list_is_empty(&lq_mpr_dirty_list)) {
+      neigh2 = mpr_dirty2nbr2(lq_mpr_dirty_list.next);
+      list_remove(&neigh2->mpr_dirty_node);
+      olsr_lq_mpr_select(neigh2);
+      touched++;
+    }
+  }
 
-        /* no neighbour found => the requested MPR coverage cannot
-         * be satisfied => stop */
+  OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
 
-        else
-          break;
-      }
+    /* Memorize previous MPR status. */
+
+    neigh->was_mpr = neigh->is_mpr;
+
+    /* WILL_ALWAYS neighbours and the ones chosen by a 2-hop neighbour */
+
+    neigh->is_mpr = (neigh->status != NOT_SYM && neigh->willingness == WILL_ALWAYS) || neigh->lq_mpr_count > 0;
+
+    if (neigh->is_mpr && !neigh->was_mpr) {
+      mpr_changes = true;
     }
   }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
+
+  OLSR_PRINTF(3, "LQ-MPR: evaluated %u of %u 2-hop neighbours\n", touched, two_hop_neighbortable.count);
 
   if (mpr_changes && olsr_cnf->tc_redundancy > 0)
     signal_link_changes(true);
@@ -42,8 +42,23 @@
 #ifndef _OLSR_LQ_MPR
 #define _OLSR_LQ_MPR
 
+#include "neighbor_table.h"
+#include "two_hop_neighbor_table.h"
+
 void olsr_calculate_lq_mpr(void);
 
+void olsr_lq_mpr_mark_dirty(struct neighbor_2_entry *);
+
+void olsr_lq_mpr_mark_neighbor(struct neighbor_entry *);
+
+void olsr_lq_mpr_mark_all_dirty(void);
+
+void olsr_lq_mpr_check_paths(struct neighbor_entry *);
+
+void olsr_lq_mpr_forget_link(struct neighbor_2_entry *, struct neighbor_list_entry *);
+
+void olsr_lq_mpr_forget(struct neighbor_2_entry *);
+
 #endif /* _OLSR_LQ_MPR */
 
 /*
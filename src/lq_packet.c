@@ -92,7 +92,7 @@ create_lq_hello(struct lq_hello_message *lq_hello, struct interface_olsr *outif)
   OLSR_FOR_ALL_LINK_ENTRIES(walker) {
 
     // allocate a neighbour entry
-    struct lq_hello_neighbor *neigh = olsr_malloc_lq_hello_neighbor("Build LQ_HELLO");
+    struct lq_hello_neighbor *neigh = olsr_arena_lq_hello_neighbor(&olsr_msg_arena, "Build LQ_HELLO");
 
     // a) this neighbor interface IS NOT visible via the output interface
     if (!ipequal(&walker->local_iface_addr, &outif->ip_addr))
@@ -137,59 +137,89 @@ create_lq_hello(struct lq_hello_message *lq_hello, struct interface_olsr *outif)
 static void
 destroy_lq_hello(struct lq_hello_message *lq_hello)
 {
-  struct lq_hello_neighbor *walker, *aux;
+  // the queued neighbour entries live in the message arena
 
-  // loop through the queued neighbour entries and free them
-
-  for (walker = lq_hello->neigh; walker != NULL; walker = aux) {
-    aux = walker->next;
-    free(walker);
-  }
+  arena_reset(&olsr_msg_arena);
 
   lq_hello->neigh = NULL;
 }
 
-static void
-create_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
-{
+/*
+ * The sorted neighbour set of our LQ TC and its serialized address/LQ
+ * records do not depend on the output interface. They are built once
+ * and shared by all interfaces until the ANSN or the neighbourhood
+ * changes. Every interface rebuilds them at most once per emission
+ * interval, so the advertised link qualities do not go stale.
+ */
+struct lq_tc_cache_nbr {
+  union olsr_ip_addr address;
   struct link_entry *lnk;
-  struct neighbor_entry *walker;
-  struct tc_mpr_addr *neigh;
-  static int ttl_list[] = { 2, 8, 2, 16, 2, 8, 2, MAX_TTL };
+};
 
-  // remember that we have generated an LQ TC message; this is
-  // checked in net_output()
+static struct {
+  bool stale;
+  uint16_t ansn;
+  uint32_t generation;
 
-  lq_tc_pending = true;
+  /* number of neighbours, record i spans offset[i] to offset[i+1] */
+  uint32_t count;
+  uint32_t *offset;
+  unsigned char *payload;
 
-  // initialize the static fields
+  uint32_t nbr_size, offset_size, payload_size;
+  struct lq_tc_cache_nbr *nbr;
+  struct tc_mpr_addr *lq;
+} lq_tc_cache = { true, 0, 0, 0, NULL, NULL, 0, 0, 0, NULL, NULL };
 
-  lq_tc->comm.type = LQ_TC_MESSAGE;
-  lq_tc->comm.vtime = me_to_reltime(outif->valtimes.tc);
-  lq_tc->comm.size = 0;
+/*
+ * olsr_lq_tc_invalidate
+ *
+ * The neighbourhood has changed, rebuild the LQ TC
+ * neighbour set before the next LQ TC is sent.
+ */
+void
+olsr_lq_tc_invalidate(void)
+{
+  lq_tc_cache.stale = true;
+}
 
-  lq_tc->comm.orig = olsr_cnf->main_addr;
+static int
+lq_tc_cache_cmp(const void *a, const void *b)
+{
+  const struct lq_tc_cache_nbr *nbr_a = a, *nbr_b = b;
 
-  if (olsr_cnf->lq_fish > 0) {
-    if (outif->ttl_index >= (int)(sizeof(ttl_list) / sizeof(ttl_list[0])))
-      outif->ttl_index = 0;
+  return avl_comp_default(&nbr_a->address, &nbr_b->address);
+}
 
-    lq_tc->comm.ttl = (0 <= outif->ttl_index ? ttl_list[outif->ttl_index] : MAX_TTL);
-    outif->ttl_index++;
+static void *
+lq_tc_cache_grow(void *ptr, uint32_t *size, uint32_t needed, size_t elem_size)
+{
+  uint32_t new_size = *size;
 
-    OLSR_PRINTF(3, "Creating LQ TC with TTL %d.\n", lq_tc->comm.ttl);
+  if (needed <= new_size) {
+    return ptr;
   }
+  while (new_size < needed) {
+    new_size = new_size * 2 + 16;
+  }
+  ptr = realloc(ptr, new_size * elem_size);
+  if (!ptr) {
+    OLSR_PRINTF(1, "LQ_TC: out of memory for %u entries\n", new_size);
+    olsr_exit(__func__, EXIT_FAILURE);
+  }
+  *size = new_size;
+  return ptr;
+}
 
-  else
-    lq_tc->comm.ttl = MAX_TTL;
-
-  lq_tc->comm.hops = 0;
-
-  lq_tc->from = olsr_cnf->main_addr;
-
-  lq_tc->ansn = get_local_ansn();
+static void
+lq_tc_cache_build(void)
+{
+  struct link_entry *lnk;
+  struct neighbor_entry *walker;
+  uint32_t count = 0, off = 0, i;
 
-  lq_tc->neigh = NULL;
+  lq_tc_cache.nbr =
+    lq_tc_cache_grow(lq_tc_cache.nbr, &lq_tc_cache.nbr_size, neighbortable.count + 1, sizeof(*lq_tc_cache.nbr));
 
   OLSR_FOR_ALL_NBR_ENTRIES(walker) {
 
@@ -230,55 +260,88 @@ create_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
       continue;                 // don't advertise links with very low LQ
     }
 
-    /* Allocate a neighbour entry. */
-    neigh = olsr_malloc_tc_mpr_addr("Build LQ_TC");
-
-    /* Set the entry's main address. */
-    neigh->address = walker->neighbor_main_addr;
+    lq_tc_cache.nbr[count].address = walker->neighbor_main_addr;
+    lq_tc_cache.nbr[count].lnk = lnk;
+    count++;
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(walker);
 
-    if (lnk) {
-      olsr_copylq_link_entry_2_tc_mpr_addr(neigh, lnk);
-    }
+  qsort(lq_tc_cache.nbr, count, sizeof(*lq_tc_cache.nbr), &lq_tc_cache_cmp);
 
-    /* Queue the neighbour entry. */
+  if (!lq_tc_cache.lq) {
+    lq_tc_cache.lq = olsr_malloc_tc_mpr_addr("Build LQ_TC");
+  }
 
-    // TODO: ugly hack until neighbor table is ported to avl tree
+  lq_tc_cache.offset = lq_tc_cache_grow(lq_tc_cache.offset, &lq_tc_cache.offset_size, count + 1, sizeof(*lq_tc_cache.offset));
 
-    if (lq_tc->neigh == NULL || avl_comp_default(&lq_tc->neigh->address, &neigh->address) > 0) {
-      neigh->next = lq_tc->neigh;
-      lq_tc->neigh = neigh;
-    } else {
-      struct tc_mpr_addr *last = lq_tc->neigh, *n = last->next;
+  // serialize the address and link quality of every neighbour, the
+  // size of the link quality is only known afterwards
 
-      while (n) {
-        if (avl_comp_default(&n->address, &neigh->address) > 0) {
-          break;
-        }
-        last = n;
-        n = n->next;
-      }
-      neigh->next = n;
-      last->next = neigh;
-    }
+  for (i = 0; i < count; i++) {
+    lq_tc_cache.payload =
+      lq_tc_cache_grow(lq_tc_cache.payload, &lq_tc_cache.payload_size, off + olsr_cnf->ipsize + MAXMESSAGESIZE, 1);
+    lq_tc_cache.offset[i] = off;
 
-    // neigh->next = lq_tc->neigh;
-    // lq_tc->neigh = neigh;
+    genipcopy(lq_tc_cache.payload + off, &lq_tc_cache.nbr[i].address);
+    off += olsr_cnf->ipsize;
 
+    olsr_copylq_link_entry_2_tc_mpr_addr(lq_tc_cache.lq, lq_tc_cache.nbr[i].lnk);
+    off += olsr_serialize_tc_lq_pair(lq_tc_cache.payload + off, lq_tc_cache.lq);
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(walker);
+  lq_tc_cache.offset[count] = off;
+  lq_tc_cache.count = count;
+
+  lq_tc_cache.ansn = get_local_ansn();
+  lq_tc_cache.generation++;
+  lq_tc_cache.stale = false;
+
+  OLSR_PRINTF(3, "LQ_TC: built neighbour set with %u entries\n", count);
 }
 
 static void
-destroy_lq_tc(struct lq_tc_message *lq_tc)
+create_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
 {
-  struct tc_mpr_addr *walker, *aux;
+  static int ttl_list[] = { 2, 8, 2, 16, 2, 8, 2, MAX_TTL };
+
+  // remember that we have generated an LQ TC message; this is
+  // checked in net_output()
+
+  lq_tc_pending = true;
+
+  // initialize the static fields
+
+  lq_tc->comm.type = LQ_TC_MESSAGE;
+  lq_tc->comm.vtime = me_to_reltime(outif->valtimes.tc);
+  lq_tc->comm.size = 0;
+
+  lq_tc->comm.orig = olsr_cnf->main_addr;
 
-  // loop through the queued neighbour entries and free them
+  if (olsr_cnf->lq_fish > 0) {
+    if (outif->ttl_index >= (int)(sizeof(ttl_list) / sizeof(ttl_list[0])))
+      outif->ttl_index = 0;
 
-  for (walker = lq_tc->neigh; walker != NULL; walker = aux) {
-    aux = walker->next;
-    free(walker);
+    lq_tc->comm.ttl = (0 <= outif->ttl_index ? ttl_list[outif->ttl_index] : MAX_TTL);
+    outif->ttl_index++;
+
+    OLSR_PRINTF(3, "Creating LQ TC with TTL %d.\n", lq_tc->comm.ttl);
   }
+
+  else
+    lq_tc->comm.ttl = MAX_TTL;
+
+  lq_tc->comm.hops = 0;
+
+  lq_tc->from = olsr_cnf->main_addr;
+
+  lq_tc->ansn = get_local_ansn();
+
+  // reuse the neighbour set unless it is outdated or this interface
+  // has already sent it
+
+  if (lq_tc_cache.stale || lq_tc_cache.ansn != lq_tc->ansn || outif->lq_tc_generation == lq_tc_cache.generation) {
+    lq_tc_cache_build();
+  }
+  outif->lq_tc_generation = lq_tc_cache.generation;
 }
 
 static int
@@ -517,8 +580,8 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
 {
   int off, rem, size, expected_size = 0;
   struct lq_tc_header *head;
-  struct tc_mpr_addr *neigh;
-  unsigned char *buff;
+  unsigned char *buff, *rec;
+  uint32_t i;
 
   union olsr_ip_addr *last_ip = NULL;
   uint8_t left_border_flag = 0xff;
@@ -556,18 +619,18 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
    * in unstable links. The ugly lq/genmsg code should be reworked anyhow.
    */
   if (0 < net_output_pending(outif)) {
-    for (neigh = lq_tc->neigh; neigh != NULL; neigh = neigh->next) {
-      expected_size += olsr_cnf->ipsize + olsr_sizeof_tc_lqdata();
-    }
+    expected_size = lq_tc_cache.count * (olsr_cnf->ipsize + olsr_sizeof_tc_lqdata());
   }
 
   if (rem < expected_size) {
     net_output(outif);
     rem = net_outbuffer_bytes_left(outif) - off;
   }
-  // loop through neighbors
+  // loop through the serialized neighbors
+
+  for (i = 0; i < lq_tc_cache.count; i++) {
+    rec = lq_tc_cache.payload + lq_tc_cache.offset[i];
 
-  for (neigh = lq_tc->neigh; neigh != NULL; neigh = neigh->next) {
     // we need space for an IP address plus link quality
     // information
 
@@ -575,7 +638,7 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
     if ((int)(size + olsr_cnf->ipsize + olsr_sizeof_tc_lqdata()) > rem) {
       head->lower_border = left_border_flag;
       assert(last_ip);
-      head->upper_border = calculate_border_flag(last_ip, &neigh->address);
+      head->upper_border = calculate_border_flag(last_ip, rec);
       left_border_flag = head->upper_border;
 
       // finalize the OLSR header
@@ -595,16 +658,13 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface_olsr *outif)
       size = 0;
       rem = net_outbuffer_bytes_left(outif) - off;
     }
-    // add the current neighbor's IP address
-    genipcopy(buff + size, &neigh->address);
+    // add the current neighbor's IP address and link quality
+    memcpy(buff + size, rec, lq_tc_cache.offset[i + 1] - lq_tc_cache.offset[i]);
 
     // remember last ip
     last_ip = (union olsr_ip_addr *)ARM_NOWARN_ALIGN(buff + size);
 
-    size += olsr_cnf->ipsize;
-
-    // add the corresponding link quality
-    size += olsr_serialize_tc_lq_pair(&buff[size], neigh);
+    size += lq_tc_cache.offset[i + 1] - lq_tc_cache.offset[i];
   }
 
   // finalize the OLSR header
@@ -656,13 +716,13 @@ olsr_output_lq_tc(void *para)
   if (outif == NULL) {
     return;
   }
-  // create LQ_TC in internal format
+  // create LQ_TC in internal format, the neighbors are kept in the cache
 
   create_lq_tc(&lq_tc, outif);
 
   // a) the message is not empty
 
-  if (lq_tc.neigh != NULL) {
+  if (lq_tc_cache.count > 0) {
     prev_empty = 0;
 
     // convert internal format into transmission format, send it
@@ -684,9 +744,6 @@ olsr_output_lq_tc(void *para)
   } else if (!TIMED_OUT(get_empty_tc_timer())) {
     serialize_lq_tc(&lq_tc, outif);
   }
-  // destroy internal format
-
-  destroy_lq_tc(&lq_tc);
 
   if (net_output_pending(outif)) {
     if (!outif->immediate_send_tc) {
@@ -121,7 +121,6 @@ struct lq_tc_message {
   struct olsr_common comm;
   union olsr_ip_addr from;
   uint16_t ansn;
-  struct tc_mpr_addr *neigh;
 };
 
 /* serialized LQ_TC */
@@ -281,6 +280,8 @@ void olsr_output_lq_hello(void *para);
 
 void olsr_output_lq_tc(void *para);
 
+void olsr_lq_tc_invalidate(void);
+
 void olsr_input_lq_hello(union olsr_message *ser, struct interface_olsr *inif, union olsr_ip_addr *from);
 
 extern bool lq_tc_pending;
@@ -47,6 +47,7 @@
 #include "olsr.h"
 #include "two_hop_neighbor_table.h"
 #include "common/avl.h"
+#include "fpm.h"
 
 #include "lq_plugin_default_float.h"
 #include "lq_plugin_default_fpm.h"
@@ -59,6 +60,31 @@
 
 #include <assert.h>
 
+#if defined __SSE2__
+#include <emmintrin.h>
+#elif defined __ARM_NEON && defined __aarch64__
+#include <arm_neon.h>
+#endif
+
+/*
+ * LQ_STATIC_<handler> (set by "make LQ_STATIC=<handler>") lets the hot
+ * wrappers below call the inline functions of that handler directly while it
+ * is the active one; any other handler still goes through active_lq_handler.
+ */
+#if defined LQ_STATIC_FF
+#define LQ_STATIC_HANDLER lq_etx_ff_handler
+#define LQ_STATIC_FUNC(func) default_lq_##func##_ff
+#elif defined LQ_STATIC_FFETH
+#define LQ_STATIC_HANDLER lq_etx_ffeth_handler
+#define LQ_STATIC_FUNC(func) default_lq_##func##_ffeth
+#elif defined LQ_STATIC_FLOAT
+#define LQ_STATIC_HANDLER lq_etx_float_handler
+#define LQ_STATIC_FUNC(func) default_lq_##func##_float
+#elif defined LQ_STATIC_FPM
+#define LQ_STATIC_HANDLER lq_etx_fpm_handler
+#define LQ_STATIC_FUNC(func) default_lq_##func##_fpm
+#endif
+
 struct avl_tree lq_handler_tree;
 struct lq_handler *active_lq_handler = NULL;
 
@@ -156,9 +182,105 @@ olsr_linkcost
 olsr_calc_tc_cost(const struct tc_edge_entry * tc_edge)
 {
   assert((const char *)tc_edge + sizeof(*tc_edge) >= (const char *)tc_edge->linkquality);
+#ifdef LQ_STATIC_HANDLER
+  if (active_lq_handler == &LQ_STATIC_HANDLER) {
+    return LQ_STATIC_FUNC(calc_cost)(tc_edge->linkquality);
+  }
+#endif
   return active_lq_handler->calc_tc_cost(tc_edge->linkquality);
 }
 
+/**
+ * olsr_calc_tc_costs
+ *
+ * this function calculates the linkcosts of count tc lq values in one
+ * pass, with the batch function of the lq handler if it has one
+ *
+ * @param cost array to store the count linkcosts in
+ * @param lq array of pointers to the tc lq values
+ * @param count number of lq values
+ */
+void
+olsr_calc_tc_costs(olsr_linkcost *cost, const void *const *lq, unsigned int count)
+{
+  unsigned int i;
+
+  if (active_lq_handler->calc_tc_costs) {
+    active_lq_handler->calc_tc_costs(cost, lq, count);
+    return;
+  }
+  for (i = 0; i < count; i++) {
+    cost[i] = active_lq_handler->calc_tc_cost(lq[i]);
+  }
+}
+
+/**
+ * olsr_calc_etx_costs
+ *
+ * this function calculates the etx linkcosts of the 8 bit lq handlers
+ * (etx_ff, etx_ffeth) in place. On input each cost holds the product of
+ * LQ and NLQ scaled to 0..255, 0 for a broken link. The result is the same
+ * as fpmidiv(itofpm(255 * 255), product) limited to 1..LINK_COST_BROKEN.
+ *
+ * The division is done in double precision, which is exact for these
+ * operands, two lanes at a time with SSE2 or NEON if available.
+ *
+ * @param cost array of products, overwritten with the linkcosts
+ * @param count number of products
+ */
+void
+olsr_calc_etx_costs(olsr_linkcost *cost, unsigned int count)
+{
+  unsigned int i = 0;
+  olsr_linkcost c;
+
+#if defined __SSE2__
+  const __m128d dividend = _mm_set1_pd(255.0 * 255.0 * FPM_NUM);
+  const __m128d lower = _mm_set1_pd(1.0);
+  const __m128d upper = _mm_set1_pd(LINK_COST_BROKEN);
+
+  /* a product of 0 divides to infinity, which ends up as LINK_COST_BROKEN */
+  for (; i + 4 <= count; i += 4) {
+    __m128i product = _mm_loadu_si128((const __m128i *)&cost[i]);
+    __m128d lo = _mm_div_pd(dividend, _mm_cvtepi32_pd(product));
+    __m128d hi = _mm_div_pd(dividend, _mm_cvtepi32_pd(_mm_shuffle_epi32(product, _MM_SHUFFLE(3, 2, 3, 2))));
+
+    lo = _mm_max_pd(_mm_min_pd(lo, upper), lower);
+    hi = _mm_max_pd(_mm_min_pd(hi, upper), lower);
+    _mm_storeu_si128((__m128i *)&cost[i], _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+  }
+#elif defined __ARM_NEON && defined __aarch64__
+  const float64x2_t dividend = vdupq_n_f64(255.0 * 255.0 * FPM_NUM);
+  const float64x2_t lower = vdupq_n_f64(1.0);
+  const float64x2_t upper = vdupq_n_f64(LINK_COST_BROKEN);
+
+  /* a product of 0 divides to infinity, which ends up as LINK_COST_BROKEN */
+  for (; i + 4 <= count; i += 4) {
+    uint32x4_t product = vld1q_u32(&cost[i]);
+    float64x2_t lo = vdivq_f64(dividend, vcvtq_f64_u64(vmovl_u32(vget_low_u32(product))));
+    float64x2_t hi = vdivq_f64(dividend, vcvtq_f64_u64(vmovl_u32(vget_high_u32(product))));
+
+    lo = vmaxq_f64(vminq_f64(lo, upper), lower);
+    hi = vmaxq_f64(vminq_f64(hi, upper), lower);
+    vst1q_u32(&cost[i], vcombine_u32(vmovn_u64(vcvtq_u64_f64(lo)), vmovn_u64(vcvtq_u64_f64(hi))));
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (cost[i] == 0) {
+      cost[i] = LINK_COST_BROKEN;
+      continue;
+    }
+    c = fpmidiv(itofpm(255 * 255), cost[i]);
+    if (c > LINK_COST_BROKEN) {
+      c = LINK_COST_BROKEN;
+    } else if (c == 0) {
+      c = 1;
+    }
+    cost[i] = c;
+  }
+}
+
 /**
  * olsr_serialize_hello_lq_pair
  *
@@ -173,6 +295,11 @@ int
 olsr_serialize_hello_lq_pair(unsigned char *buff, struct lq_hello_neighbor *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
+#ifdef LQ_STATIC_HANDLER
+  if (active_lq_handler == &LQ_STATIC_HANDLER) {
+    return LQ_STATIC_FUNC(serialize_hello_lq_pair)(buff, neigh->linkquality);
+  }
+#endif
   return active_lq_handler->serialize_hello_lq(buff, neigh->linkquality);
 }
 
@@ -189,6 +316,13 @@ void
 olsr_deserialize_hello_lq_pair(const uint8_t ** curr, struct hello_neighbor *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
+#ifdef LQ_STATIC_HANDLER
+  if (active_lq_handler == &LQ_STATIC_HANDLER) {
+    LQ_STATIC_FUNC(deserialize_hello_lq_pair)(curr, neigh->linkquality);
+    neigh->cost = LQ_STATIC_FUNC(calc_cost)(neigh->linkquality);
+    return;
+  }
+#endif
   active_lq_handler->deserialize_hello_lq(curr, neigh->linkquality);
   neigh->cost = active_lq_handler->calc_hello_cost(neigh->linkquality);
 }
@@ -207,6 +341,11 @@ int
 olsr_serialize_tc_lq_pair(unsigned char *buff, struct tc_mpr_addr *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
+#ifdef LQ_STATIC_HANDLER
+  if (active_lq_handler == &LQ_STATIC_HANDLER) {
+    return LQ_STATIC_FUNC(serialize_tc_lq_pair)(buff, neigh->linkquality);
+  }
+#endif
   return active_lq_handler->serialize_tc_lq(buff, neigh->linkquality);
 }
 
@@ -222,6 +361,12 @@ void
 olsr_deserialize_tc_lq_pair(const uint8_t ** curr, struct tc_edge_entry *edge)
 {
   assert((const char *)edge + sizeof(*edge) >= (const char *)edge->linkquality);
+#ifdef LQ_STATIC_HANDLER
+  if (active_lq_handler == &LQ_STATIC_HANDLER) {
+    LQ_STATIC_FUNC(deserialize_tc_lq_pair)(curr, edge->linkquality);
+    return;
+  }
+#endif
   active_lq_handler->deserialize_tc_lq(curr, edge->linkquality);
 }
 
@@ -445,21 +590,68 @@ olsr_malloc_tc_mpr_addr(const char *id)
 }
 
 /**
- * olsr_malloc_lq_hello_neighbor
+ * olsr_arena_hello_neighbor
+ *
+ * this function allocates memory for an hello_neighbor inclusive
+ * linkquality data from an arena.
+ *
+ * @param arena arena the memory is taken from
+ * @param id string for memory debugging
+ *
+ * @return pointer to hello_neighbor
+ */
+struct hello_neighbor *
+olsr_arena_hello_neighbor(struct arena *arena, const char *id)
+{
+  struct hello_neighbor *h;
+
+  h = olsr_arena_malloc(arena, sizeof(struct hello_neighbor) + active_lq_handler->hello_lq_size, id);
+
+  assert((const char *)h + sizeof(*h) >= (const char *)h->linkquality);
+  active_lq_handler->clear_hello(h->linkquality);
+  return h;
+}
+
+/**
+ * olsr_arena_tc_mpr_addr
+ *
+ * this function allocates memory for an tc_mpr_addr inclusive
+ * linkquality data from an arena.
+ *
+ * @param arena arena the memory is taken from
+ * @param id string for memory debugging
+ *
+ * @return pointer to tc_mpr_addr
+ */
+struct tc_mpr_addr *
+olsr_arena_tc_mpr_addr(struct arena *arena, const char *id)
+{
+  struct tc_mpr_addr *t;
+
+  t = olsr_arena_malloc(arena, sizeof(struct tc_mpr_addr) + active_lq_handler->tc_lq_size, id);
+
+  assert((const char *)t + sizeof(*t) >= (const char *)t->linkquality);
+  active_lq_handler->clear_tc(t->linkquality);
+  return t;
+}
+
+/**
+ * olsr_arena_lq_hello_neighbor
  *
  * this function allocates memory for an lq_hello_neighbor inclusive
- * linkquality data.
+ * linkquality data from an arena.
  *
+ * @param arena arena the memory is taken from
  * @param id string for memory debugging
  *
  * @return pointer to lq_hello_neighbor
  */
 struct lq_hello_neighbor *
-olsr_malloc_lq_hello_neighbor(const char *id)
+olsr_arena_lq_hello_neighbor(struct arena *arena, const char *id)
 {
   struct lq_hello_neighbor *h;
 
-  h = olsr_malloc(sizeof(struct lq_hello_neighbor) + active_lq_handler->hello_lq_size, id);
+  h = olsr_arena_malloc(arena, sizeof(struct lq_hello_neighbor) + active_lq_handler->hello_lq_size, id);
 
   assert((const char *)h + sizeof(*h) >= (const char *)h->linkquality);
   active_lq_handler->clear_hello(h->linkquality);
@@ -496,6 +688,25 @@ size_t olsr_sizeof_tc_lqdata(void) {
   return active_lq_handler->tc_lqdata_size;
 }
 
+/**
+ * This function returns the number of bytes the link quality
+ * of one neighbour takes in a serialized TC.
+ */
+size_t olsr_sizeof_tc_lq_pair(void) {
+  static struct lq_handler *handler = NULL;
+  static size_t size = 0;
+
+  if (handler != active_lq_handler) {
+    unsigned char buff[MAXMESSAGESIZE];
+    struct tc_mpr_addr *neigh = olsr_malloc_tc_mpr_addr("TC LQ size");
+
+    size = olsr_serialize_tc_lq_pair(buff, neigh);
+    handler = active_lq_handler;
+    free(neigh);
+  }
+  return size;
+}
+
 /**
  * This function should be called whenever the current linkcost
  * value changed in a relevant way.
@@ -68,6 +68,8 @@ struct lq_handler {
 
   olsr_linkcost (*calc_hello_cost) (const void *lq);
   olsr_linkcost (*calc_tc_cost) (const void *lq);
+  /* optional, calculates the tc costs of count lq values in one pass */
+  void (*calc_tc_costs) (olsr_linkcost *cost, const void *const *lq, unsigned int count);
 
   void (*packet_loss_handler) (struct link_entry * entry, void *lq, bool lost);
 
@@ -115,6 +117,8 @@ void init_lq_handler_tree(void);
 void register_lq_handler(struct lq_handler *handler, const char *name);
 
 olsr_linkcost olsr_calc_tc_cost(const struct tc_edge_entry *);
+void olsr_calc_tc_costs(olsr_linkcost *cost, const void *const *lq, unsigned int count);
+void olsr_calc_etx_costs(olsr_linkcost *cost, unsigned int count);
 
 int olsr_serialize_hello_lq_pair(unsigned char *buff, struct lq_hello_neighbor *neigh);
 void olsr_deserialize_hello_lq_pair(const uint8_t ** curr, struct hello_neighbor *neigh);
@@ -136,15 +140,20 @@ void olsr_clear_tc_lq(struct tc_mpr_addr *target);
 
 struct hello_neighbor *olsr_malloc_hello_neighbor(const char *id);
 struct tc_mpr_addr *olsr_malloc_tc_mpr_addr(const char *id);
-struct lq_hello_neighbor *olsr_malloc_lq_hello_neighbor(const char *id);
 struct link_entry *olsr_malloc_link_entry(const char *id);
 
+struct hello_neighbor *olsr_arena_hello_neighbor(struct arena *arena, const char *id);
+struct tc_mpr_addr *olsr_arena_tc_mpr_addr(struct arena *arena, const char *id);
+struct lq_hello_neighbor *olsr_arena_lq_hello_neighbor(struct arena *arena, const char *id);
+
 size_t olsr_sizeof_hello_lqdata(void);
 size_t olsr_sizeof_tc_lqdata(void);
+size_t olsr_sizeof_tc_lq_pair(void);
 
 void olsr_relevant_linkcost_change(void);
 
 /* Externals. */
+extern struct avl_tree lq_handler_tree;
 extern struct lq_handler *active_lq_handler;
 
 #endif /* LQPLUGIN_H_ */
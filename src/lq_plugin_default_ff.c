@@ -56,16 +56,11 @@
 
 static void default_lq_initialize_ff(void);
 
-static olsr_linkcost default_lq_calc_cost_ff(const void *lq);
+static void default_lq_calc_costs_ff(olsr_linkcost *cost, const void *const *lq, unsigned int count);
 
 static void default_lq_packet_loss_worker_ff(struct link_entry *link, void *lq, bool lost);
 static void default_lq_memorize_foreign_hello_ff(void *local, void *foreign);
 
-static int default_lq_serialize_hello_lq_pair_ff(unsigned char *buff, void *lq);
-static void default_lq_deserialize_hello_lq_pair_ff(const uint8_t ** curr, void *lq);
-static int default_lq_serialize_tc_lq_pair_ff(unsigned char *buff, void *lq);
-static void default_lq_deserialize_tc_lq_pair_ff(const uint8_t ** curr, void *lq);
-
 static void default_lq_copy_link2neigh_ff(void *t, void *s);
 static void default_lq_copy_link2tc_ff(void *target, void *source);
 static void default_lq_clear_ff(void *target);
@@ -79,6 +74,7 @@ struct lq_handler lq_etx_ff_handler = {
   &default_lq_initialize_ff,
   &default_lq_calc_cost_ff,
   &default_lq_calc_cost_ff,
+  &default_lq_calc_costs_ff,
 
   &default_lq_packet_loss_worker_ff,
 
@@ -276,69 +272,21 @@ default_lq_initialize_ff(void)
   olsr_start_timer(1000, 0, OLSR_TIMER_PERIODIC, &default_lq_ff_timer, NULL, 0);
 }
 
-static olsr_linkcost
-default_lq_calc_cost_ff(const void *ptr)
-{
-  const struct default_lq_ff *lq = ptr;
-  olsr_linkcost cost;
-
-  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
-    return LINK_COST_BROKEN;
-  }
-
-  cost = fpmidiv(itofpm(255 * 255), (int)lq->valueLq * (int)lq->valueNlq);
-
-  if (cost > LINK_COST_BROKEN)
-    return LINK_COST_BROKEN;
-  if (cost == 0)
-    return 1;
-  return cost;
-}
-
-static int
-default_lq_serialize_hello_lq_pair_ff(unsigned char *buff, void *ptr)
-{
-  struct default_lq_ff *lq = ptr;
-
-  buff[0] = (unsigned char)lq->valueLq;
-  buff[1] = (unsigned char)lq->valueNlq;
-  buff[2] = (unsigned char)(0);
-  buff[3] = (unsigned char)(0);
-
-  return 4;
-}
-
 static void
-default_lq_deserialize_hello_lq_pair_ff(const uint8_t ** curr, void *ptr)
+default_lq_calc_costs_ff(olsr_linkcost *cost, const void *const *ptr, unsigned int count)
 {
-  struct default_lq_ff *lq = ptr;
+  unsigned int i;
 
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
-  pkt_ignore_u16(curr);
-}
-
-static int
-default_lq_serialize_tc_lq_pair_ff(unsigned char *buff, void *ptr)
-{
-  struct default_lq_ff *lq = ptr;
-
-  buff[0] = (unsigned char)lq->valueLq;
-  buff[1] = (unsigned char)lq->valueNlq;
-  buff[2] = (unsigned char)(0);
-  buff[3] = (unsigned char)(0);
-
-  return 4;
-}
+  for (i = 0; i < count; i++) {
+    const struct default_lq_ff *lq = ptr[i];
 
-static void
-default_lq_deserialize_tc_lq_pair_ff(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_ff *lq = ptr;
-
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
-  pkt_ignore_u16(curr);
+    if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
+      cost[i] = 0;
+    } else {
+      cost[i] = (olsr_linkcost)lq->valueLq * lq->valueNlq;
+    }
+  }
+  olsr_calc_etx_costs(cost, count);
 }
 
 static void
@@ -44,6 +44,7 @@
 
 #include "olsr_types.h"
 #include "lq_plugin.h"
+#include "fpm.h"
 
 #define LQ_PLUGIN_LC_MULTIPLIER 1024
 #define LQ_PLUGIN_RELEVANT_COSTCHANGE_FF 16
@@ -69,6 +70,71 @@ struct default_lq_ff_hello {
 
 extern struct lq_handler lq_etx_ff_handler;
 
+static INLINE olsr_linkcost
+default_lq_calc_cost_ff(const void *ptr)
+{
+  const struct default_lq_ff *lq = ptr;
+  olsr_linkcost cost;
+
+  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
+    return LINK_COST_BROKEN;
+  }
+
+  cost = fpmidiv(itofpm(255 * 255), (int)lq->valueLq * (int)lq->valueNlq);
+
+  if (cost > LINK_COST_BROKEN)
+    return LINK_COST_BROKEN;
+  if (cost == 0)
+    return 1;
+  return cost;
+}
+
+static INLINE int
+default_lq_serialize_hello_lq_pair_ff(unsigned char *buff, void *ptr)
+{
+  struct default_lq_ff *lq = ptr;
+
+  buff[0] = (unsigned char)lq->valueLq;
+  buff[1] = (unsigned char)lq->valueNlq;
+  buff[2] = (unsigned char)(0);
+  buff[3] = (unsigned char)(0);
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_hello_lq_pair_ff(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_ff *lq = ptr;
+
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+  pkt_ignore_u16(curr);
+}
+
+static INLINE int
+default_lq_serialize_tc_lq_pair_ff(unsigned char *buff, void *ptr)
+{
+  struct default_lq_ff *lq = ptr;
+
+  buff[0] = (unsigned char)lq->valueLq;
+  buff[1] = (unsigned char)lq->valueNlq;
+  buff[2] = (unsigned char)(0);
+  buff[3] = (unsigned char)(0);
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_tc_lq_pair_ff(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_ff *lq = ptr;
+
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+  pkt_ignore_u16(curr);
+}
+
 #endif /* LQ_ETX_FF_ */
 
 /*
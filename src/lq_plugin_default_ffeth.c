@@ -58,16 +58,11 @@
 
 static void default_lq_initialize_ffeth(void);
 
-static olsr_linkcost default_lq_calc_cost_ffeth(const void *lq);
+static void default_lq_calc_costs_ffeth(olsr_linkcost *cost, const void *const *lq, unsigned int count);
 
 static void default_lq_packet_loss_worker_ffeth(struct link_entry *link, void *lq, bool lost);
 static void default_lq_memorize_foreign_hello_ffeth(void *local, void *foreign);
 
-static int default_lq_serialize_hello_lq_pair_ffeth(unsigned char *buff, void *lq);
-static void default_lq_deserialize_hello_lq_pair_ffeth(const uint8_t ** curr, void *lq);
-static int default_lq_serialize_tc_lq_pair_ffeth(unsigned char *buff, void *lq);
-static void default_lq_deserialize_tc_lq_pair_ffeth(const uint8_t ** curr, void *lq);
-
 static void default_lq_copy_link2neigh_ffeth(void *t, void *s);
 static void default_lq_copy_link2tc_ffeth(void *target, void *source);
 static void default_lq_clear_ffeth(void *target);
@@ -81,6 +76,7 @@ struct lq_handler lq_etx_ffeth_handler = {
   &default_lq_initialize_ffeth,
   &default_lq_calc_cost_ffeth,
   &default_lq_calc_cost_ffeth,
+  &default_lq_calc_costs_ffeth,
 
   &default_lq_packet_loss_worker_ffeth,
 
@@ -298,86 +294,27 @@ default_lq_initialize_ffeth(void)
   olsr_start_timer(1000, 0, OLSR_TIMER_PERIODIC, &default_lq_ffeth_timer, NULL, 0);
 }
 
-static olsr_linkcost
-default_lq_calc_cost_ffeth(const void *ptr)
-{
-  const struct default_lq_ffeth *lq = ptr;
-  olsr_linkcost cost;
-  bool ether;
-  int lq_int, nlq_int;
-
-  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
-    return LINK_COST_BROKEN;
-  }
-
-  ether = lq->valueLq == 255 && lq->valueNlq == 255;
-
-  lq_int = (int)lq->valueLq;
-  if (lq_int > 0 && lq_int < 255) {
-    lq_int++;
-  }
-
-  nlq_int = (int)lq->valueNlq;
-  if (nlq_int > 0 && nlq_int < 255) {
-    nlq_int++;
-  }
-  cost = fpmidiv(itofpm(255 * 255), lq_int * nlq_int);
-  if (ether) {
-    /* ethernet boost */
-    cost /= 10;
-  }
-
-  if (cost > LINK_COST_BROKEN)
-    return LINK_COST_BROKEN;
-  if (cost == 0)
-    return 1;
-  return cost;
-}
-
-static int
-default_lq_serialize_hello_lq_pair_ffeth(unsigned char *buff, void *ptr)
-{
-  struct default_lq_ffeth *lq = ptr;
-
-  buff[0] = (unsigned char)(0);
-  buff[1] = (unsigned char)(0);
-  buff[2] = (unsigned char)lq->valueLq;
-  buff[3] = (unsigned char)lq->valueNlq;
-
-  return 4;
-}
-
 static void
-default_lq_deserialize_hello_lq_pair_ffeth(const uint8_t ** curr, void *ptr)
+default_lq_calc_costs_ffeth(olsr_linkcost *cost, const void *const *ptr, unsigned int count)
 {
-  struct default_lq_ffeth *lq = ptr;
+  unsigned int i;
 
-  pkt_ignore_u16(curr);
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
-}
+  for (i = 0; i < count; i++) {
+    const struct default_lq_ffeth *lq = ptr[i];
+    olsr_linkcost lq_int, nlq_int;
 
-static int
-default_lq_serialize_tc_lq_pair_ffeth(unsigned char *buff, void *ptr)
-{
-  struct default_lq_ffeth *lq = ptr;
+    if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
+      cost[i] = 0;
+      continue;
+    }
 
-  buff[0] = (unsigned char)(0);
-  buff[1] = (unsigned char)(0);
-  buff[2] = (unsigned char)lq->valueLq;
-  buff[3] = (unsigned char)lq->valueNlq;
+    lq_int = lq->valueLq < 255 ? lq->valueLq + 1 : 255;
+    nlq_int = lq->valueNlq < 255 ? lq->valueNlq + 1 : 255;
 
-  return 4;
-}
-
-static void
-default_lq_deserialize_tc_lq_pair_ffeth(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_ffeth *lq = ptr;
-
-  pkt_ignore_u16(curr);
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
+    /* ethernet boost, dividing by the larger product is the same as dividing the cost */
+    cost[i] = lq_int * nlq_int * (lq->valueLq == 255 && lq->valueNlq == 255 ? 10 : 1);
+  }
+  olsr_calc_etx_costs(cost, count);
 }
 
 static void
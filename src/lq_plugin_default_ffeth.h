@@ -44,6 +44,7 @@
 
 #include "olsr_types.h"
 #include "lq_plugin.h"
+#include "fpm.h"
 
 #define LQ_ALGORITHM_ETX_FFETH_NAME "etx_ffeth"
 
@@ -67,6 +68,88 @@ struct default_lq_ffeth_hello {
 
 extern struct lq_handler lq_etx_ffeth_handler;
 
+static INLINE olsr_linkcost
+default_lq_calc_cost_ffeth(const void *ptr)
+{
+  const struct default_lq_ffeth *lq = ptr;
+  olsr_linkcost cost;
+  bool ether;
+  int lq_int, nlq_int;
+
+  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
+    return LINK_COST_BROKEN;
+  }
+
+  ether = lq->valueLq == 255 && lq->valueNlq == 255;
+
+  lq_int = (int)lq->valueLq;
+  if (lq_int > 0 && lq_int < 255) {
+    lq_int++;
+  }
+
+  nlq_int = (int)lq->valueNlq;
+  if (nlq_int > 0 && nlq_int < 255) {
+    nlq_int++;
+  }
+  cost = fpmidiv(itofpm(255 * 255), lq_int * nlq_int);
+  if (ether) {
+    /* ethernet boost */
+    cost /= 10;
+  }
+
+  if (cost > LINK_COST_BROKEN)
+    return LINK_COST_BROKEN;
+  if (cost == 0)
+    return 1;
+  return cost;
+}
+
+static INLINE int
+default_lq_serialize_hello_lq_pair_ffeth(unsigned char *buff, void *ptr)
+{
+  struct default_lq_ffeth *lq = ptr;
+
+  buff[0] = (unsigned char)(0);
+  buff[1] = (unsigned char)(0);
+  buff[2] = (unsigned char)lq->valueLq;
+  buff[3] = (unsigned char)lq->valueNlq;
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_hello_lq_pair_ffeth(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_ffeth *lq = ptr;
+
+  pkt_ignore_u16(curr);
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+}
+
+static INLINE int
+default_lq_serialize_tc_lq_pair_ffeth(unsigned char *buff, void *ptr)
+{
+  struct default_lq_ffeth *lq = ptr;
+
+  buff[0] = (unsigned char)(0);
+  buff[1] = (unsigned char)(0);
+  buff[2] = (unsigned char)lq->valueLq;
+  buff[3] = (unsigned char)lq->valueNlq;
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_tc_lq_pair_ffeth(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_ffeth *lq = ptr;
+
+  pkt_ignore_u16(curr);
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+}
+
 #endif /* LQ_ETX_FFETH_ */
 
 /*
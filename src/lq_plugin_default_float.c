@@ -48,13 +48,8 @@
 #include "lq_plugin_default_float.h"
 
 static void default_lq_initialize_float(void);
-static olsr_linkcost default_lq_calc_cost_float(const void *lq);
 static void default_lq_packet_loss_worker_float(struct link_entry *link, void *lq, bool lost);
 static void default_lq_memorize_foreign_hello_float(void *local, void *foreign);
-static int default_lq_serialize_hello_lq_pair_float(unsigned char *buff, void *lq);
-static void default_lq_deserialize_hello_lq_pair_float(const uint8_t ** curr, void *lq);
-static int default_lq_serialize_tc_lq_pair_float(unsigned char *buff, void *lq);
-static void default_lq_deserialize_tc_lq_pair_float(const uint8_t ** curr, void *lq);
 static void default_lq_copy_link2tc_float(void *target, void *source);
 static void default_lq_clear_float(void *target);
 static const char *default_lq_print_float(void *ptr, char separator, struct lqtextbuffer *buffer);
@@ -67,6 +62,7 @@ struct lq_handler lq_etx_float_handler = {
 
   &default_lq_calc_cost_float,
   &default_lq_calc_cost_float,
+  NULL,
 
   &default_lq_packet_loss_worker_float,
   &default_lq_memorize_foreign_hello_float,
@@ -96,80 +92,6 @@ default_lq_initialize_float(void)
   return;
 }
 
-static olsr_linkcost
-default_lq_calc_cost_float(const void *ptr)
-{
-  const struct default_lq_float *lq = ptr;
-  olsr_linkcost cost;
-
-  if (lq->lq < (float)MINIMAL_USEFUL_LQ || lq->nlq < (float)MINIMAL_USEFUL_LQ) {
-    return LINK_COST_BROKEN;
-  }
-
-  cost = (olsr_linkcost) (1.0f / (lq->lq * lq->nlq) * (float)LQ_PLUGIN_LC_MULTIPLIER);
-
-  if (cost > LINK_COST_BROKEN)
-    return LINK_COST_BROKEN;
-  if (cost == 0) {
-    return 1;
-  }
-  return cost;
-}
-
-static int
-default_lq_serialize_hello_lq_pair_float(unsigned char *buff, void *ptr)
-{
-  struct default_lq_float *lq = ptr;
-
-  buff[0] = (unsigned char)(lq->lq * 255);
-  buff[1] = (unsigned char)(lq->nlq * 255);
-  buff[2] = 0;
-  buff[3] = 0;
-
-  return 4;
-}
-
-static void
-default_lq_deserialize_hello_lq_pair_float(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_float *lq = ptr;
-  uint8_t lq_value, nlq_value;
-
-  pkt_get_u8(curr, &lq_value);
-  pkt_get_u8(curr, &nlq_value);
-  pkt_ignore_u16(curr);
-
-  lq->lq = (float)lq_value / 255.0f;
-  lq->nlq = (float)nlq_value / 255.0f;
-}
-
-static int
-default_lq_serialize_tc_lq_pair_float(unsigned char *buff, void *ptr)
-{
-  struct default_lq_float *lq = ptr;
-
-  buff[0] = (unsigned char)(lq->lq * 255);
-  buff[1] = (unsigned char)(lq->nlq * 255);
-  buff[2] = 0;
-  buff[3] = 0;
-
-  return 4;
-}
-
-static void
-default_lq_deserialize_tc_lq_pair_float(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_float *lq = ptr;
-  uint8_t lq_value, nlq_value;
-
-  pkt_get_u8(curr, &lq_value);
-  pkt_get_u8(curr, &nlq_value);
-  pkt_ignore_u16(curr);
-
-  lq->lq = (float)lq_value / 255.0f;
-  lq->nlq = (float)nlq_value / 255.0f;
-}
-
 static void
 default_lq_packet_loss_worker_float(struct link_entry *link, void *ptr, bool lost)
 {
@@ -56,6 +56,80 @@ struct default_lq_float {
 
 extern struct lq_handler lq_etx_float_handler;
 
+static INLINE olsr_linkcost
+default_lq_calc_cost_float(const void *ptr)
+{
+  const struct default_lq_float *lq = ptr;
+  olsr_linkcost cost;
+
+  if (lq->lq < (float)MINIMAL_USEFUL_LQ || lq->nlq < (float)MINIMAL_USEFUL_LQ) {
+    return LINK_COST_BROKEN;
+  }
+
+  cost = (olsr_linkcost) (1.0f / (lq->lq * lq->nlq) * (float)LQ_PLUGIN_LC_MULTIPLIER);
+
+  if (cost > LINK_COST_BROKEN)
+    return LINK_COST_BROKEN;
+  if (cost == 0) {
+    return 1;
+  }
+  return cost;
+}
+
+static INLINE int
+default_lq_serialize_hello_lq_pair_float(unsigned char *buff, void *ptr)
+{
+  struct default_lq_float *lq = ptr;
+
+  buff[0] = (unsigned char)(lq->lq * 255);
+  buff[1] = (unsigned char)(lq->nlq * 255);
+  buff[2] = 0;
+  buff[3] = 0;
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_hello_lq_pair_float(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_float *lq = ptr;
+  uint8_t lq_value, nlq_value;
+
+  pkt_get_u8(curr, &lq_value);
+  pkt_get_u8(curr, &nlq_value);
+  pkt_ignore_u16(curr);
+
+  lq->lq = (float)lq_value / 255.0f;
+  lq->nlq = (float)nlq_value / 255.0f;
+}
+
+static INLINE int
+default_lq_serialize_tc_lq_pair_float(unsigned char *buff, void *ptr)
+{
+  struct default_lq_float *lq = ptr;
+
+  buff[0] = (unsigned char)(lq->lq * 255);
+  buff[1] = (unsigned char)(lq->nlq * 255);
+  buff[2] = 0;
+  buff[3] = 0;
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_tc_lq_pair_float(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_float *lq = ptr;
+  uint8_t lq_value, nlq_value;
+
+  pkt_get_u8(curr, &lq_value);
+  pkt_get_u8(curr, &nlq_value);
+  pkt_ignore_u16(curr);
+
+  lq->lq = (float)lq_value / 255.0f;
+  lq->nlq = (float)nlq_value / 255.0f;
+}
+
 #endif /* LQ_PLUGIN_DEFAULT_H_ */
 
 /*
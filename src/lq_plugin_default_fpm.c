@@ -49,13 +49,8 @@
 #include "lq_plugin_default_fpm.h"
 
 static void default_lq_initialize_fpm(void);
-static olsr_linkcost default_lq_calc_cost_fpm(const void *lq);
 static void default_lq_packet_loss_worker_fpm(struct link_entry *link, void *lq, bool lost);
 static void default_lq_memorize_foreign_hello_fpm(void *local, void *foreign);
-static int default_lq_serialize_hello_lq_pair_fpm(unsigned char *buff, void *lq);
-static void default_lq_deserialize_hello_lq_pair_fpm(const uint8_t ** curr, void *lq);
-static int default_lq_serialize_tc_lq_pair_fpm(unsigned char *buff, void *lq);
-static void default_lq_deserialize_tc_lq_pair_fpm(const uint8_t ** curr, void *lq);
 static void default_lq_copy_link2tc_fpm(void *target, void *source);
 static void default_lq_clear_fpm(void *target);
 static const char *default_lq_print_fpm(void *ptr, char separator, struct lqtextbuffer *buffer);
@@ -68,6 +63,7 @@ struct lq_handler lq_etx_fpm_handler = {
 
   &default_lq_calc_cost_fpm,
   &default_lq_calc_cost_fpm,
+  NULL,
 
   &default_lq_packet_loss_worker_fpm,
   &default_lq_memorize_foreign_hello_fpm,
@@ -104,71 +100,6 @@ default_lq_initialize_fpm(void)
   aging_quickstart_old = LQ_FPM_INTERNAL_MULTIPLIER - aging_quickstart_new;
 }
 
-static olsr_linkcost
-default_lq_calc_cost_fpm(const void *ptr)
-{
-  const struct default_lq_fpm *lq = ptr;
-  olsr_linkcost cost;
-
-  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
-    return LINK_COST_BROKEN;
-  }
-
-  cost = LQ_FPM_LINKCOST_MULTIPLIER * 255 / (int)lq->valueLq * 255 / (int)lq->valueNlq;
-
-  if (cost > LINK_COST_BROKEN)
-    return LINK_COST_BROKEN;
-  if (cost == 0)
-    return 1;
-  return cost;
-}
-
-static int
-default_lq_serialize_hello_lq_pair_fpm(unsigned char *buff, void *ptr)
-{
-  struct default_lq_fpm *lq = ptr;
-
-  buff[0] = (unsigned char)lq->valueLq;
-  buff[1] = (unsigned char)lq->valueNlq;
-  buff[2] = (unsigned char)(0);
-  buff[3] = (unsigned char)(0);
-
-  return 4;
-}
-
-static void
-default_lq_deserialize_hello_lq_pair_fpm(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_fpm *lq = ptr;
-
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
-  pkt_ignore_u16(curr);
-}
-
-static int
-default_lq_serialize_tc_lq_pair_fpm(unsigned char *buff, void *ptr)
-{
-  struct default_lq_fpm *lq = ptr;
-
-  buff[0] = (unsigned char)lq->valueLq;
-  buff[1] = (unsigned char)lq->valueNlq;
-  buff[2] = (unsigned char)(0);
-  buff[3] = (unsigned char)(0);
-
-  return 4;
-}
-
-static void
-default_lq_deserialize_tc_lq_pair_fpm(const uint8_t ** curr, void *ptr)
-{
-  struct default_lq_fpm *lq = ptr;
-
-  pkt_get_u8(curr, &lq->valueLq);
-  pkt_get_u8(curr, &lq->valueNlq);
-  pkt_ignore_u16(curr);
-}
-
 static void
 default_lq_packet_loss_worker_fpm(struct link_entry *link __attribute__ ((unused)), void *ptr, bool lost)
 {
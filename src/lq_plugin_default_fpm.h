@@ -60,6 +60,71 @@ struct default_lq_fpm {
 
 extern struct lq_handler lq_etx_fpm_handler;
 
+static INLINE olsr_linkcost
+default_lq_calc_cost_fpm(const void *ptr)
+{
+  const struct default_lq_fpm *lq = ptr;
+  olsr_linkcost cost;
+
+  if (lq->valueLq < (unsigned int)(255 * MINIMAL_USEFUL_LQ) || lq->valueNlq < (unsigned int)(255 * MINIMAL_USEFUL_LQ)) {
+    return LINK_COST_BROKEN;
+  }
+
+  cost = LQ_FPM_LINKCOST_MULTIPLIER * 255 / (int)lq->valueLq * 255 / (int)lq->valueNlq;
+
+  if (cost > LINK_COST_BROKEN)
+    return LINK_COST_BROKEN;
+  if (cost == 0)
+    return 1;
+  return cost;
+}
+
+static INLINE int
+default_lq_serialize_hello_lq_pair_fpm(unsigned char *buff, void *ptr)
+{
+  struct default_lq_fpm *lq = ptr;
+
+  buff[0] = (unsigned char)lq->valueLq;
+  buff[1] = (unsigned char)lq->valueNlq;
+  buff[2] = (unsigned char)(0);
+  buff[3] = (unsigned char)(0);
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_hello_lq_pair_fpm(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_fpm *lq = ptr;
+
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+  pkt_ignore_u16(curr);
+}
+
+static INLINE int
+default_lq_serialize_tc_lq_pair_fpm(unsigned char *buff, void *ptr)
+{
+  struct default_lq_fpm *lq = ptr;
+
+  buff[0] = (unsigned char)lq->valueLq;
+  buff[1] = (unsigned char)lq->valueNlq;
+  buff[2] = (unsigned char)(0);
+  buff[3] = (unsigned char)(0);
+
+  return 4;
+}
+
+static INLINE void
+default_lq_deserialize_tc_lq_pair_fpm(const uint8_t ** curr, void *ptr)
+{
+  struct default_lq_fpm *lq = ptr;
+
+  pkt_get_u8(curr, &lq->valueLq);
+  pkt_get_u8(curr, &lq->valueNlq);
+  pkt_ignore_u16(curr);
+}
+
 #endif /* LQ_ETX_FPM_ */
 
 /*
@@ -64,6 +64,7 @@
 #include "gateway.h"
 #include "olsr_niit.h"
 #include "olsr_random.h"
+#include "spf_worker.h"
 
 #ifdef __linux__
 #include <linux/types.h>
@@ -759,6 +760,9 @@ void olsr_reconfigure(int signo __attribute__ ((unused))) {
 static void olsr_shutdown_messages(void) {
   struct interface_olsr *ifn;
 
+  /* we might have been interrupted while the scheduler held the output */
+  net_output_release();
+
   /* send TC reset */
   for (ifn = ifnet; ifn; ifn = ifn->int_next) {
     /* clean output buffer */
@@ -828,6 +832,9 @@ static void olsr_shutdown(int signo __attribute__ ((unused)))
   olsr_shutdown_messages();
 
   /* now try to cleanup the rest of the mess */
+#ifdef __linux__
+  olsr_spf_worker_stop();
+#endif /* __linux__ */
   olsr_delete_all_tc_entries();
 
   olsr_delete_all_mid_entries();
@@ -871,6 +878,7 @@ static void olsr_shutdown(int signo __attribute__ ((unused)))
     }
 #endif /* __linux__ */
   }
+  deinit_net();
 
   /* Closing plug-ins */
   olsr_close_plugins();
@@ -49,13 +49,14 @@
 #include "scheduler.h"
 #include "neighbor_table.h"
 #include "link_set.h"
+#include "lq_mpr.h"
 #include "tc_set.h"
 #include "packet.h"             /* struct mid_alias */
 #include "net_olsr.h"
 #include "duplicate_handler.h"
 
-struct mid_entry mid_set[HASHSIZE];
-struct mid_address reverse_mid_set[HASHSIZE];
+struct hash_table mid_set;
+struct hash_table reverse_mid_set;
 
 struct mid_entry *mid_lookup_entry_bymain(const union olsr_ip_addr *adr);
 
@@ -66,29 +67,22 @@ struct mid_entry *mid_lookup_entry_bymain(const union olsr_ip_addr *adr);
 int
 olsr_init_mid_set(void)
 {
-  int idx;
-
   OLSR_PRINTF(5, "MID: init\n");
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    mid_set[idx].next = &mid_set[idx];
-    mid_set[idx].prev = &mid_set[idx];
-
-    reverse_mid_set[idx].next = &reverse_mid_set[idx];
-    reverse_mid_set[idx].prev = &reverse_mid_set[idx];
+  if (hash_table_init(&mid_set, HASHSIZE) || hash_table_init(&reverse_mid_set, HASHSIZE)) {
+    olsr_exit(__func__, EXIT_FAILURE);
   }
 
   return 1;
 }
 
 void olsr_delete_all_mid_entries(void) {
-  int hash;
+  struct mid_entry *mid;
 
-  for (hash = 0; hash < HASHSIZE; hash++) {
-    while (mid_set[hash].next != &mid_set[hash]) {
-      olsr_delete_mid_entry(mid_set[hash].next);
-    }
+  OLSR_FOR_ALL_MID_ENTRIES(mid) {
+    olsr_delete_mid_entry(mid);
   }
+  OLSR_FOR_ALL_MID_ENTRIES_END(mid);
 }
 
 void olsr_cleanup_mid(union olsr_ip_addr *orig) {
@@ -153,17 +147,13 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
 {
   struct mid_entry *tmp;
   struct mid_address *tmp_adr;
-  uint32_t hash, alias_hash;
+  uint32_t alias_hash;
   union olsr_ip_addr *registered_m_addr;
 
-  hash = olsr_ip_hashing(m_addr);
-  alias_hash = olsr_ip_hashing(&alias->alias);
+  alias_hash = olsr_ip_hash(&alias->alias);
 
   /* Check for registered entry */
-  for (tmp = mid_set[hash].next; tmp != &mid_set[hash]; tmp = tmp->next) {
-    if (ipequal(&tmp->main_addr, m_addr))
-      break;
-  }
+  tmp = mid_lookup_entry_bymain(m_addr);
 
   /* Check if alias is already registered with m_addr */
   registered_m_addr = mid_lookup_main_addr(&alias->alias);
@@ -178,11 +168,11 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
   olsr_insert_routing_table(&alias->alias, olsr_cnf->maxplen, m_addr, OLSR_RT_ORIGIN_MID);
 
   /*If the address was registered */
-  if (tmp != &mid_set[hash]) {
+  if (tmp != NULL) {
     tmp_adr = tmp->aliases;
     tmp->aliases = alias;
     alias->main_entry = tmp;
-    QUEUE_ELEM(reverse_mid_set[alias_hash], alias);
+    hash_table_add(&reverse_mid_set, &alias->alias_hash, alias_hash);
     alias->next_alias = tmp_adr;
     olsr_set_mid_timer(tmp, vtime);
   } else {
@@ -192,12 +182,12 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
 
     tmp->aliases = alias;
     alias->main_entry = tmp;
-    QUEUE_ELEM(reverse_mid_set[alias_hash], alias);
+    hash_table_add(&reverse_mid_set, &alias->alias_hash, alias_hash);
     tmp->main_addr = *m_addr;
     olsr_set_mid_timer(tmp, vtime);
 
     /* Queue */
-    QUEUE_ELEM(mid_set[hash], tmp);
+    hash_table_add(&mid_set, &tmp->mid_hash, olsr_ip_hash(m_addr));
   }
 
   /*
@@ -235,7 +225,7 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
       replace_neighbor_link_set(tmp_neigh, real_neigh);
 
       /* Dequeue */
-      DEQUEUE_ELEM(tmp_neigh);
+      hash_table_remove(&neighbortable, &tmp_neigh->nbr_hash);
       /* Delete */
       free(tmp_neigh);
 
@@ -313,6 +303,7 @@ insert_mid_alias(union olsr_ip_addr *main_add, const union olsr_ip_addr *alias,
    */
   changes_neighborhood = true;
   changes_topology = true;
+  olsr_lq_mpr_mark_all_dirty();
 }
 
 /**
@@ -326,15 +317,18 @@ union olsr_ip_addr *
 mid_lookup_main_addr(const union olsr_ip_addr *adr)
 {
   uint32_t hash;
-  struct mid_address *tmp_list;
+  struct list_node *node;
 
-  hash = olsr_ip_hashing(adr);
+  hash = olsr_ip_hash(adr);
 
   /*Traverse MID list */
-  for (tmp_list = reverse_mid_set[hash].next; tmp_list != &reverse_mid_set[hash]; tmp_list = tmp_list->next) {
+  HASH_TABLE_FOR_EACH_HASH(&reverse_mid_set, node, hash) {
+    struct mid_address *tmp_list = list2mid_alias(node);
+
     if (ipequal(&tmp_list->alias, adr))
       return &tmp_list->main_entry->main_addr;
   }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
   return NULL;
 
 }
@@ -348,16 +342,19 @@ mid_lookup_main_addr(const union olsr_ip_addr *adr)
 struct mid_entry *
 mid_lookup_entry_bymain(const union olsr_ip_addr *adr)
 {
-  struct mid_entry *tmp_list;
+  struct list_node *node;
   uint32_t hash;
 
-  hash = olsr_ip_hashing(adr);
+  hash = olsr_ip_hash(adr);
 
   /* Check all registered nodes... */
-  for (tmp_list = mid_set[hash].next; tmp_list != &mid_set[hash]; tmp_list = tmp_list->next) {
+  HASH_TABLE_FOR_EACH_HASH(&mid_set, node, hash) {
+    struct mid_entry *tmp_list = list2mid(node);
+
     if (ipequal(&tmp_list->main_addr, adr))
       return tmp_list;
   }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
   return NULL;
 }
 
@@ -384,21 +381,17 @@ mid_lookup_aliases(const union olsr_ip_addr *adr)
 int
 olsr_update_mid_table(const union olsr_ip_addr *adr, olsr_reltime vtime)
 {
-  uint32_t hash;
   struct ipaddr_str buf;
-  struct mid_entry *tmp_list = mid_set;
+  struct mid_entry *tmp_list;
 
   OLSR_PRINTF(3, "MID: update %s\n", olsr_ip_to_string(&buf, adr));
-  hash = olsr_ip_hashing(adr);
 
-  /* Check all registered nodes... */
-  for (tmp_list = mid_set[hash].next; tmp_list != &mid_set[hash]; tmp_list = tmp_list->next) {
-    /*find match */
-    if (ipequal(&tmp_list->main_addr, adr)) {
-      olsr_set_mid_timer(tmp_list, vtime);
+  /*find match */
+  tmp_list = mid_lookup_entry_bymain(adr);
+  if (tmp_list != NULL) {
+    olsr_set_mid_timer(tmp_list, vtime);
 
-      return 1;
-    }
+    return 1;
   }
   return 0;
 }
@@ -414,19 +407,13 @@ olsr_prune_aliases(struct mid_message *message)
   const union olsr_ip_addr *m_addr = &message->mid_origaddr;
   struct mid_alias * declared_aliases = message->mid_addr;
   struct mid_entry *entry;
-  uint32_t hash;
   struct mid_address *registered_aliases;
   struct mid_address *previous_alias;
   struct mid_alias *save_declared_aliases = declared_aliases;
 
-  hash = olsr_ip_hashing(m_addr);
-
   /* Check for registered entry */
-  for (entry = mid_set[hash].next; entry != &mid_set[hash]; entry = entry->next) {
-    if (ipequal(&entry->main_addr, m_addr))
-      break;
-  }
-  if (entry == &mid_set[hash]) {
+  entry = mid_lookup_entry_bymain(m_addr);
+  if (entry == NULL) {
     /* MID entry not found, nothing to prune here */
     return;
   }
@@ -465,7 +452,7 @@ olsr_prune_aliases(struct mid_message *message)
       }
 
       /* Remove from hash table */
-      DEQUEUE_ELEM(current_alias);
+      hash_table_remove(&reverse_mid_set, &current_alias->alias_hash);
 
       /*
        * Delete the rt_path for the alias.
@@ -479,6 +466,7 @@ olsr_prune_aliases(struct mid_message *message)
        */
       changes_neighborhood = true;
       changes_topology = true;
+      olsr_lq_mpr_mark_all_dirty();
     } else {
       previous_alias = current_alias;
     }
@@ -500,7 +488,7 @@ olsr_delete_mid_entry(struct mid_entry *mid)
   while (aliases) {
     struct mid_address *tmp_aliases = aliases;
     aliases = aliases->next_alias;
-    DEQUEUE_ELEM(tmp_aliases);
+    hash_table_remove(&reverse_mid_set, &tmp_aliases->alias_hash);
 
     /*
      * Delete the rt_path for the alias.
@@ -519,8 +507,11 @@ olsr_delete_mid_entry(struct mid_entry *mid)
   }
 
   /* Dequeue */
-  DEQUEUE_ELEM(mid);
+  hash_table_remove(&mid_set, &mid->mid_hash);
   free(mid);
+
+  /* the aliases do not map to the main address anymore */
+  olsr_lq_mpr_mark_all_dirty();
 }
 
 /**
@@ -530,23 +521,21 @@ olsr_delete_mid_entry(struct mid_entry *mid)
 void
 olsr_print_mid_set(void)
 {
-  int idx;
+  struct mid_entry *tmp_list;
 
   OLSR_PRINTF(1, "\n--- %s ------------------------------------------------- MID\n\n", olsr_wallclock_string());
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    struct mid_entry *tmp_list = mid_set[idx].next;
-    /*Traverse MID list */
-    for (tmp_list = mid_set[idx].next; tmp_list != &mid_set[idx]; tmp_list = tmp_list->next) {
-      struct mid_address *tmp_addr;
-      struct ipaddr_str buf;
-      OLSR_PRINTF(1, "%s: ", olsr_ip_to_string(&buf, &tmp_list->main_addr));
-      for (tmp_addr = tmp_list->aliases; tmp_addr; tmp_addr = tmp_addr->next_alias) {
-        OLSR_PRINTF(1, " %s ", olsr_ip_to_string(&buf, &tmp_addr->alias));
-      }
-      OLSR_PRINTF(1, "\n");
+  /*Traverse MID list */
+  OLSR_FOR_ALL_MID_ENTRIES(tmp_list) {
+    struct mid_address *tmp_addr;
+    struct ipaddr_str buf;
+    OLSR_PRINTF(1, "%s: ", olsr_ip_to_string(&buf, &tmp_list->main_addr));
+    for (tmp_addr = tmp_list->aliases; tmp_addr; tmp_addr = tmp_addr->next_alias) {
+      OLSR_PRINTF(1, " %s ", olsr_ip_to_string(&buf, &tmp_addr->alias));
     }
+    OLSR_PRINTF(1, "\n");
   }
+  OLSR_FOR_ALL_MID_ENTRIES_END(tmp_list);
 }
 
 /**
@@ -46,6 +46,7 @@
 #include "hashing.h"
 #include "mantissa.h"
 #include "packet.h"
+#include "common/hash_table.h"
 
 struct mid_address {
   union olsr_ip_addr alias;
@@ -53,9 +54,8 @@ struct mid_address {
   struct mid_address *next_alias;
   uint32_t vtime;
 
-  /* These are for the reverse list */
-  struct mid_address *prev;
-  struct mid_address *next;
+  /* This is for the reverse table, hashed by alias */
+  struct hash_node alias_hash;
 };
 
 /*
@@ -64,15 +64,24 @@ struct mid_address {
 struct mid_entry {
   union olsr_ip_addr main_addr;
   struct mid_address *aliases;
-  struct mid_entry *prev;
-  struct mid_entry *next;
+  struct hash_node mid_hash;           /* hashed by main_addr */
   struct timer_entry *mid_timer;
 };
 
+LISTNODE2STRUCT(list2mid_alias, struct mid_address, alias_hash.list);
+LISTNODE2STRUCT(list2mid, struct mid_entry, mid_hash.list);
+
+#define OLSR_FOR_ALL_MID_ENTRIES(mid) \
+{ \
+  struct list_node *_mid_node; \
+  HASH_TABLE_FOR_EACH(&mid_set, _mid_node) \
+    mid = list2mid(_mid_node);
+#define OLSR_FOR_ALL_MID_ENTRIES_END(mid) HASH_TABLE_FOR_EACH_END(_mid_node) }
+
 #define OLSR_MID_JITTER 5       /* percent */
 
-extern struct mid_entry mid_set[HASHSIZE];
-extern struct mid_address reverse_mid_set[HASHSIZE];
+extern struct hash_table mid_set;
+extern struct hash_table reverse_mid_set;
 
 int olsr_init_mid_set(void);
 void olsr_delete_all_mid_entries(void);
@@ -60,7 +60,13 @@ static void olsr_clear_mprs(void);
 
 static void olsr_clear_two_hop_processed(void);
 
-static struct neighbor_entry *olsr_find_maximum_covered(int);
+static olsr_linkcost olsr_mpr_cand_key(const struct neighbor_entry *);
+
+static void olsr_mpr_cand_update(struct neighbor_entry *);
+
+static void olsr_mpr_cand_fill(int);
+
+static struct neighbor_entry *olsr_mpr_cand_extract(void);
 
 static uint16_t olsr_calculate_two_hop_neighbors(void);
 
@@ -68,69 +74,54 @@ static int olsr_check_mpr_changes(void);
 
 static int olsr_chosen_mpr(struct neighbor_entry *, uint16_t *);
 
-static struct neighbor_2_list_entry *olsr_find_2_hop_neighbors_with_1_link(int);
+static void olsr_chosen_1_link_mprs(int, uint16_t *);
 
 /* End:
  * Prototypes for internal functions
  */
 
+/*
+ * Neighbors which are MPR candidates for the willingness
+ * currently processed, best coverage first.
+ */
+static struct array_heap mpr_cand;
+
 /**
- *Find all 2 hop neighbors with 1 link
- *connecting them to us trough neighbors
- *with a given willingness.
+ *Choose all neighbors with a given willingness which
+ *are the only link to one of our 2 hop neighbors
  *
  *@param willingness the willigness of the neighbors
- *
- *@return a linked list of allocated neighbor_2_list_entry structures
+ *@param two_hop_covered_count counter of covered 2 hop neighbors
  */
-static struct neighbor_2_list_entry *
-olsr_find_2_hop_neighbors_with_1_link(int willingness)
+static void
+olsr_chosen_1_link_mprs(int willingness, uint16_t * two_hop_covered_count)
 {
-
-  uint8_t idx;
-  struct neighbor_2_list_entry *two_hop_list_tmp = NULL;
-  struct neighbor_2_list_entry *two_hop_list = NULL;
   struct neighbor_entry *dup_neighbor;
+  struct neighbor_entry *a_neighbor;
   struct neighbor_2_entry *two_hop_neighbor = NULL;
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-
-    for (two_hop_neighbor = two_hop_neighbortable[idx].next; two_hop_neighbor != &two_hop_neighbortable[idx];
-         two_hop_neighbor = two_hop_neighbor->next) {
-
-      //two_hop_neighbor->neighbor_2_state=0;
-      //two_hop_neighbor->mpr_covered_count = 0;
-
-      dup_neighbor = olsr_lookup_neighbor_table(&two_hop_neighbor->neighbor_2_addr);
-
-      if ((dup_neighbor != NULL) && (dup_neighbor->status != NOT_SYM)) {
-
-        //OLSR_PRINTF(1, "(1)Skipping 2h neighbor %s - already 1hop\n", olsr_ip_to_string(&buf, &two_hop_neighbor->neighbor_2_addr));
-
-        continue;
-      }
-
-      if (two_hop_neighbor->neighbor_2_pointer == 1) {
-        if ((two_hop_neighbor->neighbor_2_nblist.next->neighbor->willingness == willingness)
-            && (two_hop_neighbor->neighbor_2_nblist.next->neighbor->status == SYM)) {
-          two_hop_list_tmp = olsr_malloc(sizeof(struct neighbor_2_list_entry), "MPR two hop list");
-
-          //OLSR_PRINTF(1, "ONE LINK ADDING %s\n", olsr_ip_to_string(&buf, &two_hop_neighbor->neighbor_2_addr));
+  OLSR_FOR_ALL_NBR2_ENTRIES(two_hop_neighbor) {
 
-          /* Only queue one way here */
-          two_hop_list_tmp->neighbor_2 = two_hop_neighbor;
-
-          two_hop_list_tmp->next = two_hop_list;
+    if (two_hop_neighbor->neighbor_2_pointer != 1) {
+      continue;
+    }
 
-          two_hop_list = two_hop_list_tmp;
-        }
-      }
+    dup_neighbor = olsr_lookup_neighbor_table(&two_hop_neighbor->neighbor_2_addr);
 
+    if ((dup_neighbor != NULL) && (dup_neighbor->status != NOT_SYM)) {
+      continue;
     }
 
+    /*
+     * Choosing a neighbor does not change the status of any
+     * other entry, so they can be chosen while walking the table.
+     */
+    a_neighbor = two_hop_neighbor->neighbor_2_nblist.next->neighbor;
+    if ((a_neighbor->willingness == willingness) && (a_neighbor->status == SYM) && !a_neighbor->is_mpr) {
+      olsr_chosen_mpr(a_neighbor, two_hop_covered_count);
+    }
   }
-
-  return (two_hop_list_tmp);
+  OLSR_FOR_ALL_NBR2_ENTRIES_END(two_hop_neighbor);
 }
 
 /**
@@ -180,6 +171,7 @@ olsr_chosen_mpr(struct neighbor_entry *one_hop_neighbor, uint16_t * two_hop_cove
       if ((the_one_hop_list->neighbor->status == SYM)) {
         if (second_hop_entries->neighbor_2->mpr_covered_count >= olsr_cnf->mpr_coverage) {
           the_one_hop_list->neighbor->neighbor_2_nocov--;
+          olsr_mpr_cand_update(the_one_hop_list->neighbor);
         }
       }
       the_one_hop_list = the_one_hop_list->next;
@@ -196,37 +188,82 @@ olsr_chosen_mpr(struct neighbor_entry *one_hop_neighbor, uint16_t * two_hop_cove
 }
 
 /**
- *Find the neighbor that covers the most 2 hop neighbors
- *with a given willingness
+ *Heap key of a MPR candidate. The candidate heap is a min heap,
+ *so more uncovered 2 hop neighbors give a smaller key. Ties are
+ *broken by the position in the neighbor table walk, which picks
+ *the same neighbor as a linear scan of the table.
  *
- *@param willingness the willingness of the neighbor
+ *@param a_neighbor the candidate
  *
- *@return a pointer to the neighbor_entry struct
+ *@return the key of the candidate
  */
-static struct neighbor_entry *
-olsr_find_maximum_covered(int willingness)
+static olsr_linkcost
+olsr_mpr_cand_key(const struct neighbor_entry *a_neighbor)
 {
-  uint16_t maximum;
-  struct neighbor_entry *a_neighbor;
-  struct neighbor_entry *mpr_candidate = NULL;
+  int nocov = a_neighbor->neighbor_2_nocov;
+
+  if (nocov < 0) {
+    nocov = 0;
+  } else if (nocov > 0xffff) {
+    nocov = 0xffff;
+  }
+  return ((olsr_linkcost) (0xffff - nocov) << 16) | a_neighbor->mpr_order;
+}
 
-  maximum = 0;
+/**
+ *Move a candidate down in the heap after its number
+ *of uncovered 2 hop neighbors dropped
+ *
+ *@param a_neighbor the neighbor
+ */
+static void
+olsr_mpr_cand_update(struct neighbor_entry *a_neighbor)
+{
+  if (array_heap_is_node_added(&a_neighbor->mpr_cand_node)) {
+    a_neighbor->mpr_cand_node.key = olsr_mpr_cand_key(a_neighbor);
+    array_heap_increase_key(&mpr_cand, &a_neighbor->mpr_cand_node);
+  }
+}
 
-  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+/**
+ *Put all neighbors with a given willingness which are not
+ *MPR yet and cover at least one 2 hop neighbor on the heap
+ *
+ *@param willingness the willingness of the neighbors
+ */
+static void
+olsr_mpr_cand_fill(int willingness)
+{
+  struct neighbor_entry *a_neighbor;
 
-#if 0
-    printf("[%s] nocov: %d mpr: %d will: %d max: %d\n\n", olsr_ip_to_string(&buf, &a_neighbor->neighbor_main_addr),
-           a_neighbor->neighbor_2_nocov, a_neighbor->is_mpr, a_neighbor->willingness, maximum);
-#endif /* 0 */
+  array_heap_clear(&mpr_cand);
 
-    if ((!a_neighbor->is_mpr) && (a_neighbor->willingness == willingness) && (maximum < a_neighbor->neighbor_2_nocov)) {
+  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+    if ((!a_neighbor->is_mpr) && (a_neighbor->willingness == willingness) && (a_neighbor->neighbor_2_nocov > 0)) {
+      a_neighbor->mpr_cand_node.key = olsr_mpr_cand_key(a_neighbor);
 
-      maximum = a_neighbor->neighbor_2_nocov;
-      mpr_candidate = a_neighbor;
+      /* cannot fail, the heap is sized to the neighbor table */
+      array_heap_insert(&mpr_cand, &a_neighbor->mpr_cand_node);
     }
   }
   OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
+}
 
+/**
+ *Take the candidate that covers the most 2 hop neighbors
+ *from the heap
+ *
+ *@return a pointer to the neighbor_entry struct, NULL if
+ *no candidate covers any 2 hop neighbor anymore
+ */
+static struct neighbor_entry *
+olsr_mpr_cand_extract(void)
+{
+  struct neighbor_entry *mpr_candidate = mpr_cand2nbr(array_heap_extract_min(&mpr_cand));
+
+  if (mpr_candidate == NULL || mpr_candidate->neighbor_2_nocov <= 0) {
+    return NULL;
+  }
   return mpr_candidate;
 }
 
@@ -292,15 +329,13 @@ olsr_check_mpr_changes(void)
 static void
 olsr_clear_two_hop_processed(void)
 {
-  int idx;
+  struct neighbor_2_entry *neighbor_2;
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    struct neighbor_2_entry *neighbor_2;
-    for (neighbor_2 = two_hop_neighbortable[idx].next; neighbor_2 != &two_hop_neighbortable[idx]; neighbor_2 = neighbor_2->next) {
-      /* Clear */
-      neighbor_2->processed = 0;
-    }
+  OLSR_FOR_ALL_NBR2_ENTRIES(neighbor_2) {
+    /* Clear */
+    neighbor_2->processed = 0;
   }
+  OLSR_FOR_ALL_NBR2_ENTRIES_END(neighbor_2);
 
 }
 
@@ -315,12 +350,18 @@ olsr_calculate_two_hop_neighbors(void)
   uint16_t count = 0;
   uint16_t n_count = 0;
   uint16_t sum = 0;
+  uint16_t order = 0;
 
   /* Clear 2 hop neighs */
   olsr_clear_two_hop_processed();
 
   OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
 
+    a_neighbor->mpr_order = order;
+    if (order < 0xffff) {
+      order++;
+    }
+
     if (a_neighbor->status == NOT_SYM) {
       a_neighbor->neighbor_2_nocov = count;
       continue;
@@ -395,6 +436,11 @@ olsr_calculate_mpr(void)
 
   OLSR_PRINTF(3, "\n**RECALCULATING MPR**\n\n");
 
+  if (array_heap_init(&mpr_cand, 0, neighbortable.count + 1)) {
+    OLSR_PRINTF(1, "MPR: out of memory for %u candidates\n", neighbortable.count + 1);
+    olsr_exit(__func__, EXIT_FAILURE);
+  }
+
   olsr_clear_mprs();
   two_hop_count = olsr_calculate_two_hop_neighbors();
   two_hop_covered_count = add_will_always_nodes();
@@ -405,17 +451,8 @@ olsr_calculate_mpr(void)
 
   for (i = WILL_ALWAYS - 1; i > WILL_NEVER; i--) {
     struct neighbor_entry *mprs;
-    struct neighbor_2_list_entry *two_hop_list = olsr_find_2_hop_neighbors_with_1_link(i);
-
-    while (two_hop_list != NULL) {
-      struct neighbor_2_list_entry *tmp;
-      //printf("CHOSEN FROM 1 LINK\n");
-      if (!two_hop_list->neighbor_2->neighbor_2_nblist.next->neighbor->is_mpr)
-        olsr_chosen_mpr(two_hop_list->neighbor_2->neighbor_2_nblist.next->neighbor, &two_hop_covered_count);
-      tmp = two_hop_list;
-      two_hop_list = two_hop_list->next;;
-      free(tmp);
-    }
+
+    olsr_chosen_1_link_mprs(i, &two_hop_covered_count);
 
     if (two_hop_covered_count >= two_hop_count) {
       i = WILL_NEVER;
@@ -423,7 +460,8 @@ olsr_calculate_mpr(void)
     }
     //printf("two hop covered count: %d\n", two_hop_covered_count);
 
-    while ((mprs = olsr_find_maximum_covered(i)) != NULL) {
+    olsr_mpr_cand_fill(i);
+    while ((mprs = olsr_mpr_cand_extract()) != NULL) {
       //printf("CHOSEN FROM MAXCOV\n");
       olsr_chosen_mpr(mprs, &two_hop_covered_count);
 
@@ -435,6 +473,9 @@ olsr_calculate_mpr(void)
     }
   }
 
+  array_heap_clear(&mpr_cand);
+  array_heap_free(&mpr_cand);
+
   /*
      increment the mpr sequence number
    */
@@ -44,6 +44,7 @@
 #include "two_hop_neighbor_table.h"
 #include "mid_set.h"
 #include "mpr.h"
+#include "lq_mpr.h"
 #include "neighbor_table.h"
 #include "olsr.h"
 #include "scheduler.h"
@@ -51,16 +52,13 @@
 #include "mpr_selector_set.h"
 #include "net_olsr.h"
 
-struct neighbor_entry neighbortable[HASHSIZE];
+struct hash_table neighbortable;
 
 void
 olsr_init_neighbor_table(void)
 {
-  int i;
-
-  for (i = 0; i < HASHSIZE; i++) {
-    neighbortable[i].next = &neighbortable[i];
-    neighbortable[i].prev = &neighbortable[i];
+  if (hash_table_init(&neighbortable, HASHSIZE)) {
+    olsr_exit(__func__, EXIT_FAILURE);
   }
 }
 
@@ -75,7 +73,8 @@ olsr_del_nbr2_list(struct neighbor_2_list_entry *nbr2_list)
   nbr2 = nbr2_list->neighbor_2;
 
   if (nbr2->neighbor_2_pointer < 1) {
-    DEQUEUE_ELEM(nbr2);
+    olsr_lq_mpr_forget(nbr2);
+    hash_table_remove(&two_hop_neighbortable, &nbr2->nbr2_hash);
     free(nbr2);
   }
 
@@ -153,13 +152,16 @@ void
 olsr_update_neighbor_main_addr(struct neighbor_entry *entry, const union olsr_ip_addr *new_main_addr)
 {
   /*remove from old pos*/
-  DEQUEUE_ELEM(entry);
+  hash_table_remove(&neighbortable, &entry->nbr_hash);
 
   /*update main addr*/
   entry->neighbor_main_addr = *new_main_addr;
 
+  /* the 2 hop neighbors do not know about the new address */
+  olsr_lq_mpr_mark_all_dirty();
+
   /*insert it again*/
-  QUEUE_ELEM(neighbortable[olsr_ip_hashing(new_main_addr)], entry);
+  hash_table_add(&neighbortable, &entry->nbr_hash, olsr_ip_hash(new_main_addr));
 
 }
 
@@ -177,26 +179,15 @@ int
 olsr_delete_neighbor_table(const union olsr_ip_addr *neighbor_addr)
 {
   struct neighbor_2_list_entry *two_hop_list, *two_hop_to_delete;
-  uint32_t hash;
   struct neighbor_entry *entry;
 
   //printf("inserting neighbor\n");
 
-  hash = olsr_ip_hashing(neighbor_addr);
-
-  entry = neighbortable[hash].next;
-
   /*
    * Find neighbor entry
    */
-  while (entry != &neighbortable[hash]) {
-    if (ipequal(&entry->neighbor_main_addr, neighbor_addr))
-      break;
-
-    entry = entry->next;
-  }
-
-  if (entry == &neighbortable[hash])
+  entry = olsr_lookup_neighbor_table_alias(neighbor_addr);
+  if (entry == NULL)
     return 0;
 
   two_hop_list = entry->neighbor_2_list.next;
@@ -211,8 +202,10 @@ olsr_delete_neighbor_table(const union olsr_ip_addr *neighbor_addr)
     olsr_del_nbr2_list(two_hop_to_delete);
   }
 
+  olsr_lq_mpr_mark_neighbor(entry);
+
   /* Dequeue */
-  DEQUEUE_ELEM(entry);
+  hash_table_remove(&neighbortable, &entry->nbr_hash);
 
   free(entry);
 
@@ -232,17 +225,12 @@ olsr_delete_neighbor_table(const union olsr_ip_addr *neighbor_addr)
 struct neighbor_entry *
 olsr_insert_neighbor_table(const union olsr_ip_addr *main_addr)
 {
-  uint32_t hash;
   struct neighbor_entry *new_neigh;
 
-  hash = olsr_ip_hashing(main_addr);
-
   /* Check if entry exists */
-
-  for (new_neigh = neighbortable[hash].next; new_neigh != &neighbortable[hash]; new_neigh = new_neigh->next) {
-    if (ipequal(&new_neigh->neighbor_main_addr, main_addr))
-      return new_neigh;
-  }
+  new_neigh = olsr_lookup_neighbor_table_alias(main_addr);
+  if (new_neigh != NULL)
+    return new_neigh;
 
   //printf("inserting neighbor\n");
 
@@ -257,11 +245,13 @@ olsr_insert_neighbor_table(const union olsr_ip_addr *main_addr)
   new_neigh->neighbor_2_list.prev = &new_neigh->neighbor_2_list;
 
   new_neigh->linkcount = 0;
+  new_neigh->lq_mpr_count = 0;
   new_neigh->is_mpr = false;
   new_neigh->was_mpr = false;
+  array_heap_init_node(&new_neigh->mpr_cand_node);
 
   /* Queue */
-  QUEUE_ELEM(neighbortable[hash], new_neigh);
+  hash_table_add(&neighbortable, &new_neigh->nbr_hash, olsr_ip_hash(main_addr));
 
   return new_neigh;
 }
@@ -297,16 +287,19 @@ olsr_lookup_neighbor_table(const union olsr_ip_addr *dst)
 struct neighbor_entry *
 olsr_lookup_neighbor_table_alias(const union olsr_ip_addr *dst)
 {
-  struct neighbor_entry *entry;
-  uint32_t hash = olsr_ip_hashing(dst);
+  struct list_node *node;
+  uint32_t hash = olsr_ip_hash(dst);
 
   //printf("\nLookup %s\n", olsr_ip_to_string(&buf, dst));
-  for (entry = neighbortable[hash].next; entry != &neighbortable[hash]; entry = entry->next) {
+  HASH_TABLE_FOR_EACH_HASH(&neighbortable, node, hash) {
+    struct neighbor_entry *entry = list2nbr(node);
+
     //printf("Checking %s\n", olsr_ip_to_string(&buf, &entry->neighbor_main_addr));
     if (ipequal(&entry->neighbor_main_addr, dst))
       return entry;
 
   }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
   //printf("NOPE\n\n");
 
   return NULL;
@@ -332,6 +325,7 @@ update_neighbor_status(struct neighbor_entry *entry, int lnk)
 
       changes_neighborhood = true;
       changes_topology = true;
+      olsr_lq_mpr_mark_neighbor(entry);
       if (olsr_cnf->tc_redundancy > 1)
         signal_link_changes(true);
     }
@@ -340,6 +334,7 @@ update_neighbor_status(struct neighbor_entry *entry, int lnk)
     if (entry->status == SYM) {
       changes_neighborhood = true;
       changes_topology = true;
+      olsr_lq_mpr_mark_neighbor(entry);
       if (olsr_cnf->tc_redundancy > 1)
         signal_link_changes(true);
     }
@@ -385,32 +380,30 @@ olsr_print_neighbor_table(void)
 {
   /* The whole function doesn't do anything else. */
   const int iplen = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
-  int idx;
+  struct neighbor_entry *neigh;
 
   OLSR_PRINTF(1,
               "\n--- %s ------------------------------------------------ NEIGHBORS\n\n"
               "%*s\tHyst\tLQ\tETX\tSYM   MPR   MPRS  will\n", olsr_wallclock_string(),
               iplen, "IP address");
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    struct neighbor_entry *neigh;
-    for (neigh = neighbortable[idx].next; neigh != &neighbortable[idx]; neigh = neigh->next) {
-      struct link_entry *lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
-      if (lnk) {
-        struct ipaddr_str buf;
-        struct lqtextbuffer lqbuffer1, lqbuffer2;
-
-        OLSR_PRINTF(1, "%-*s\t%5.3f\t%s\t%s\t%s  %s  %s  %d\n", iplen, olsr_ip_to_string(&buf, &neigh->neighbor_main_addr),
-                    (double)lnk->L_link_quality,
-                    get_link_entry_text(lnk, '/', &lqbuffer1),
-                    get_linkcost_text(lnk->linkcost,false, &lqbuffer2),
-                    neigh->status == SYM ? "YES " : "NO  ",
-                    neigh->is_mpr ? "YES " : "NO  ",
-                    olsr_lookup_mprs_set(&neigh->neighbor_main_addr) == NULL ? "NO  " : "YES ",
-                    neigh->willingness);
-      }
+  OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
+    struct link_entry *lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
+    if (lnk) {
+      struct ipaddr_str buf;
+      struct lqtextbuffer lqbuffer1, lqbuffer2;
+
+      OLSR_PRINTF(1, "%-*s\t%5.3f\t%s\t%s\t%s  %s  %s  %d\n", iplen, olsr_ip_to_string(&buf, &neigh->neighbor_main_addr),
+                  (double)lnk->L_link_quality,
+                  get_link_entry_text(lnk, '/', &lqbuffer1),
+                  get_linkcost_text(lnk->linkcost,false, &lqbuffer2),
+                  neigh->status == SYM ? "YES " : "NO  ",
+                  neigh->is_mpr ? "YES " : "NO  ",
+                  olsr_lookup_mprs_set(&neigh->neighbor_main_addr) == NULL ? "NO  " : "YES ",
+                  neigh->willingness);
     }
   }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
 }
 #endif /* NODEBUG */
 
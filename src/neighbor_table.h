@@ -44,6 +44,8 @@
 
 #include "olsr_types.h"
 #include "hashing.h"
+#include "common/hash_table.h"
+#include "common/heap.h"
 
 struct neighbor_2_list_entry {
   struct neighbor_entry *nbr2_nbr;     /* backpointer to owning nbr entry */
@@ -64,24 +66,27 @@ struct neighbor_entry {
   bool skip;
   int neighbor_2_nocov;
   int linkcount;
+  int lq_mpr_count;                    /* 2 hop neighbors choosing this LQ-MPR */
+  uint16_t mpr_order;                  /* position in the table walk, MPR tie break */
+  struct array_heap_node mpr_cand_node; /* MPR candidate heap, keyed by neighbor_2_nocov */
   struct neighbor_2_list_entry neighbor_2_list;
-  struct neighbor_entry *next;
-  struct neighbor_entry *prev;
+  struct hash_node nbr_hash;           /* hashed by neighbor_main_addr */
 };
 
+LISTNODE2STRUCT(list2nbr, struct neighbor_entry, nbr_hash.list);
+ARRAYHEAPNODE2STRUCT(mpr_cand2nbr, struct neighbor_entry, mpr_cand_node);
+
 #define OLSR_FOR_ALL_NBR_ENTRIES(nbr) \
 { \
-  int _idx; \
-  for (_idx = 0; _idx < HASHSIZE; _idx++) { \
-    for(nbr = neighbortable[_idx].next; \
-        nbr != &neighbortable[_idx]; \
-        nbr = nbr->next)
-#define OLSR_FOR_ALL_NBR_ENTRIES_END(nbr) }}
+  struct list_node *_nbr_node; \
+  HASH_TABLE_FOR_EACH(&neighbortable, _nbr_node) \
+    nbr = list2nbr(_nbr_node);
+#define OLSR_FOR_ALL_NBR_ENTRIES_END(nbr) HASH_TABLE_FOR_EACH_END(_nbr_node) }
 
 /*
  * The neighbor table
  */
-extern struct neighbor_entry neighbortable[HASHSIZE];
+extern struct hash_table neighbortable;
 
 void olsr_init_neighbor_table(void);
 
@@ -50,6 +50,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <limits.h>
+#include <unistd.h>
 
 #ifdef _WIN32
 #define perror(x) WinSockPError(x)
@@ -70,6 +71,37 @@ struct ptf {
 
 static struct ptf *ptf_list;
 
+/*
+ * Outgoing packets collected while net_output() is held, they are
+ * sent together by net_output_release().
+ */
+#define NET_TX_QUEUE_SIZE 64
+
+struct net_tx_packet {
+  struct interface_olsr *ifp;
+  int socket;
+  uint8_t *buf;
+  int bufsize;
+  int len;
+  union {
+    struct sockaddr_in v4;
+    struct sockaddr_in6 v6;
+  } dst;
+  socklen_t dstlen;
+};
+
+static struct net_tx_packet net_tx_queue[NET_TX_QUEUE_SIZE];
+static unsigned int net_tx_count;
+static bool net_tx_hold;
+
+#ifdef __linux__
+/* socket that sends the queued packets of all interfaces, see getbatchsocket() */
+static int net_tx_socket = -1;
+static bool net_tx_socket_failed;
+#endif /* __linux__ */
+
+static void net_tx_flush(void);
+
 static struct deny_address_entry *deny_entries;
 
 static const char *const deny_ipv4_defaults[] = {
@@ -105,6 +137,20 @@ init_net(void)
   }
 }
 
+/**
+ * Close the socket used for sending the transmit queue.
+ */
+void
+deinit_net(void)
+{
+#ifdef __linux__
+  if (net_tx_socket >= 0) {
+    close(net_tx_socket);
+    net_tx_socket = -1;
+  }
+#endif /* __linux__ */
+}
+
 /**
  * Create an outputbuffer for the given interface. This
  * function will allocate the needed storage according
@@ -155,6 +201,9 @@ net_remove_buffer(struct interface_olsr *ifp)
   if (ifp->netbuf.pending)
     net_output(ifp);
 
+  /* the socket of the interface is closed after this */
+  net_tx_flush();
+
   free(ifp->netbuf.buff);
   ifp->netbuf.buff = NULL;
 
@@ -323,7 +372,155 @@ del_ptf(packet_transform_function f)
 }
 
 /**
- *Sends a packet on a given interface.
+ * Report a failed send of a packet.
+ */
+static void
+net_output_error(const struct interface_olsr *ifp, const struct sockaddr *dst, int len)
+{
+  if (olsr_cnf->ip_version == AF_INET) {
+    perror("sendto(v4)");
+#ifndef _WIN32
+    olsr_syslog(OLSR_LOG_ERR, "OLSR: sendto IPv4 %m");
+#endif /* _WIN32 */
+  } else {
+    struct ipaddr_str buf;
+    perror("sendto(v6)");
+#ifndef _WIN32
+    olsr_syslog(OLSR_LOG_ERR, "OLSR: sendto IPv6 %m");
+#endif /* _WIN32 */
+    fprintf(stderr, "Socket: %d interface: %d\n", ifp->olsr_socket, ifp->if_index);
+    fprintf(stderr, "To: %s (size: %u)\n", ip6_to_string(&buf, &((const struct sockaddr_in6 *)dst)->sin6_addr),
+            (unsigned int)sizeof(struct sockaddr_in6));
+    fprintf(stderr, "Outputsize: %d\n", len);
+  }
+}
+
+/**
+ * Append a finished packet to the transmit queue.
+ * Sends the queue first if it is full.
+ */
+static void
+net_tx_queue_packet(struct interface_olsr *ifp, const struct sockaddr *dst, socklen_t dstlen)
+{
+  struct net_tx_packet *pkt;
+
+  if (net_tx_count == NET_TX_QUEUE_SIZE) {
+    net_tx_flush();
+  }
+
+  pkt = &net_tx_queue[net_tx_count++];
+  if (pkt->bufsize < ifp->netbuf.pending) {
+    free(pkt->buf);
+    pkt->buf = olsr_malloc(ifp->netbuf.bufsize, "tx queue buffer");
+    pkt->bufsize = ifp->netbuf.bufsize;
+  }
+
+  memcpy(pkt->buf, ifp->netbuf.buff, ifp->netbuf.pending);
+  pkt->len = ifp->netbuf.pending;
+  pkt->ifp = ifp;
+  pkt->socket = ifp->send_socket;
+  memcpy(&pkt->dst, dst, dstlen);
+  pkt->dstlen = dstlen;
+}
+
+#ifdef __linux__
+/**
+ * Open the batch send socket on first use.
+ *
+ * @return true if the socket can be used
+ */
+static bool
+net_tx_open_socket(void)
+{
+  if (net_tx_socket < 0 && !net_tx_socket_failed) {
+    net_tx_socket = getbatchsocket();
+    if (net_tx_socket < 0) {
+      OLSR_PRINTF(1, "Warning, batch send socket could not be initialized, sending on the interface sockets.\n");
+      net_tx_socket_failed = true;
+    }
+  }
+  return net_tx_socket >= 0;
+}
+#endif /* __linux__ */
+
+/**
+ * Send all packets of the transmit queue. On Linux all queued
+ * packets go out through the batch socket with a single sendmmsg(2)
+ * call, each one tagged with the index and address of its interface.
+ */
+static void
+net_tx_flush(void)
+{
+  unsigned int i;
+
+#ifdef __linux__
+  if (net_tx_count > 0 && net_tx_open_socket()) {
+    struct olsr_send_packet batch[NET_TX_QUEUE_SIZE];
+    unsigned int sent = 0;
+
+    for (i = 0; i < net_tx_count; i++) {
+      struct net_tx_packet *pkt = &net_tx_queue[i];
+
+      batch[i].buf = pkt->buf;
+      batch[i].len = pkt->len;
+      batch[i].to = (struct sockaddr *)&pkt->dst;
+      batch[i].tolen = pkt->dstlen;
+      batch[i].if_index = pkt->ifp->if_index;
+      batch[i].from = pkt->ifp->ip_addr;
+    }
+
+    while (sent < net_tx_count) {
+      int n = olsr_sendto_batch(net_tx_socket, &batch[sent], net_tx_count - sent, MSG_DONTROUTE);
+
+      if (n <= 0) {
+        /* skip the packet that failed */
+        struct net_tx_packet *pkt = &net_tx_queue[sent];
+        net_output_error(pkt->ifp, (struct sockaddr *)&pkt->dst, pkt->len);
+        n = 1;
+      }
+      sent += n;
+    }
+    net_tx_count = 0;
+    return;
+  }
+#endif /* __linux__ */
+
+  for (i = 0; i < net_tx_count; i++) {
+    struct net_tx_packet *pkt = &net_tx_queue[i];
+
+    if (olsr_sendto(pkt->socket, pkt->buf, pkt->len, MSG_DONTROUTE, (struct sockaddr *)&pkt->dst, pkt->dstlen) < 0) {
+      net_output_error(pkt->ifp, (struct sockaddr *)&pkt->dst, pkt->len);
+    }
+  }
+  net_tx_count = 0;
+}
+
+/**
+ * Collect the packets of all following net_output() calls in the
+ * transmit queue instead of sending them right away. The scheduler
+ * holds the output while it runs the timers of a tick, so the
+ * packets generated for all interfaces are sent in one go.
+ */
+void
+net_output_hold(void)
+{
+  net_tx_hold = true;
+}
+
+/**
+ * Send all packets collected since net_output_hold() and go back
+ * to sending packets immediately.
+ */
+void
+net_output_release(void)
+{
+  net_tx_hold = false;
+  net_tx_flush();
+}
+
+/**
+ *Sends a packet on a given interface. While the output is held
+ *the finished packet is only queued, see net_output_hold().
  *
  *@param ifp the interface to send on.
  *
@@ -332,9 +529,9 @@ del_ptf(packet_transform_function f)
 int
 net_output(struct interface_olsr *ifp)
 {
-  struct sockaddr_in *sin = NULL;
-  struct sockaddr_in6 *sin6 = NULL;
-  struct sockaddr_in dst;
+  struct sockaddr *dst;
+  socklen_t dstlen;
+  struct sockaddr_in dst4;
   struct sockaddr_in6 dst6;
   struct ptf *tmp_ptf_list;
   union olsr_packet *outmsg;
@@ -355,20 +552,21 @@ net_output(struct interface_olsr *ifp)
 
   if (olsr_cnf->ip_version == AF_INET) {
     /* IP version 4 */
-    sin = (struct sockaddr_in *)&ifp->int_broadaddr;
-
     /* Copy sin */
-    dst = *sin;
-    sin = &dst;
+    dst4 = *(struct sockaddr_in *)&ifp->int_broadaddr;
+
+    if (dst4.sin_port == 0)
+      dst4.sin_port = htons(olsr_cnf->olsrport);
 
-    if (sin->sin_port == 0)
-      sin->sin_port = htons(olsr_cnf->olsrport);
+    dst = (struct sockaddr *)&dst4;
+    dstlen = sizeof(dst4);
   } else {
     /* IP version 6 */
-    sin6 = (struct sockaddr_in6 *)&ifp->int6_multaddr;
     /* Copy sin */
-    dst6 = *sin6;
-    sin6 = &dst6;
+    dst6 = *(struct sockaddr_in6 *)&ifp->int6_multaddr;
+
+    dst = (struct sockaddr *)&dst6;
+    dstlen = sizeof(dst6);
   }
 
   /*
@@ -378,30 +576,11 @@ net_output(struct interface_olsr *ifp)
     tmp_ptf_list->function(ifp->netbuf.buff, &ifp->netbuf.pending);
   }
 
-  if (olsr_cnf->ip_version == AF_INET) {
-    /* IP version 4 */
-    if (olsr_sendto(ifp->send_socket, ifp->netbuf.buff, ifp->netbuf.pending, MSG_DONTROUTE, (struct sockaddr *)sin, sizeof(*sin)) <
-        0) {
-      perror("sendto(v4)");
-#ifndef _WIN32
-      olsr_syslog(OLSR_LOG_ERR, "OLSR: sendto IPv4 %m");
-#endif /* _WIN32 */
-      retval = -1;
-    }
-  } else {
-    /* IP version 6 */
-    if (olsr_sendto(ifp->send_socket, ifp->netbuf.buff, ifp->netbuf.pending, MSG_DONTROUTE, (struct sockaddr *)sin6, sizeof(*sin6))
-        < 0) {
-      struct ipaddr_str buf;
-      perror("sendto(v6)");
-#ifndef _WIN32
-      olsr_syslog(OLSR_LOG_ERR, "OLSR: sendto IPv6 %m");
-#endif /* _WIN32 */
-      fprintf(stderr, "Socket: %d interface: %d\n", ifp->olsr_socket, ifp->if_index);
-      fprintf(stderr, "To: %s (size: %u)\n", ip6_to_string(&buf, &sin6->sin6_addr), (unsigned int)sizeof(*sin6));
-      fprintf(stderr, "Outputsize: %d\n", ifp->netbuf.pending);
-      retval = -1;
-    }
+  if (net_tx_hold) {
+    net_tx_queue_packet(ifp, dst, dstlen);
+  } else if (olsr_sendto(ifp->send_socket, ifp->netbuf.buff, ifp->netbuf.pending, MSG_DONTROUTE, dst, dstlen) < 0) {
+    net_output_error(ifp, dst, ifp->netbuf.pending);
+    retval = -1;
   }
 
   ifp->netbuf.pending = 0;
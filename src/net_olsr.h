@@ -53,6 +53,8 @@ typedef int (*packet_transform_function) (uint8_t *, int *);
 
 void init_net(void);
 
+void deinit_net(void);
+
 int net_add_buffer(struct interface_olsr *);
 
 int net_remove_buffer(struct interface_olsr *);
@@ -69,6 +71,10 @@ int net_outbuffer_push_reserved(struct interface_olsr *, const void *, const uin
 
 int net_output(struct interface_olsr *);
 
+void net_output_hold(void);
+
+void net_output_release(void);
+
 int net_sendroute(struct rt_entry *, struct sockaddr *);
 
 int add_ptf(packet_transform_function);
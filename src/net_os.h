@@ -57,6 +57,37 @@ ssize_t olsr_sendto(int, const void *, size_t, int, const struct sockaddr *, soc
 
 ssize_t olsr_recvfrom(int, void *, size_t, int, struct sockaddr *, socklen_t *);
 
+#ifdef __linux__
+/* maximum number of datagrams read by one olsr_recvfrom_batch() call */
+#define OLSR_RECV_BATCH_MAX 64
+
+/* one datagram of a batched receive */
+struct olsr_recv_packet {
+  void *buf;                           /* set by the caller */
+  size_t buflen;                       /* set by the caller */
+  struct sockaddr_storage from;
+  socklen_t fromlen;
+  size_t len;
+};
+
+int olsr_recvfrom_batch(int, struct olsr_recv_packet *, unsigned int);
+
+/* maximum number of datagrams sent by one olsr_sendto_batch() call */
+#define OLSR_SEND_BATCH_MAX 64
+
+/* one datagram of a batched send */
+struct olsr_send_packet {
+  void *buf;
+  size_t len;
+  struct sockaddr *to;
+  socklen_t tolen;
+  int if_index;                        /* outgoing interface, 0 to let the socket choose */
+  union olsr_ip_addr from;             /* source address, used together with if_index */
+};
+
+int olsr_sendto_batch(int, const struct olsr_send_packet *, unsigned int, int);
+#endif /* __linux__ */
+
 int olsr_select(int, fd_set *, fd_set *, fd_set *, struct timeval *);
 
 int bind_socket_to_device(int, char *);
@@ -73,6 +104,10 @@ int getsocket(int, struct interface_olsr *);
 
 int getsocket6(int, struct interface_olsr *);
 
+#ifdef __linux__
+int getbatchsocket(void);
+#endif /* __linux__ */
+
 int get_ipv6_address(char *, struct sockaddr_in6 *, struct olsr_ip_prefix *);
 
 int calculate_if_metric(char *);
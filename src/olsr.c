@@ -200,6 +200,8 @@ olsr_process_changes(void)
   }
 
   if (changes_neighborhood) {
+    olsr_lq_tc_invalidate();
+
     if (olsr_cnf->lq_level < 1) {
       olsr_calculate_mpr();
     } else {
@@ -231,6 +233,7 @@ olsr_process_changes(void)
     olsr_print_two_hop_neighbor_table();
     if (olsr_cnf->debug_level > 3) {
       olsr_print_tc_table();
+      olsr_print_cookie_slabs();
     }
   }
 
@@ -265,6 +268,9 @@ olsr_init_tables(void)
     avl_comp_prefix_default = avl_comp_ipv6_prefix;
   }
 
+  /* Set the address hash function */
+  olsr_init_hashing();
+
   /* Initialize lq plugin set */
   init_lq_handler_tree();
 
@@ -599,6 +605,36 @@ olsr_malloc(size_t size, const char *id)
   return ptr;
 }
 
+/**
+ * Wrapper for arena_alloc() that does error-checking
+ *
+ * @param arena the arena to allocate from
+ * @param size the number of bytes to allocate
+ * @param id a string identifying the caller for
+ * use in error messaging
+ *
+ * @return a void pointer to the memory allocated
+ */
+void *
+olsr_arena_malloc(struct arena *arena, size_t size, const char *id)
+{
+  void *ptr;
+
+  ptr = arena_alloc(arena, size);
+
+  if (!ptr) {
+    const char *const err_msg = strerror(errno);
+    OLSR_PRINTF(1, "OUT OF MEMORY: %s\n", err_msg);
+    olsr_syslog(OLSR_LOG_ERR, "olsrd: out of memory!: %s\n", err_msg);
+    olsr_exit(id, EXIT_FAILURE);
+  }
+
+  /* clean it like olsr_malloc() does */
+  memset(ptr, 0, size);
+
+  return ptr;
+}
+
 /**
  *Wrapper for printf that prints to a specific
  *debuglevel upper limit
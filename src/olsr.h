@@ -44,6 +44,7 @@
 
 #include "olsr_protocol.h"
 #include "interfaces.h"
+#include "common/arena.h"
 
 extern bool changes_topology;
 extern bool changes_neighborhood;
@@ -87,6 +88,8 @@ void olsr_exit(const char *, int) __attribute__((noreturn));
 
 void *olsr_malloc(size_t, const char *);
 
+void *olsr_arena_malloc(struct arena *, size_t, const char *);
+
 int olsr_printf(int, const char *, ...) __attribute__ ((format(printf, 2, 3)));
 
 void olsr_trigger_forced_update(void *);
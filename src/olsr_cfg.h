@@ -60,6 +60,7 @@
 #define DEF_IP_VERSION       AF_INET
 #define DEF_POLLRATE         0.05
 #define DEF_NICCHGPOLLRT     2.5
+#define DEF_INPUT_BATCH_LIMIT 32
 #define DEF_WILL_AUTO        false
 #define DEF_WILLINGNESS      3
 #define DEF_ALLOW_NO_INTS    true
@@ -76,6 +77,12 @@
 #define DEF_LQ_AGING         0.05
 #define DEF_CLEAR_SCREEN     true
 #define DEF_DIJKSTRA_BINARY_HEAP true
+#define DEF_DIJKSTRA_ARRAY_HEAP false
+#define DEF_DIJKSTRA_HEAP_ARITY 2
+#define DEF_DIJKSTRA_RADIX_HEAP false
+#define DEF_DIJKSTRA_INCREMENTAL false
+#define DEF_DIJKSTRA_SNAPSHOT false
+#define DEF_DIJKSTRA_THREAD false
 #define DEF_OLSRPORT         698
 #define DEF_RTPROTO          0 /* 0 means OS-specific default */
 #define DEF_RT_NONE          -1
@@ -123,6 +130,8 @@
 #define DEF_UPLINK_SPEED     128
 #define DEF_DOWNLINK_SPEED   1024
 #define DEF_USE_SRCIP_ROUTES false
+#define DEF_NETLINK_BATCH false
+#define DEF_MEMORY_SLABS false
 
 #define DEF_IF_MODE          IF_MODE_MESH
 
@@ -134,6 +143,8 @@
 #define MIN_POLLRATE         0.01
 #define MAX_NICCHGPOLLRT     100.0
 #define MIN_NICCHGPOLLRT     1.0
+#define MAX_INPUT_BATCH_LIMIT 1024
+#define MIN_INPUT_BATCH_LIMIT 1
 #define MAX_DEBUGLVL         9
 #define MIN_DEBUGLVL         0
 #define MAX_TOS              252
@@ -142,6 +153,8 @@
 #define MIN_WILLINGNESS      0
 #define MAX_MPR_COVERAGE     20
 #define MIN_MPR_COVERAGE     1
+#define MAX_DIJKSTRA_HEAP_ARITY 16
+#define MIN_DIJKSTRA_HEAP_ARITY 2
 #define MAX_TC_REDUNDANCY    2
 #define MIN_TC_REDUNDANCY    0
 #define MAX_HYST_PARAM       1.0
@@ -299,8 +312,15 @@ struct olsrd_config {
   struct olsr_if *interfaces;
   float pollrate;
   float nic_chgs_pollrate;
+  uint16_t input_batch_limit;
   bool clear_screen;
   bool dijkstra_binary_heap;
+  bool dijkstra_array_heap;
+  uint8_t dijkstra_heap_arity;
+  bool dijkstra_radix_heap;
+  bool dijkstra_incremental;
+  bool dijkstra_snapshot;
+  bool dijkstra_thread;
   uint8_t tc_redundancy;
   uint8_t mpr_coverage;
   uint8_t lq_level;
@@ -341,6 +361,8 @@ struct olsrd_config {
   /* Main address of this node */
   union olsr_ip_addr main_addr, unicast_src_ip;
   bool use_src_ip_routes;
+  bool nl_batch;
+  bool memory_slabs;
 
   /* Stuff set by olsrd */
   uint8_t maxplen;                     /* maximum prefix len */
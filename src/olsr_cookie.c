@@ -42,12 +42,29 @@
 #include "defs.h"
 #include "olsr_cookie.h"
 #include "log.h"
+#include "scheduler.h"
 
 #include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 /* Root directory of the cookies we have in the system */
 static struct olsr_cookie_info *cookies[COOKIE_ID_MAX] = { 0 };
 
+/* Alignment of the blocks inside a slab */
+#define COOKIE_SLAB_ALIGN 8
+#define COOKIE_SLAB_ROUNDUP(x) (((x) + COOKIE_SLAB_ALIGN - 1) & ~((size_t)COOKIE_SLAB_ALIGN - 1))
+
+/* Slab blocks only carry a brand in debug builds */
+#ifdef NDEBUG
+#define COOKIE_SLAB_BRAND_SIZE 0
+#else /* NDEBUG */
+#define COOKIE_SLAB_BRAND_SIZE sizeof(struct olsr_cookie_mem_brand)
+#endif /* NDEBUG */
+
+/* Offset of the first block behind the slab header */
+#define COOKIE_SLAB_HEADER COOKIE_SLAB_ROUNDUP(sizeof(struct olsr_cookie_slab))
+
 /*
  * Allocate a cookie for the next available cookie id.
  */
@@ -75,6 +92,7 @@ olsr_alloc_cookie(const char *cookie_name, olsr_cookie_type cookie_type)
   /* Now populate the cookie info */
   ci->ci_id = ci_index;
   ci->ci_type = cookie_type;
+  ci->ci_rate_time = now_times;
   if (cookie_name) {
     ci->ci_name = strdup(cookie_name);
   }
@@ -82,6 +100,11 @@ olsr_alloc_cookie(const char *cookie_name, olsr_cookie_type cookie_type)
   /* Init the free list */
   if (cookie_type == OLSR_COOKIE_TYPE_MEMORY) {
     list_head_init(&ci->ci_free_list);
+    list_head_init(&ci->ci_slab_partial);
+    list_head_init(&ci->ci_slab_full);
+#ifndef _WIN32
+    ci->ci_slab = olsr_cnf != NULL && olsr_cnf->memory_slabs;
+#endif /* _WIN32 */
   }
 
   return ci;
@@ -110,6 +133,17 @@ olsr_free_cookie(struct olsr_cookie_info *ci)
       list_remove(memory_list);
       free(memory_list);
     }
+
+    /* Release the empty slabs, blocks still in use stay valid */
+    for (memory_list = ci->ci_slab_partial.next; memory_list != &ci->ci_slab_partial;) {
+      struct olsr_cookie_slab *slab = list2cookieslab(memory_list);
+
+      memory_list = memory_list->next;
+      if (slab->cs_used == 0) {
+        list_remove(&slab->cs_node);
+        free(slab);
+      }
+    }
   }
 
   free(ci);
@@ -146,7 +180,22 @@ olsr_cookie_set_memory_size(struct olsr_cookie_info *ci, size_t size)
   }
 
   assert(ci->ci_type == OLSR_COOKIE_TYPE_MEMORY);
+  assert(ci->ci_slab_count == 0);
   ci->ci_size = size;
+
+  if (ci->ci_slab) {
+    /* a free block stores the link to the next free block */
+    ci->ci_slab_stride = COOKIE_SLAB_ROUNDUP(size + COOKIE_SLAB_BRAND_SIZE);
+    if (ci->ci_slab_stride < sizeof(void *)) {
+      ci->ci_slab_stride = sizeof(void *);
+    }
+
+    ci->ci_slab_size = COOKIE_SLAB_SIZE;
+    while ((ci->ci_slab_size - COOKIE_SLAB_HEADER) / ci->ci_slab_stride < COOKIE_SLAB_MIN_BLOCKS) {
+      ci->ci_slab_size <<= 1;
+    }
+    ci->ci_slab_blocks = (ci->ci_slab_size - COOKIE_SLAB_HEADER) / ci->ci_slab_stride;
+  }
 }
 
 /*
@@ -168,8 +217,14 @@ void
 olsr_cookie_usage_incr(olsr_cookie_t cookie_id)
 {
   if (olsr_cookie_valid(cookie_id)) {
-    cookies[cookie_id]->ci_usage++;
-    cookies[cookie_id]->ci_changes++;
+    struct olsr_cookie_info *ci = cookies[cookie_id];
+
+    ci->ci_usage++;
+    ci->ci_changes++;
+    ci->ci_allocs++;
+    if (ci->ci_usage > ci->ci_usage_peak) {
+      ci->ci_usage_peak = ci->ci_usage;
+    }
   }
 }
 
@@ -182,9 +237,58 @@ olsr_cookie_usage_decr(olsr_cookie_t cookie_id)
   if (olsr_cookie_valid(cookie_id)) {
     cookies[cookie_id]->ci_usage--;
     cookies[cookie_id]->ci_changes++;
+    cookies[cookie_id]->ci_frees++;
   }
 }
 
+/*
+ * Fill in the statistics of a cookie.
+ * The rates are measured over intervals of COOKIE_RATE_INTERVAL, an
+ * interval is closed by the first query after it has passed. They stay
+ * zero until the first interval is closed.
+ *
+ * @return false if there is no cookie with this id
+ */
+bool
+olsr_cookie_get_stats(olsr_cookie_t cookie_id, struct olsr_cookie_stats *stats)
+{
+  struct olsr_cookie_info *ci;
+  uint32_t elapsed;
+
+  if (!olsr_cookie_valid(cookie_id)) {
+    return false;
+  }
+  ci = cookies[cookie_id];
+
+  elapsed = now_times - ci->ci_rate_time;
+  if (elapsed >= COOKIE_RATE_INTERVAL) {
+    ci->ci_alloc_rate = (uint64_t)(ci->ci_allocs - ci->ci_rate_allocs) * MSEC_PER_SEC / elapsed;
+    ci->ci_free_rate = (uint64_t)(ci->ci_frees - ci->ci_rate_frees) * MSEC_PER_SEC / elapsed;
+    ci->ci_rate_allocs = ci->ci_allocs;
+    ci->ci_rate_frees = ci->ci_frees;
+    ci->ci_rate_time = now_times;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  stats->name = ci->ci_name ? ci->ci_name : "";
+  stats->type = ci->ci_type;
+  stats->usage = ci->ci_usage;
+  stats->usage_peak = ci->ci_usage_peak;
+  stats->allocs = ci->ci_allocs;
+  stats->frees = ci->ci_frees;
+  stats->alloc_rate = ci->ci_alloc_rate;
+  stats->free_rate = ci->ci_free_rate;
+
+  if (ci->ci_type == OLSR_COOKIE_TYPE_MEMORY) {
+    stats->size = ci->ci_size;
+    stats->free_list = ci->ci_free_list_usage;
+    stats->slabs = ci->ci_slab_count;
+    stats->bytes = ci->ci_usage * ci->ci_size;
+    stats->bytes_peak = ci->ci_usage_peak * ci->ci_size;
+  }
+  return true;
+}
+
 /*
  * Return a cookie name.
  * Mostly used for logging purposes.
@@ -201,6 +305,131 @@ olsr_cookie_name(olsr_cookie_t cookie_id)
   return unknown;
 }
 
+static void
+olsr_cookie_out_of_memory(struct olsr_cookie_info *ci)
+{
+  const char *const err_msg = strerror(errno);
+  OLSR_PRINTF(1, "OUT OF MEMORY: %s\n", err_msg);
+  olsr_syslog(OLSR_LOG_ERR, "olsrd: out of memory!: %s\n", err_msg);
+  olsr_exit(ci->ci_name, EXIT_FAILURE);
+}
+
+/*
+ * Brand mark the end of the memory block with a short signature
+ * indicating presence of a cookie. This will be checked against
+ * When the block is freed to detect corruption.
+ */
+static void
+olsr_cookie_brand(struct olsr_cookie_info *ci, void *ptr)
+{
+  struct olsr_cookie_mem_brand *branding;
+
+#ifdef NDEBUG
+  if (ci->ci_slab) {
+    return;
+  }
+#endif /* NDEBUG */
+
+  branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
+  memcpy(&branding->cmb_sig[0], "cookie", 6);
+  branding->cmb_id = ci->ci_id;
+}
+
+/*
+ * Verify if there has been a memory overrun, or
+ * the wrong owner is trying to free this. Kill the brand afterwards.
+ */
+static void
+olsr_cookie_unbrand(struct olsr_cookie_info *ci, void *ptr)
+{
+  struct olsr_cookie_mem_brand *branding;
+
+#ifdef NDEBUG
+  if (ci->ci_slab) {
+    return;
+  }
+#endif /* NDEBUG */
+
+  branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
+  assert(!memcmp(&branding->cmb_sig, "cookie", 6) && branding->cmb_id == ci->ci_id);
+
+  /* Kill the brand */
+  memset(branding, 0, sizeof(*branding));
+}
+
+#ifndef _WIN32
+/*
+ * Take a block from the first slab with free blocks,
+ * allocate a new slab if there is none.
+ */
+static void *
+olsr_cookie_slab_malloc(struct olsr_cookie_info *ci)
+{
+  struct olsr_cookie_slab *slab;
+  void *ptr;
+
+  if (list_is_empty(&ci->ci_slab_partial)) {
+    void *mem;
+
+    if (posix_memalign(&mem, ci->ci_slab_size, ci->ci_slab_size)) {
+      olsr_cookie_out_of_memory(ci);
+    }
+    slab = mem;
+    memset(slab, 0, sizeof(*slab));
+    list_add_after(&ci->ci_slab_partial, &slab->cs_node);
+    ci->ci_slab_count++;
+  } else {
+    slab = list2cookieslab(ci->ci_slab_partial.next);
+  }
+
+  if (slab->cs_free != NULL) {
+    /* reuse a freed block */
+    ptr = slab->cs_free;
+    slab->cs_free = *(void **)ptr;
+  } else {
+    /* carve a block from the untouched end of the slab */
+    ptr = (unsigned char *)slab + COOKIE_SLAB_HEADER + slab->cs_carved * ci->ci_slab_stride;
+    slab->cs_carved++;
+  }
+
+  if (++slab->cs_used == ci->ci_slab_blocks) {
+    list_remove(&slab->cs_node);
+    list_add_after(&ci->ci_slab_full, &slab->cs_node);
+  }
+
+  memset(ptr, 0, ci->ci_size);
+  return ptr;
+}
+
+/*
+ * Return a block to its slab. An empty slab is released
+ * unless it is the last one with free blocks.
+ */
+static void
+olsr_cookie_slab_free(struct olsr_cookie_info *ci, void *ptr)
+{
+  struct olsr_cookie_slab *slab;
+
+  slab = (struct olsr_cookie_slab *)((uintptr_t)ptr & ~((uintptr_t)ci->ci_slab_size - 1));
+  assert(slab->cs_used > 0);
+
+  *(void **)ptr = slab->cs_free;
+  slab->cs_free = ptr;
+
+  if (slab->cs_used-- == ci->ci_slab_blocks) {
+    /* full slabs go to the front, so they fill up again first */
+    list_remove(&slab->cs_node);
+    list_add_after(&ci->ci_slab_partial, &slab->cs_node);
+  }
+
+  if (slab->cs_used == 0 && (ci->ci_slab_partial.next != &slab->cs_node || slab->cs_node.next != &ci->ci_slab_partial)) {
+    list_remove(&slab->cs_node);
+    free(slab);
+    ci->ci_slab_count--;
+  }
+}
+#endif /* _WIN32 */
+
 /*
  * Allocate a fixed amount of memory based on a passed in cookie type.
  */
@@ -208,54 +437,50 @@ void *
 olsr_cookie_malloc(struct olsr_cookie_info *ci)
 {
   void *ptr;
-  struct olsr_cookie_mem_brand *branding;
   struct list_node *free_list_node;
 
 #ifdef OLSR_COOKIE_DEBUG
   bool reuse = false;
 #endif /* OLSR_COOKIE_DEBUG */
 
-  /*
-   * Check first if we have reusable memory.
-   */
-  if (!ci->ci_free_list_usage) {
-
+#ifndef _WIN32
+  if (ci->ci_slab) {
+    ptr = olsr_cookie_slab_malloc(ci);
+  } else
+#endif /* _WIN32 */
+  {
     /*
-     * No reusable memory block on the free_list.
+     * Check first if we have reusable memory.
      */
-    ptr = calloc(1, ci->ci_size + sizeof(struct olsr_cookie_mem_brand));
-
-    if (!ptr) {
-      const char *const err_msg = strerror(errno);
-      OLSR_PRINTF(1, "OUT OF MEMORY: %s\n", err_msg);
-      olsr_syslog(OLSR_LOG_ERR, "olsrd: out of memory!: %s\n", err_msg);
-      olsr_exit(ci->ci_name, EXIT_FAILURE);
-    }
-    assert(ptr);
-  } else {
-
-    /*
-     * There is a memory block on the free list.
-     * Carve it out of the list, and clean.
-     */
-    free_list_node = ci->ci_free_list.next;
-    list_remove(free_list_node);
-    ptr = (void *)free_list_node;
-    memset(ptr, 0, ci->ci_size);
-    ci->ci_free_list_usage--;
+    if (!ci->ci_free_list_usage) {
+
+      /*
+       * No reusable memory block on the free_list.
+       */
+      ptr = calloc(1, ci->ci_size + sizeof(struct olsr_cookie_mem_brand));
+
+      if (!ptr) {
+        olsr_cookie_out_of_memory(ci);
+      }
+      assert(ptr);
+    } else {
+
+      /*
+       * There is a memory block on the free list.
+       * Carve it out of the list, and clean.
+       */
+      free_list_node = ci->ci_free_list.next;
+      list_remove(free_list_node);
+      ptr = (void *)free_list_node;
+      memset(ptr, 0, ci->ci_size);
+      ci->ci_free_list_usage--;
 #ifdef OLSR_COOKIE_DEBUG
-    reuse = true;
+      reuse = true;
 #endif /* OLSR_COOKIE_DEBUG */
+    }
   }
 
-  /*
-   * Now brand mark the end of the memory block with a short signature
-   * indicating presence of a cookie. This will be checked against
-   * When the block is freed to detect corruption.
-   */
-  branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
-  memcpy(&branding->cmb_sig[0], "cookie", 6);
-  branding->cmb_id = ci->ci_id;
+  olsr_cookie_brand(ci, ptr);
 
   /* Stats keeping */
   olsr_cookie_usage_incr(ci->ci_id);
@@ -274,44 +499,41 @@ olsr_cookie_malloc(struct olsr_cookie_info *ci)
 void
 olsr_cookie_free(struct olsr_cookie_info *ci, void *ptr)
 {
-  struct olsr_cookie_mem_brand *branding;
   struct list_node *free_list_node;
 
 #ifdef OLSR_COOKIE_DEBUG
   bool reuse = false;
 #endif /* OLSR_COOKIE_DEBUG */
 
-  branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
-
-  /*
-   * Verify if there has been a memory overrun, or
-   * the wrong owner is trying to free this.
-   */
-  assert(!memcmp(&branding->cmb_sig, "cookie", 6) && branding->cmb_id == ci->ci_id);
-
-  /* Kill the brand */
-  memset(branding, 0, sizeof(*branding));
+  olsr_cookie_unbrand(ci, ptr);
 
-  /*
-   * Rather than freeing the memory right away, try to reuse at a later
-   * point. Keep at least ten percent of the active used blocks or at least
-   * ten blocks on the free list.
-   */
-  if ((ci->ci_free_list_usage < COOKIE_FREE_LIST_THRESHOLD) || (ci->ci_free_list_usage < ci->ci_usage / COOKIE_FREE_LIST_THRESHOLD)) {
+#ifndef _WIN32
+  if (ci->ci_slab) {
+    olsr_cookie_slab_free(ci, ptr);
+  } else
+#endif /* _WIN32 */
+  {
+    /*
+     * Rather than freeing the memory right away, try to reuse at a later
+     * point. Keep at least ten percent of the active used blocks or at least
+     * ten blocks on the free list.
+     */
+    if ((ci->ci_free_list_usage < COOKIE_FREE_LIST_THRESHOLD) || (ci->ci_free_list_usage < ci->ci_usage / COOKIE_FREE_LIST_THRESHOLD)) {
 
-    free_list_node = (struct list_node *)ptr;
-    list_node_init(free_list_node);
-    list_add_before(&ci->ci_free_list, free_list_node);
-    ci->ci_free_list_usage++;
+      free_list_node = (struct list_node *)ptr;
+      list_node_init(free_list_node);
+      list_add_before(&ci->ci_free_list, free_list_node);
+      ci->ci_free_list_usage++;
 #ifdef OLSR_COOKIE_DEBUG
-    reuse = true;
+      reuse = true;
 #endif /* OLSR_COOKIE_DEBUG */
-  } else {
+    } else {
 
-    /*
-     * No interest in reusing memory.
-     */
-    free(ptr);
+      /*
+       * No interest in reusing memory.
+       */
+      free(ptr);
+    }
   }
 
   /* Stats keeping */
@@ -323,6 +545,38 @@ olsr_cookie_free(struct olsr_cookie_info *ci, void *ptr)
 
 }
 
+#ifndef NODEBUG
+/*
+ * Print the occupancy of every slab of the memory cookies in slab mode.
+ */
+void
+olsr_print_cookie_slabs(void)
+{
+  int ci_index;
+
+  OLSR_PRINTF(1, "\n--- %s ------------------------------------------------- MEMORY SLABS\n\n"
+              "%-24s %6s %6s %6s %s\n", olsr_wallclock_string(), "Cookie", "Slabs", "Blocks", "Used", "Used per slab");
+
+  for (ci_index = 1; ci_index < COOKIE_ID_MAX; ci_index++) {
+    struct olsr_cookie_info *ci = cookies[ci_index];
+    struct list_node *node;
+
+    if (!ci || !ci->ci_slab || !ci->ci_slab_count) {
+      continue;
+    }
+
+    OLSR_PRINTF(1, "%-24s %6u %6u %6u ", ci->ci_name, ci->ci_slab_count, ci->ci_slab_blocks, ci->ci_usage);
+    for (node = ci->ci_slab_full.next; node != &ci->ci_slab_full; node = node->next) {
+      OLSR_PRINTF(1, " %u", ci->ci_slab_blocks);
+    }
+    for (node = ci->ci_slab_partial.next; node != &ci->ci_slab_partial; node = node->next) {
+      OLSR_PRINTF(1, " %u", list2cookieslab(node)->cs_used);
+    }
+    OLSR_PRINTF(1, "\n");
+  }
+}
+#endif /* NODEBUG */
+
 /*
  * Local Variables:
  * c-basic-offset: 2
@@ -65,11 +65,65 @@ struct olsr_cookie_info {
   size_t ci_size;                      /* Fixed size for block allocations */
   unsigned int ci_usage;               /* Stats, resource usage */
   unsigned int ci_changes;             /* Stats, resource churn */
+  unsigned int ci_usage_peak;          /* Stats, highest resource usage */
+  uint32_t ci_allocs;                  /* Stats, allocations since start */
+  uint32_t ci_frees;                   /* Stats, frees since start */
+  uint32_t ci_rate_time;               /* Start of the current rate interval */
+  uint32_t ci_rate_allocs;             /* Allocations at the start of the interval */
+  uint32_t ci_rate_frees;              /* Frees at the start of the interval */
+  unsigned int ci_alloc_rate;          /* Allocations per second, last interval */
+  unsigned int ci_free_rate;           /* Frees per second, last interval */
   struct list_node ci_free_list;       /* List head for recyclable blocks */
   unsigned int ci_free_list_usage;     /* Length of free list */
+  bool ci_slab;                        /* Carve blocks from slabs */
+  size_t ci_slab_size;                 /* Size (and alignment) of a slab */
+  size_t ci_slab_stride;               /* Distance between two blocks of a slab */
+  unsigned int ci_slab_blocks;         /* Blocks per slab */
+  unsigned int ci_slab_count;          /* Number of slabs */
+  struct list_node ci_slab_partial;    /* Slabs with free blocks */
+  struct list_node ci_slab_full;       /* Slabs without free blocks */
 };
 
 #define COOKIE_FREE_LIST_THRESHOLD 10   /* Blocks / Percent  */
+#define COOKIE_RATE_INTERVAL 10000      /* Milliseconds */
+
+/*
+ * Snapshot of the statistics of a cookie, see olsr_cookie_get_stats().
+ * For timer cookies an allocation is a started timer.
+ */
+struct olsr_cookie_stats {
+  const char *name;
+  olsr_cookie_type type;
+  size_t size;                         /* Block size, memory cookies only */
+  unsigned int usage;                  /* Live objects */
+  unsigned int usage_peak;             /* Highest number of live objects */
+  unsigned int free_list;              /* Blocks kept for reuse */
+  unsigned int slabs;                  /* Slabs, slab mode only */
+  uint32_t allocs;                     /* Allocations since start */
+  uint32_t frees;                      /* Frees since start */
+  unsigned int alloc_rate;             /* Allocations per second */
+  unsigned int free_rate;              /* Frees per second */
+  size_t bytes;                        /* Bytes in live objects */
+  size_t bytes_peak;                   /* Highest number of bytes in live objects */
+};
+
+/*
+ * In slab mode the blocks of a memory cookie are carved from slabs of
+ * COOKIE_SLAB_SIZE bytes, or a power of two multiple of it if less than
+ * COOKIE_SLAB_MIN_BLOCKS blocks fit into a slab. Slabs are aligned to
+ * their size, so the slab of a block is found by masking its address.
+ */
+#define COOKIE_SLAB_SIZE 4096
+#define COOKIE_SLAB_MIN_BLOCKS 8
+
+struct olsr_cookie_slab {
+  struct list_node cs_node;            /* Member of the partial or full list */
+  void *cs_free;                       /* Singly linked list of free blocks */
+  unsigned int cs_used;                /* Blocks handed out */
+  unsigned int cs_carved;              /* Blocks carved from the slab so far */
+};
+
+LISTNODE2STRUCT(list2cookieslab, struct olsr_cookie_slab, cs_node);
 
 /*
  * Small brand which gets appended on the end of every block allocation.
@@ -88,10 +142,17 @@ extern char *olsr_cookie_name(olsr_cookie_t);
 extern void olsr_cookie_set_memory_size(struct olsr_cookie_info *, size_t);
 extern void olsr_cookie_usage_incr(olsr_cookie_t);
 extern void olsr_cookie_usage_decr(olsr_cookie_t);
+extern bool olsr_cookie_get_stats(olsr_cookie_t, struct olsr_cookie_stats *);
 
 extern void *olsr_cookie_malloc(struct olsr_cookie_info *);
 extern void olsr_cookie_free(struct olsr_cookie_info *, void *);
 
+#ifndef NODEBUG
+extern void olsr_print_cookie_slabs(void);
+#else /* NODEBUG */
+#define olsr_print_cookie_slabs() do { } while(0)
+#endif /* NODEBUG */
+
 #endif /* _OLSR_COOKIE_H */
 
 /*
@@ -41,16 +41,39 @@
  *
  * Implementation of Dijkstras algorithm. Initially all nodes
  * are initialized to infinite cost. First we put ourselves
- * on the heap of reachable nodes. Olsrd offer two heap based
- * implementations for the priority queue, AVL tree and Minimum Binary heap.
- * Both the implementations give interesting performance characteristics
+ * on the heap of reachable nodes. Olsrd offer four heap based
+ * implementations for the priority queue, AVL tree, Minimum Binary heap,
+ * an array backed Minimum Binary heap and a Radix heap.
+ * All the implementations give interesting performance characteristics
  * for the frequent operations on priority queues, AVL is better
- * to minimum key extraction and Binary heap to re-keying.
+ * to minimum key extraction and Binary heap to re-keying. The array
+ * backed heap avoids the pointer chasing of the Binary heap on
+ * large topologies and can be configured as a d-ary heap, which
+ * makes re-keying even cheaper on dense meshes. The Radix heap uses
+ * that the link costs are integers and the extracted path costs never
+ * decrease, all its operations are amortized constant time.
  * Next all neighbors of a node are explored and put on the heap if the
  * cost of reaching them is better than reaching the current
  * candidate node.
  * The SPF calculation is terminated if there are no more nodes
  * on the heap.
+ *
+ * If only edge costs changed since the last run, the incremental
+ * mode repairs the shortest path tree of the last run instead.
+ * All vertices whose path used an edge that got worse lose their
+ * path and are put back on the heap with the best path over the
+ * vertices that kept theirs. Edges that got better put their
+ * destination on the heap. Dijkstra then runs on this partial
+ * candidate set only.
+ *
+ * Optionally the edges are walked in a packed snapshot of the lsdb
+ * instead of the edge trees, which is rebuilt only after vertices
+ * or edges were added or removed.
+ *
+ * On Linux the Dijkstra run can be handed to a worker thread, which
+ * works on a private copy of the snapshot. The main loop keeps
+ * receiving packets meanwhile and applies the result to the RIB
+ * when the worker is done.
  */
 
 #include "ipcalc.h"
@@ -66,13 +89,186 @@
 #include "common/list.h"
 #include "common/avl.h"
 #include "common/heap.h"
+#include "common/radix_heap.h"
 #include "olsr_spf.h"
+#include "spf_snapshot.h"
+#include "spf_worker.h"
 #include "net_olsr.h"
 #include "lq_plugin.h"
 #include "gateway.h"
 
 struct timer_entry *spf_backoff_timer = NULL;
 
+/*
+ * State of the incremental SPF. The shortest path tree of the last
+ * run is kept in the lsdb and cost changes of edges are collected
+ * until the next run. Any other change of the lsdb or of the links
+ * to our neighbors invalidates the tree and forces a full run.
+ */
+static bool spf_full_pending = true;
+static struct list_node spf_changed_edges = { &spf_changed_edges, &spf_changed_edges };
+static unsigned int spf_changed_edge_count = 0;
+static uint32_t spf_link_version = 0;
+static unsigned int spf_link_count = 0;
+
+/* the current run walks the edges in the lsdb snapshot */
+static bool spf_use_snapshot = false;
+
+/* the lsdb changed while the worker thread was running */
+static bool spf_worker_rerun = false;
+
+/* the worker failed or its result was outdated, run the next SPF inline */
+static bool spf_worker_inline = false;
+
+/*
+ * priority queue implementations for the SPF candidate set
+ */
+enum spf_cand_set_type {
+  SPF_CAND_AVL_TREE,
+  SPF_CAND_BINARY_HEAP,
+  SPF_CAND_ARRAY_HEAP,
+  SPF_CAND_RADIX_HEAP
+};
+
+#ifdef DEBUG
+static const char *const SPF_CAND_SET_TXT[] = {
+  "AVL tree",
+  "Binary heap",
+  "Array heap",
+  "Radix heap"
+};
+#endif /* DEBUG */
+
+/*
+ * olsr_spf_cand_set_type
+ *
+ * return the priority queue chosen in the configuration.
+ */
+static enum spf_cand_set_type
+olsr_spf_cand_set_type(void)
+{
+  if (olsr_cnf->dijkstra_radix_heap) {
+    return SPF_CAND_RADIX_HEAP;
+  }
+  if (!olsr_cnf->dijkstra_binary_heap) {
+    return SPF_CAND_AVL_TREE;
+  }
+  return olsr_cnf->dijkstra_array_heap ? SPF_CAND_ARRAY_HEAP : SPF_CAND_BINARY_HEAP;
+}
+
+/*
+ * olsr_spf_flush_changes
+ *
+ * Forget all collected edge changes.
+ */
+static void
+olsr_spf_flush_changes(void)
+{
+  while (!list_is_empty(&spf_changed_edges)) {
+    list_remove(spf_changed_edges.next);
+  }
+  spf_changed_edge_count = 0;
+}
+
+/*
+ * olsr_spf_invalidate_tree
+ *
+ * The next SPF run must not reuse the last shortest path tree.
+ */
+static void
+olsr_spf_invalidate_tree(void)
+{
+  if (!spf_full_pending) {
+    spf_full_pending = true;
+    olsr_spf_flush_changes();
+  }
+}
+
+/*
+ * olsr_spf_invalidate
+ *
+ * The structure of the lsdb has changed, the next SPF run
+ * must neither reuse the last shortest path tree nor the snapshot.
+ */
+void
+olsr_spf_invalidate(void)
+{
+  olsr_spf_invalidate_tree();
+  olsr_spf_snapshot_invalidate();
+}
+
+/*
+ * olsr_spf_edge_cost_changed
+ *
+ * Remember an edge whose cost has changed for the next incremental SPF run.
+ */
+void
+olsr_spf_edge_cost_changed(struct tc_edge_entry *tc_edge, olsr_linkcost old_cost)
+{
+  olsr_spf_snapshot_update_cost(tc_edge);
+
+  if (spf_full_pending || !olsr_cnf->dijkstra_incremental) {
+    return;
+  }
+
+  /* keep the cost the last SPF run was based on */
+  if (list_node_on_list(&tc_edge->spf_change_node)) {
+    return;
+  }
+
+  if (spf_changed_edge_count >= SPF_INCREMENTAL_MAX_CHANGES) {
+    olsr_spf_invalidate_tree();
+    return;
+  }
+
+  tc_edge->spf_old_cost = old_cost;
+  list_add_before(&spf_changed_edges, &tc_edge->spf_change_node);
+  spf_changed_edge_count++;
+}
+
+/*
+ * olsr_spf_direct_link
+ *
+ * return the link to a 1st hop neighbor vertex, NULL otherwise.
+ */
+static struct link_entry *
+olsr_spf_direct_link(struct tc_entry *tc)
+{
+  return tc->spf_link_version == spf_link_version ? tc->spf_link : NULL;
+}
+
+/*
+ * olsr_spf_set_direct_link
+ *
+ * Set the link to a 1st hop neighbor vertex for the current run.
+ * If the link is not the one of the last run, all paths through this
+ * neighbor change their next-hop and the last tree cannot be reused.
+ */
+static void
+olsr_spf_set_direct_link(struct tc_entry *tc, struct link_entry *link)
+{
+  if (tc->spf_link_version != spf_link_version - 1 || tc->spf_link != link) {
+    olsr_spf_invalidate_tree();
+  }
+  tc->spf_link = link;
+  tc->spf_link_version = spf_link_version;
+}
+
+/*
+ * olsr_spf_set_parent
+ *
+ * Move a vertex below a new predecessor in the shortest path tree.
+ */
+static void
+olsr_spf_set_parent(struct tc_entry *tc, struct tc_entry *parent)
+{
+  if (tc->spf_parent) {
+    list_remove(&tc->spf_sibling_node);
+  }
+  tc->spf_parent = parent;
+  list_add_before(&parent->spf_child_list, &tc->spf_sibling_node);
+}
+
 /*
  * avl_comp_etx
  *
@@ -112,20 +308,36 @@ olsr_spf_add_cand_set(void *cand_set, struct tc_entry *tc)
 #ifdef DEBUG
   OLSR_PRINTF(2, "SPF: insert candidate %s, cost %s in %s\n", olsr_ip_to_string(&buf, &tc->addr),
               get_linkcost_text(tc->path_cost, false, &lqbuffer),
-              olsr_cnf->dijkstra_binary_heap ? "Binary heap" : "AVL tree");
+              SPF_CAND_SET_TXT[olsr_spf_cand_set_type()]);
 #endif /* DEBUG */
 
+  tc->spf_cand = true;
+
   /*
    * add the vertex to the priority queue was chosen.
    */
-  if(olsr_cnf->dijkstra_binary_heap){
+  switch (olsr_spf_cand_set_type()) {
+  case SPF_CAND_RADIX_HEAP:
+    tc->cand_radix_node.key = tc->path_cost;
+    radix_heap_insert((struct radix_heap*)cand_set, &tc->cand_radix_node);
+    break;
+  case SPF_CAND_ARRAY_HEAP:
+    tc->cand_array_node.key = tc->path_cost;
+    if (array_heap_insert((struct array_heap*)cand_set, &tc->cand_array_node)) {
+      /* a vertex missing from the candidate set would give wrong routes */
+      OLSR_PRINTF(1, "SPF: out of memory for candidate %u\n", ((struct array_heap*)cand_set)->count + 1);
+      olsr_exit(__func__, EXIT_FAILURE);
+    }
+    break;
+  case SPF_CAND_BINARY_HEAP:
     tc->cand_heap_node.key = tc->path_cost;
     heap_init_node(&tc->cand_heap_node);
     heap_insert((struct bin_heap*)cand_set, &tc->cand_heap_node);
-  }
-  else{
+    break;
+  default:
     tc->cand_tree_node.key = &tc->path_cost;
     avl_insert((struct avl_tree*)cand_set, &tc->cand_tree_node, AVL_DUP);
+    break;
   }
 }
 
@@ -167,7 +379,7 @@ olsr_spf_decrease_key(void *cand_set, struct tc_entry *tc, olsr_linkcost new_cos
 #ifdef DEBUG
   OLSR_PRINTF(2, "SPF: update candidate %s with old cost %s to the new cost %s in %s\n", olsr_ip_to_string(&buf, &tc->addr),
               get_linkcost_text(tc->path_cost, false, &lqbuffer), get_linkcost_text(new_cost, false, &lqbuffer),
-              olsr_cnf->dijkstra_binary_heap ? "Binary heap" : "AVL tree");
+              SPF_CAND_SET_TXT[olsr_spf_cand_set_type()]);
 #endif /* DEBUG */
 
   tc->path_cost = new_cost;
@@ -175,13 +387,23 @@ olsr_spf_decrease_key(void *cand_set, struct tc_entry *tc, olsr_linkcost new_cos
   /*
    * update the vertex in the priority queue defined.
    */
-  if(olsr_cnf->dijkstra_binary_heap){
+  switch (olsr_spf_cand_set_type()) {
+  case SPF_CAND_RADIX_HEAP:
+    tc->cand_radix_node.key = new_cost;
+    radix_heap_decrease_key((struct radix_heap*)cand_set, &tc->cand_radix_node);
+    break;
+  case SPF_CAND_ARRAY_HEAP:
+    tc->cand_array_node.key = new_cost;
+    array_heap_decrease_key((struct array_heap*)cand_set, &tc->cand_array_node);
+    break;
+  case SPF_CAND_BINARY_HEAP:
     tc->cand_heap_node.key = new_cost;
     heap_decrease_key((struct bin_heap*)cand_set, &tc->cand_heap_node);
-  }
-  else{
+    break;
+  default:
     olsr_spf_del_cand_tree((struct avl_tree*)cand_set, tc);
     olsr_spf_add_cand_set((struct avl_tree*)cand_set, tc);
+    break;
   }
 }
 
@@ -219,13 +441,108 @@ static struct tc_entry *
 olsr_spf_extract_best(void *cand_set)
 {
   void *node = NULL;
-  if(olsr_cnf->dijkstra_binary_heap){
+  struct tc_entry *tc;
+
+  switch (olsr_spf_cand_set_type()) {
+  case SPF_CAND_RADIX_HEAP:
+    node = (struct radix_heap_node*)radix_heap_extract_min((struct radix_heap*)cand_set);
+    tc = node ? cand_radix2tc(node) : NULL;
+    break;
+  case SPF_CAND_ARRAY_HEAP:
+    node = (struct array_heap_node*)array_heap_extract_min((struct array_heap*)cand_set);
+    tc = node ? cand_array2tc(node) : NULL;
+    break;
+  case SPF_CAND_BINARY_HEAP:
     node = (struct heap_node*)heap_extract_min((struct bin_heap*)cand_set);
-    return (node ? cand_heap2tc(node) : NULL);
+    tc = node ? cand_heap2tc(node) : NULL;
+    break;
+  default:
+    node = (struct avl_node*)avl_walk_first((struct avl_tree*)cand_set);
+    tc = node ? cand_tree2tc(node) : NULL;
+    break;
+  }
+
+  if (tc) {
+    tc->spf_cand = false;
+  }
+  return tc;
+}
+
+/*
+ * olsr_spf_update_vertex
+ *
+ * Set a better path to a vertex over a predecessor
+ * and key it on the candidate set.
+ */
+static void
+olsr_spf_update_vertex(void *cand_set, struct tc_entry *parent, struct tc_entry *tc, olsr_linkcost new_cost)
+{
+  /* if this node has been on the candidate set update it */
+  if (tc->spf_cand) {
+    olsr_spf_decrease_key(cand_set, tc, new_cost);
   }
   else{
-    node = (struct avl_node*)avl_walk_first((struct avl_tree*)cand_set);
-    return (node ? cand_tree2tc(node) : NULL);
+    /* insert it on candidate set with the new metric */
+    tc->path_cost = new_cost;
+    olsr_spf_add_cand_set(cand_set, tc);
+  }
+
+  /* pull-up the next-hop and bump the hop count */
+  tc->next_hop = parent->next_hop ? parent->next_hop : olsr_spf_direct_link(tc);
+  tc->hops = parent->hops + 1;
+  olsr_spf_set_parent(tc, parent);
+}
+
+/*
+ * olsr_spf_relax_edge
+ *
+ * Key the destination of an edge to the candidate set
+ * if the path over this edge is better.
+ */
+static inline void
+olsr_spf_relax_edge(void *cand_set, struct tc_entry *tc, struct tc_entry *new_tc, olsr_linkcost edge_cost)
+{
+  olsr_linkcost new_cost;
+
+#ifdef DEBUG
+#ifndef NODEBUG
+  struct ipaddr_str buf, nbuf;
+  struct lqtextbuffer lqbuffer;
+#endif /* NODEBUG */
+#endif /* DEBUG */
+
+  if (edge_cost == LINK_COST_BROKEN) {
+#ifdef DEBUG
+    OLSR_PRINTF(2, "SPF:   ignore edge %s (broken)\n", olsr_ip_to_string(&buf, &new_tc->addr));
+#endif /* DEBUG */
+    return;
+  }
+  /*
+   * total quality of the path through this vertex
+   * to the destination of this edge
+   */
+  new_cost = tc->path_cost + edge_cost;
+
+#ifdef DEBUG
+  OLSR_PRINTF(2, "SPF:   exploring edge %s, cost %s\n", olsr_ip_to_string(&buf, &new_tc->addr),
+              get_linkcost_text(new_cost, true, &lqbuffer));
+#endif /* DEBUG */
+
+  /*
+   * if it's better than the current path quality of this edge's
+   * destination node, then we've found a better path to this node.
+   */
+  if (new_cost < new_tc->path_cost) {
+
+    olsr_spf_update_vertex(cand_set, tc, new_tc, new_cost);
+
+#ifdef DEBUG
+    OLSR_PRINTF(2, "SPF:   better path to %s, cost %s, via %s, hops %u\n", olsr_ip_to_string(&buf, &new_tc->addr),
+                get_linkcost_text(new_cost, true, &lqbuffer), tc->next_hop ? olsr_ip_to_string(&nbuf,
+                                                                                               &tc->next_hop->neighbor_iface_addr)
+                : "<none>", new_tc->hops);
+#endif /* DEBUG */
+
   }
 }
 
@@ -240,23 +557,34 @@ static void
 olsr_spf_relax(void *cand_set, struct tc_entry *tc)
 {
   struct avl_node *edge_node;
-  olsr_linkcost new_cost;
+  uint32_t slot, last_slot;
 
 #ifdef DEBUG
 #ifndef NODEBUG
-  struct ipaddr_str buf, nbuf;
+  struct ipaddr_str buf;
   struct lqtextbuffer lqbuffer;
 #endif /* NODEBUG */
   OLSR_PRINTF(2, "SPF: exploring node %s, cost %s\n", olsr_ip_to_string(&buf, &tc->addr),
               get_linkcost_text(tc->path_cost, false, &lqbuffer));
 #endif /* DEBUG */
 
+  /*
+   * the snapshot holds the edges of this vertex in a row,
+   * dead-end edges are not part of it.
+   */
+  if (spf_use_snapshot) {
+    last_slot = spf_snapshot.edge_first[tc->spf_index + 1];
+    for (slot = spf_snapshot.edge_first[tc->spf_index]; slot < last_slot; slot++) {
+      olsr_spf_relax_edge(cand_set, tc, spf_snapshot.vertex[spf_snapshot.edge_target[slot]], spf_snapshot.edge_cost[slot]);
+    }
+    return;
+  }
+
   /*
    * loop through all edges of this vertex.
    */
   for (edge_node = avl_walk_first(&tc->edge_tree); edge_node; edge_node = avl_walk_next(edge_node)) {
 
-    struct tc_entry *new_tc;
     struct tc_edge_entry *tc_edge = edge_tree2tc_edge(edge_node);
 
     /*
@@ -265,62 +593,12 @@ olsr_spf_relax(void *cand_set, struct tc_entry *tc)
     if (!tc_edge->edge_inv) {
 #ifdef DEBUG
       OLSR_PRINTF(2, "SPF:   ignoring edge %s\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr));
-      if (!tc_edge->edge_inv) {
-        OLSR_PRINTF(2, "SPF:     no inverse edge\n");
-      }
+      OLSR_PRINTF(2, "SPF:     no inverse edge\n");
 #endif /* DEBUG */
       continue;
     }
 
-    if (tc_edge->cost == LINK_COST_BROKEN) {
-#ifdef DEBUG
-      OLSR_PRINTF(2, "SPF:   ignore edge %s (broken)\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr));
-#endif /* DEBUG */
-      continue;
-    }
-    /*
-     * total quality of the path through this vertex
-     * to the destination of this edge
-     */
-    new_cost = tc->path_cost + tc_edge->cost;
-
-#ifdef DEBUG
-    OLSR_PRINTF(2, "SPF:   exploring edge %s, cost %s\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr),
-                get_linkcost_text(new_cost, true, &lqbuffer));
-#endif /* DEBUG */
-
-    /*
-     * if it's better than the current path quality of this edge's
-     * destination node, then we've found a better path to this node.
-     */
-    new_tc = tc_edge->edge_inv->tc;
-
-    if (new_cost < new_tc->path_cost) {
-
-      /* if this node has been on the candidate set update it */
-      if (new_tc->path_cost < ROUTE_COST_BROKEN) {
-          olsr_spf_decrease_key(cand_set, new_tc, new_cost);
-      }
-      else{
-        /* insert it on candidate set with the new metric */
-        new_tc->path_cost = new_cost;
-        olsr_spf_add_cand_set(cand_set, new_tc);
-      }
-
-      /* pull-up the next-hop and bump the hop count */
-      if (tc->next_hop) {
-        new_tc->next_hop = tc->next_hop;
-      }
-      new_tc->hops = tc->hops + 1;
-
-#ifdef DEBUG
-      OLSR_PRINTF(2, "SPF:   better path to %s, cost %s, via %s, hops %u\n", olsr_ip_to_string(&buf, &new_tc->addr),
-                  get_linkcost_text(new_cost, true, &lqbuffer), tc->next_hop ? olsr_ip_to_string(&nbuf,
-                                                                                                 &tc->next_hop->neighbor_iface_addr)
-                  : "<none>", new_tc->hops);
-#endif /* DEBUG */
-
-    }
+    olsr_spf_relax_edge(cand_set, tc, tc_edge->edge_inv->tc, tc_edge->cost);
   }
 }
 
@@ -329,7 +607,8 @@ olsr_spf_relax(void *cand_set, struct tc_entry *tc)
  *
  * Run the Dijkstra algorithm.
  *
- * A node gets added to the priority queue(AVL tree or Binary heap)
+ * A node gets added to the priority queue(AVL tree, Binary heap, Array heap
+ * or Radix heap)
  * when one of its edges has an overall better root path cost than
  * the node itself.
  * The node with the shortest metric gets moved from the priority queue to
@@ -351,17 +630,166 @@ olsr_spf_run_full(void *cand_set, struct list_node *path_list, int *path_count)
     /*
      * move the best path from the priority queue
      * to the path list.
-     * The extract_best on Binary heap deletes and returns the vertex from the
+     * The extract_best on all heaps deletes and returns the vertex from the
      * priority queue. The function on AVL just returns the vertex, this node
      * must be deleted from AVL.
      */
-    if(!olsr_cnf->dijkstra_binary_heap){
+    if (olsr_spf_cand_set_type() == SPF_CAND_AVL_TREE) {
       olsr_spf_del_cand_tree((struct avl_tree*)cand_set, tc);
     }
     olsr_spf_add_path_list(path_list, path_count, tc);
   }
 }
 
+/*
+ * olsr_spf_detach_subtree
+ *
+ * Move a vertex and all its descendants in the shortest path tree
+ * to the list of affected vertices and forget their paths.
+ */
+static void
+olsr_spf_detach_subtree(struct list_node *affected, struct tc_entry *root)
+{
+  struct list_node *node;
+  struct tc_entry *tc, *child;
+
+  list_remove(&root->spf_sibling_node);
+  root->spf_parent = NULL;
+  root->spf_affected = true;
+  list_add_before(affected, &root->path_list_node);
+
+  /* the list grows while we walk it, so this is a breadth first walk */
+  for (node = &root->path_list_node; node != affected; node = node->next) {
+    tc = pathlist2tc(node);
+
+    while (!list_is_empty(&tc->spf_child_list)) {
+      child = spf_sibling2tc(tc->spf_child_list.next);
+      list_remove(&child->spf_sibling_node);
+      child->spf_parent = NULL;
+      child->spf_affected = true;
+      list_add_before(affected, &child->path_list_node);
+    }
+
+    tc->path_cost = ROUTE_COST_BROKEN;
+    tc->next_hop = olsr_spf_direct_link(tc);
+    tc->hops = 0;
+  }
+}
+
+/*
+ * olsr_spf_seed_affected
+ *
+ * Find the best path to an affected vertex over the vertices
+ * which kept their path and key it on the candidate set.
+ */
+static void
+olsr_spf_seed_affected(void *cand_set, struct tc_entry *tc)
+{
+  struct tc_edge_entry *tc_edge, *tc_edge_inv;
+  struct tc_entry *best = NULL;
+  olsr_linkcost best_cost = ROUTE_COST_BROKEN;
+
+  OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc, tc_edge) {
+
+    /* the inverse edge leads from the neighbor to this vertex */
+    tc_edge_inv = tc_edge->edge_inv;
+    if (!tc_edge_inv || tc_edge_inv->cost == LINK_COST_BROKEN) {
+      continue;
+    }
+    if (tc_edge_inv->tc->spf_affected || tc_edge_inv->tc->path_cost == ROUTE_COST_BROKEN) {
+      continue;
+    }
+    if (tc_edge_inv->tc->path_cost + tc_edge_inv->cost < best_cost) {
+      best_cost = tc_edge_inv->tc->path_cost + tc_edge_inv->cost;
+      best = tc_edge_inv->tc;
+    }
+  } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc, tc_edge);
+
+  if (best) {
+    olsr_spf_update_vertex(cand_set, best, tc, best_cost);
+  }
+}
+
+/*
+ * olsr_spf_run_incremental
+ *
+ * Repair the shortest path tree of the last run after
+ * the cost of the edges on the change list has changed.
+ * Only the vertices whose path may have changed are put on the
+ * path list, including those which are no longer reachable.
+ */
+static void
+olsr_spf_run_incremental(void *cand_set, struct list_node *path_list, int *path_count)
+{
+  struct list_node affected, *node;
+  struct tc_edge_entry *tc_edge;
+  struct tc_entry *tc, *new_tc;
+  olsr_linkcost old_cost;
+
+  *path_count = 0;
+  list_head_init(&affected);
+
+  /*
+   * Every vertex whose path uses an edge that got worse loses its path,
+   * together with its whole subtree.
+   */
+  for (node = spf_changed_edges.next; node != &spf_changed_edges; node = node->next) {
+    tc_edge = spf_change2tc_edge(node);
+    if (!tc_edge->edge_inv) {
+      continue;
+    }
+
+    old_cost = tc_edge->spf_old_cost;
+    new_tc = tc_edge->edge_inv->tc;
+    if (tc_edge->cost > old_cost && new_tc->spf_parent == tc_edge->tc) {
+      olsr_spf_detach_subtree(&affected, new_tc);
+    }
+  }
+
+  /*
+   * Reconnect the affected vertices over the unaffected ones.
+   */
+  for (node = affected.next; node != &affected; node = node->next) {
+    olsr_spf_seed_affected(cand_set, pathlist2tc(node));
+  }
+  while (!list_is_empty(&affected)) {
+    tc = pathlist2tc(affected.next);
+    tc->spf_affected = false;
+    list_remove(&tc->path_list_node);
+    olsr_spf_add_path_list(path_list, path_count, tc);
+  }
+
+  /*
+   * Edges that got better may offer a better path to their destination.
+   */
+  for (node = spf_changed_edges.next; node != &spf_changed_edges; node = node->next) {
+    tc_edge = spf_change2tc_edge(node);
+    if (!tc_edge->edge_inv || tc_edge->cost == LINK_COST_BROKEN) {
+      continue;
+    }
+
+    tc = tc_edge->tc;
+    new_tc = tc_edge->edge_inv->tc;
+    if (tc->path_cost != ROUTE_COST_BROKEN && tc->path_cost + tc_edge->cost < new_tc->path_cost) {
+      olsr_spf_update_vertex(cand_set, tc, new_tc, tc->path_cost + tc_edge->cost);
+    }
+  }
+
+  /*
+   * Propagate the new paths. Every vertex which got a new path
+   * passes the candidate set.
+   */
+  while ((tc = olsr_spf_extract_best(cand_set))) {
+    olsr_spf_relax(cand_set, tc);
+    if (olsr_spf_cand_set_type() == SPF_CAND_AVL_TREE) {
+      olsr_spf_del_cand_tree((struct avl_tree*)cand_set, tc);
+    }
+    if (!list_node_on_list(&tc->path_list_node)) {
+      olsr_spf_add_path_list(path_list, path_count, tc);
+    }
+  }
+}
+
 /**
  * Callback for the SPF backoff timer.
  */
@@ -371,6 +799,233 @@ olsr_expire_spf_backoff(void *context __attribute__ ((unused)))
   spf_backoff_timer = NULL;
 }
 
+/*
+ * olsr_spf_retire_routes
+ *
+ * Remove the prefixes of a vertex without a path from the RIB.
+ */
+static void
+olsr_spf_retire_routes(struct tc_entry *tc)
+{
+  struct avl_node *rtp_tree_node;
+  struct rt_path *rtp;
+
+  for (rtp_tree_node = avl_walk_first(&tc->prefix_tree); rtp_tree_node; rtp_tree_node = avl_walk_next(rtp_tree_node)) {
+    rtp = rtp_prefix_tree2rtp(rtp_tree_node);
+
+    if (rtp->rtp_rt) {
+      if (rtp->rtp_rt->rt_best == rtp) {
+        rtp->rtp_rt->rt_best = NULL;
+      }
+      olsr_rt_unlink_path(rtp);
+    }
+  }
+}
+
+/*
+ * olsr_spf_update_routes
+ *
+ * Insert the prefixes of all reachable vertices on the path list into
+ * the RIB and remove those of the unreachable ones. Insert the pending
+ * prefixes of reachable vertices which are not on the path list.
+ * Compute the route changes for the kernel.
+ */
+static void
+olsr_spf_update_routes(struct list_node *path_list)
+{
+  struct avl_node *rtp_tree_node;
+  struct tc_entry *tc;
+  struct rt_path *rtp;
+  struct link_entry *link;
+
+  /*
+   * In the path list we have all the nodes whose path has changed,
+   * after a full run these are all the reachable nodes in our topology.
+   */
+  for (; !list_is_empty(path_list); list_remove(path_list->next)) {
+
+    tc = pathlist2tc(path_list->next);
+    link = tc->next_hop;
+
+    if (tc->path_cost == ROUTE_COST_BROKEN || !link) {
+#ifdef DEBUG
+      /*
+       * Supress the error msg when our own tc_entry
+       * does not contain a next-hop.
+       */
+      if (tc != tc_myself && tc->path_cost != ROUTE_COST_BROKEN) {
+        struct ipaddr_str buf;
+        OLSR_PRINTF(2, "SPF: %s no next-hop\n", olsr_ip_to_string(&buf, &tc->addr));
+      }
+#endif /* DEBUG */
+      olsr_spf_retire_routes(tc);
+      continue;
+    }
+
+    /*
+     * Now walk all prefixes advertised by that node.
+     * Since the node is reachable, insert the prefix into the global RIB.
+     * If the prefix is already in the RIB, refresh the entry such
+     * that olsr_delete_outdated_routes() does not purge it off.
+     */
+    for (rtp_tree_node = avl_walk_first(&tc->prefix_tree); rtp_tree_node; rtp_tree_node = avl_walk_next(rtp_tree_node)) {
+
+      rtp = rtp_prefix_tree2rtp(rtp_tree_node);
+
+      if (rtp->rtp_rt) {
+
+        /*
+         * If there is a route entry, the prefix is already in the global RIB.
+         */
+        olsr_update_rt_path(rtp, tc, link);
+
+      } else {
+
+        /*
+         * The prefix is reachable and not yet in the global RIB.
+         * Build a rt_entry for it.
+         */
+        olsr_insert_rt_path(rtp, tc, link);
+      }
+    }
+  }
+
+  /*
+   * New prefixes, and prefixes removed from the RIB otherwise, of nodes
+   * the SPF run did not touch. The others wait until their node
+   * gets a path again.
+   */
+  while (!list_is_empty(&rtp_pending_list)) {
+    rtp = refreshlist2rtp(rtp_pending_list.next);
+    list_remove(&rtp->rtp_refresh_node);
+
+    tc = rtp->rtp_tc;
+    if (tc->path_cost != ROUTE_COST_BROKEN && tc->next_hop) {
+      olsr_insert_rt_path(rtp, tc, tc->next_hop);
+    }
+  }
+
+#ifdef __linux__
+  /* check gateway tunnels */
+  olsr_trigger_gatewayloss_check();
+#endif /* __linux__ */
+
+  /* Update the RIB based on the new SPF results */
+
+  olsr_update_rib_routes();
+}
+
+#ifdef __linux__
+/*
+ * olsr_spf_worker_apply
+ *
+ * Main loop callback, copy the result of the worker into the lsdb
+ * and update the RIB and the kernel routes.
+ */
+static void
+olsr_spf_worker_apply(struct spf_job *job)
+{
+  struct list_node path_list;
+  struct tc_entry *tc;
+  struct tc_edge_entry *tc_edge;
+  struct link_entry *link;
+  uint32_t i;
+
+  /*
+   * If vertices or edges were added or removed meanwhile
+   * the indices of the job are meaningless, start over.
+   * Run inline then, under steady churn another job could
+   * be outdated again and the RIB would never be updated.
+   */
+  if (job->failed || spf_snapshot.stale || job->generation != spf_snapshot.generation) {
+    OLSR_PRINTF(3, "SPF: worker result %s, recalculating\n", job->failed ? "missing" : "outdated");
+    spf_worker_inline = true;
+    spf_worker_rerun = false;
+    olsr_calculate_routing_table(true);
+    return;
+  }
+
+  /*
+   * Look up the links to our neighbors now,
+   * they may have changed while the worker ran.
+   */
+  OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc_myself, tc_edge) {
+    if (tc_edge->edge_inv && job->direct[tc_edge->edge_inv->tc->spf_index]) {
+      tc = tc_edge->edge_inv->tc;
+      link = get_best_link_to_neighbor(&tc->addr);
+      tc->spf_link = link && lookup_link_status(link) != LOST_LINK ? link : NULL;
+    }
+  } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc_myself, tc_edge);
+
+  list_head_init(&path_list);
+  olsr_bump_routingtree_version();
+  for (i = 0; i < job->vertex_count; i++) {
+    tc = spf_snapshot.vertex[i];
+    tc->path_cost = job->path_cost[i];
+    tc->hops = job->hops[i];
+    tc->next_hop = job->first_hop[i] != SPF_JOB_NO_HOP ? spf_snapshot.vertex[job->first_hop[i]]->spf_link : NULL;
+    tc->spf_parent = NULL;
+    list_head_init(&tc->spf_child_list);
+    if (tc->path_cost != ROUTE_COST_BROKEN) {
+      list_add_before(&path_list, &tc->path_list_node);
+    }
+  }
+
+  olsr_spf_update_routes(&path_list);
+  olsr_update_kernel_routes();
+
+  /* the lsdb changed while the worker ran */
+  if (spf_worker_rerun) {
+    spf_worker_rerun = false;
+    olsr_calculate_routing_table(true);
+  }
+}
+
+/*
+ * olsr_spf_worker_dispatch
+ *
+ * Copy the snapshot of the lsdb into a job for the worker thread.
+ * return false if the SPF has to run inline.
+ */
+static bool
+olsr_spf_worker_dispatch(void)
+{
+  struct spf_job *job;
+  struct tc_edge_entry *tc_edge;
+
+  if (!olsr_spf_worker_start(&olsr_spf_worker_apply) || !olsr_spf_snapshot_build()) {
+    return false;
+  }
+
+  job = olsr_spf_worker_job(spf_snapshot.vertex_count, spf_snapshot.edge_count);
+  if (!job) {
+    return false;
+  }
+
+  job->generation = spf_snapshot.generation;
+  job->source = tc_myself->spf_index;
+  job->arity = olsr_cnf->dijkstra_heap_arity;
+  memcpy(job->edge_first, spf_snapshot.edge_first, (spf_snapshot.vertex_count + 1) * sizeof(*job->edge_first));
+  memcpy(job->edge_target, spf_snapshot.edge_target, spf_snapshot.edge_count * sizeof(*job->edge_target));
+  memcpy(job->edge_cost, spf_snapshot.edge_cost, spf_snapshot.edge_count * sizeof(*job->edge_cost));
+
+  /* our neighbors are the destinations of our own edges */
+  memset(job->direct, 0, spf_snapshot.vertex_count * sizeof(*job->direct));
+  OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc_myself, tc_edge) {
+    if (tc_edge->edge_inv && olsr_spf_direct_link(tc_edge->edge_inv->tc)) {
+      job->direct[tc_edge->edge_inv->tc->spf_index] = 1;
+    }
+  } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc_myself, tc_edge);
+
+  olsr_spf_worker_submit();
+
+  /* the worker does not keep a shortest path tree */
+  spf_full_pending = true;
+  olsr_spf_flush_changes();
+  return true;
+}
+#endif /* __linux__ */
+
 void
 olsr_calculate_routing_table(bool force)
 {
@@ -378,15 +1033,19 @@ olsr_calculate_routing_table(bool force)
   struct timeval t1, t2, t3, t4, t5, spf_init, spf_run, route, kernel, total;
 #endif /* SPF_PROFILING */
   struct bin_heap cand_heap;
+  struct array_heap cand_array;
+  struct radix_heap cand_radix;
   struct avl_tree cand_tree;
-  struct avl_node *rtp_tree_node;
+  void *cand_set;
   struct list_node path_list;          /* head of the path_list */
   struct tc_entry *tc;
-  struct rt_path *rtp;
   struct tc_edge_entry *tc_edge;
   struct neighbor_entry *neigh;
   struct link_entry *link;
+  struct interface_olsr *inter;
   int path_count = 0;
+  unsigned int link_count = 0;
+  bool incremental;
 
   /* We are done if our backoff timer is running */
   if (!force) {
@@ -398,32 +1057,20 @@ olsr_calculate_routing_table(bool force)
     spf_backoff_timer = olsr_start_timer(1000, 5, OLSR_TIMER_ONESHOT, &olsr_expire_spf_backoff, NULL, 0);
   }
 
+#ifdef __linux__
+  /* run again once the worker has finished */
+  if (olsr_spf_worker_busy()) {
+    spf_worker_rerun = true;
+    return;
+  }
+#endif /* __linux__ */
+
 #ifdef SPF_PROFILING
   gettimeofday(&t1, NULL);
 #endif /* SPF_PROFILING */
 
-  /*
-   * Prepare the candidate set with the priority queue defined
-   * (AVL tree or Binary heap) and result list.
-   */
-  if(olsr_cnf->dijkstra_binary_heap){
-    heap_init(&cand_heap);
-  }
-  else{
-    avl_init(&cand_tree, avl_comp_etx);
-  }
   list_head_init(&path_list);
-  olsr_bump_routingtree_version();
-
-  /*
-   * Initialize vertices in the lsdb.
-   */
-  OLSR_FOR_ALL_TC_ENTRIES(tc) {
-    tc->next_hop = NULL;
-    tc->path_cost = ROUTE_COST_BROKEN;
-    tc->hops = 0;
-  }
-  OLSR_FOR_ALL_TC_ENTRIES_END(tc);
+  spf_link_version++;
 
   /*
    * Check if there was a change in the main IP address.
@@ -435,22 +1082,13 @@ olsr_calculate_routing_table(bool force)
     /*
      * All gone now. Flush all routes.
      */
+    olsr_bump_routingtree_version();
+    olsr_spf_invalidate();
     olsr_update_rib_routes();
     olsr_update_kernel_routes();
     return;
   }
 
-  /*
-   * zero ourselves and add us to the priority queue chosen.
-   */
-  tc_myself->path_cost = ZERO_ROUTE_COST;
-  if(olsr_cnf->dijkstra_binary_heap){
-    olsr_spf_add_cand_set(&cand_heap, tc_myself);
-  }
-  else{
-    olsr_spf_add_cand_set(&cand_tree, tc_myself);
-  }
-
   /*
    * add edges to and from our neighbours.
    */
@@ -479,10 +1117,16 @@ olsr_calculate_routing_table(bool force)
 
       /* find the interface for the link */
       if (link->if_name) {
-        link->inter = if_ifwithname(link->if_name);
+        inter = if_ifwithname(link->if_name);
       } else {
-        link->inter = if_ifwithaddr(&link->local_iface_addr);
+        inter = if_ifwithaddr(&link->local_iface_addr);
+      }
+
+      /* routes carry the interface, an incremental run would not update them */
+      if (inter != link->inter) {
+        olsr_spf_invalidate_tree();
       }
+      link->inter = inter;
 
       /*
        * Set the next-hops of our neighbors.
@@ -498,89 +1142,114 @@ olsr_calculate_routing_table(bool force)
         olsr_calc_tc_edge_entry_etx(tc_edge);
       }
       if (tc_edge->edge_inv) {
-        tc_edge->edge_inv->tc->next_hop = link;
+        olsr_spf_set_direct_link(tc_edge->edge_inv->tc, link);
+        link_count++;
       }
     }
   }
   OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
 
-#ifdef SPF_PROFILING
-  gettimeofday(&t2, NULL);
-#endif /* SPF_PROFILING */
-
-  /*
-   * Run the SPF calculation.
-   */
-  if(olsr_cnf->dijkstra_binary_heap){
-    olsr_spf_run_full(&cand_heap, &path_list, &path_count);
-  }
-  else{
-    olsr_spf_run_full(&cand_tree, &path_list, &path_count);
+  /* a neighbor which is gone changes the next-hops as well */
+  if (link_count != spf_link_count) {
+    olsr_spf_invalidate_tree();
   }
+  spf_link_count = link_count;
 
-  OLSR_PRINTF(2, "\n--- %s ------------------------------------------------- DIJKSTRA\n\n", olsr_wallclock_string());
+#ifdef __linux__
+  /* hand the SPF over to the worker thread, the result is applied later */
+  if (olsr_cnf->dijkstra_thread && !spf_worker_inline && olsr_spf_worker_dispatch()) {
+    return;
+  }
+  spf_worker_inline = false;
+#endif /* __linux__ */
 
-#ifdef SPF_PROFILING
-  gettimeofday(&t3, NULL);
-#endif /* SPF_PROFILING */
+  /* bring the snapshot up to date, fall back to the edge trees on failure */
+  spf_use_snapshot = olsr_cnf->dijkstra_snapshot && olsr_spf_snapshot_build();
 
   /*
-   * In the path list we have all the reachable nodes in our topology.
+   * Prepare the candidate set with the priority queue defined
+   * (AVL tree, Binary heap, Array heap or Radix heap).
+   * The array heap never holds more than one node per vertex,
+   * so size it to the lsdb up front.
    */
-  for (; !list_is_empty(&path_list); list_remove(path_list.next)) {
-
-    tc = pathlist2tc(path_list.next);
-    link = tc->next_hop;
-
-    if (!link) {
-#ifdef DEBUG
-      /*
-       * Supress the error msg when our own tc_entry
-       * does not contain a next-hop.
-       */
-      if (tc != tc_myself) {
-        struct ipaddr_str buf;
-        OLSR_PRINTF(2, "SPF: %s no next-hop\n", olsr_ip_to_string(&buf, &tc->addr));
-      }
-#endif /* DEBUG */
-      continue;
+  switch (olsr_spf_cand_set_type()) {
+  case SPF_CAND_RADIX_HEAP:
+    radix_heap_init(&cand_radix);
+    cand_set = &cand_radix;
+    break;
+  case SPF_CAND_ARRAY_HEAP:
+    if (array_heap_init(&cand_array, olsr_cnf->dijkstra_heap_arity, tc_tree.count + 1)) {
+      OLSR_PRINTF(1, "SPF: out of memory for %u candidates\n", tc_tree.count + 1);
+      olsr_exit(__func__, EXIT_FAILURE);
     }
+    cand_set = &cand_array;
+    break;
+  case SPF_CAND_BINARY_HEAP:
+    heap_init(&cand_heap);
+    cand_set = &cand_heap;
+    break;
+  default:
+    avl_init(&cand_tree, avl_comp_etx);
+    cand_set = &cand_tree;
+    break;
+  }
+
+  incremental = olsr_cnf->dijkstra_incremental && !spf_full_pending;
+  if (!incremental) {
 
     /*
-     * Now walk all prefixes advertised by that node.
-     * Since the node is reachable, insert the prefix into the global RIB.
-     * If the prefix is already in the RIB, refresh the entry such
-     * that olsr_delete_outdated_routes() does not purge it off.
+     * A full run refreshes all paths, the ones not refreshed are
+     * outdated. Never bump the version before a dispatch, the RIB may
+     * be updated while the worker runs and would lose all paths.
+     * An incremental run removes the paths of the vertices it
+     * disconnects itself and leaves the version alone.
      */
-    for (rtp_tree_node = avl_walk_first(&tc->prefix_tree); rtp_tree_node; rtp_tree_node = avl_walk_next(rtp_tree_node)) {
-
-      rtp = rtp_prefix_tree2rtp(rtp_tree_node);
+    olsr_bump_routingtree_version();
 
-      if (rtp->rtp_rt) {
+    /*
+     * Initialize vertices in the lsdb.
+     */
+    OLSR_FOR_ALL_TC_ENTRIES(tc) {
+      tc->next_hop = olsr_spf_direct_link(tc);
+      tc->path_cost = ROUTE_COST_BROKEN;
+      tc->hops = 0;
+      tc->spf_parent = NULL;
+      list_head_init(&tc->spf_child_list);
+    }
+    OLSR_FOR_ALL_TC_ENTRIES_END(tc);
 
-        /*
-         * If there is a route entry, the prefix is already in the global RIB.
-         */
-        olsr_update_rt_path(rtp, tc, link);
+    /*
+     * zero ourselves and add us to the priority queue chosen.
+     */
+    tc_myself->path_cost = ZERO_ROUTE_COST;
+    olsr_spf_add_cand_set(cand_set, tc_myself);
+  }
 
-      } else {
+#ifdef SPF_PROFILING
+  gettimeofday(&t2, NULL);
+#endif /* SPF_PROFILING */
 
-        /*
-         * The prefix is reachable and not yet in the global RIB.
-         * Build a rt_entry for it.
-         */
-        olsr_insert_rt_path(rtp, tc, link);
-      }
-    }
+  /*
+   * Run the SPF calculation.
+   */
+  if (incremental) {
+    olsr_spf_run_incremental(cand_set, &path_list, &path_count);
+  } else {
+    olsr_spf_run_full(cand_set, &path_list, &path_count);
   }
-#ifdef __linux__
-  /* check gateway tunnels */
-  olsr_trigger_gatewayloss_check();
-#endif /* __linux__ */
+  if (cand_set == &cand_array) {
+    array_heap_free(&cand_array);
+  }
+  olsr_spf_flush_changes();
+  spf_full_pending = false;
 
-  /* Update the RIB based on the new SPF results */
+  OLSR_PRINTF(2, "\n--- %s ------------------------------------------------- DIJKSTRA\n\n", olsr_wallclock_string());
 
-  olsr_update_rib_routes();
+#ifdef SPF_PROFILING
+  gettimeofday(&t3, NULL);
+#endif /* SPF_PROFILING */
+
+  olsr_spf_update_routes(&path_list);
 
 #ifdef SPF_PROFILING
   gettimeofday(&t4, NULL);
@@ -600,8 +1269,8 @@ olsr_calculate_routing_table(bool force)
   timersub(&t4, &t3, &route);
   timersub(&t5, &t4, &kernel);
   timersub(&t5, &t1, &total);
-  OLSR_PRINTF(1, "\n--- SPF-stats for %d nodes, %d routes (total/init/run/route/kern): " "%d, %d, %d, %d, %d\n", path_count,
-              routingtree.count, (int)total.tv_usec, (int)spf_init.tv_usec, (int)spf_run.tv_usec, (int)route.tv_usec,
+  OLSR_PRINTF(1, "\n--- SPF-stats for %d nodes, %d routes, %s run (total/init/run/route/kern): " "%d, %d, %d, %d, %d\n", path_count,
+              routingtree.count, incremental ? "incremental" : "full", (int)total.tv_usec, (int)spf_init.tv_usec, (int)spf_run.tv_usec, (int)route.tv_usec,
               (int)kernel.tv_usec);
 #endif /* SPF_PROFILING */
 }
@@ -42,8 +42,21 @@
 #ifndef _OLSR_SPF_H
 #define _OLSR_SPF_H
 
+#include "olsr_types.h"
+
+/*
+ * Maximum number of changed edges handled by an incremental SPF run,
+ * if more edges changed a full SPF run is cheaper.
+ */
+#define SPF_INCREMENTAL_MAX_CHANGES 64
+
+struct tc_edge_entry;
+
 void olsr_calculate_routing_table(bool force);
 
+void olsr_spf_invalidate(void);
+void olsr_spf_edge_cost_changed(struct tc_edge_entry *tc_edge, olsr_linkcost old_cost);
+
 #endif /* _OLSR_SPF_H */
 
 /*
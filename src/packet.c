@@ -52,6 +52,8 @@
 
 static bool sending_tc = false;
 
+struct arena olsr_msg_arena;
+
 /**
  *Free the memory allocated for a HELLO packet.
  *
@@ -129,7 +131,7 @@ olsr_build_hello_packet(struct hello_message *message, struct interface_olsr *ou
       continue;
     }
 
-    message_neighbor = olsr_malloc_hello_neighbor("Build HELLO");
+    message_neighbor = olsr_arena_hello_neighbor(&olsr_msg_arena, "Build HELLO");
 
     /* Find the link status */
     message_neighbor->link = lnk;
@@ -221,7 +223,7 @@ olsr_build_hello_packet(struct hello_message *message, struct interface_olsr *ou
       continue;
     }
 
-    message_neighbor = olsr_malloc_hello_neighbor("Build HELLO 2");
+    message_neighbor = olsr_arena_hello_neighbor(&olsr_msg_arena, "Build HELLO 2");
 
     message_neighbor->link = UNSPEC_LINK;
 
@@ -283,29 +285,6 @@ olsr_build_hello_packet(struct hello_message *message, struct interface_olsr *ou
   return 0;
 }
 
-/**
- *Free the memory allocated for a TC packet.
- *
- *@param message the pointer to the packet to erase
- *
- *@return nada
- */
-void
-olsr_free_tc_packet(struct tc_message *message)
-{
-  struct tc_mpr_addr *mprs;
-
-  if (!message)
-    return;
-
-  mprs = message->multipoint_relay_selector_address;
-  while (mprs != NULL) {
-    struct tc_mpr_addr *prev_mprs = mprs;
-    mprs = mprs->next;
-    free(prev_mprs);
-  }
-}
-
 /**
  *Build an internal TC package for this
  *node.
@@ -341,7 +320,7 @@ olsr_build_tc_packet(struct tc_message *message)
       {
         /* 2 = Add all neighbors */
         //printf("\t%s\n", olsr_ip_to_string(&mprs->mpr_selector_addr));
-        message_mpr = olsr_malloc_tc_mpr_addr("Build TC");
+        message_mpr = olsr_arena_tc_mpr_addr(&olsr_msg_arena, "Build TC");
 
         message_mpr->address = entry->neighbor_main_addr;
         message_mpr->next = message->multipoint_relay_selector_address;
@@ -354,7 +333,7 @@ olsr_build_tc_packet(struct tc_message *message)
         /* 1 = Add all MPR selectors and selected MPRs */
         if ((entry->is_mpr) || (olsr_lookup_mprs_set(&entry->neighbor_main_addr) != NULL)) {
           //printf("\t%s\n", olsr_ip_to_string(&mprs->mpr_selector_addr));
-          message_mpr = olsr_malloc_tc_mpr_addr("Build TC 2");
+          message_mpr = olsr_arena_tc_mpr_addr(&olsr_msg_arena, "Build TC 2");
 
           message_mpr->address = entry->neighbor_main_addr;
           message_mpr->next = message->multipoint_relay_selector_address;
@@ -368,7 +347,7 @@ olsr_build_tc_packet(struct tc_message *message)
         /* 0 = Add only MPR selectors(default) */
         if (olsr_lookup_mprs_set(&entry->neighbor_main_addr) != NULL) {
           //printf("\t%s\n", olsr_ip_to_string(&mprs->mpr_selector_addr));
-          message_mpr = olsr_malloc_tc_mpr_addr("Build TC 3");
+          message_mpr = olsr_arena_tc_mpr_addr(&olsr_msg_arena, "Build TC 3");
 
           message_mpr->address = entry->neighbor_main_addr;
           message_mpr->next = message->multipoint_relay_selector_address;
@@ -45,6 +45,7 @@
 #include "olsr_protocol.h"
 #include "interfaces.h"
 #include "mantissa.h"
+#include "common/arena.h"
 
 struct hello_neighbor {
   uint8_t status;
@@ -115,12 +116,13 @@ struct unknown_message {
   uint8_t type;
 };
 
+/* the messages we build for emission, reset after each emission */
+extern struct arena olsr_msg_arena;
+
 void olsr_free_hello_packet(struct hello_message *);
 
 int olsr_build_hello_packet(struct hello_message *, struct interface_olsr *);
 
-void olsr_free_tc_packet(struct tc_message *);
-
 int olsr_build_tc_packet(struct tc_message *);
 
 void olsr_free_mid_packet(struct mid_message *);
@@ -79,6 +79,12 @@ struct packetparser_function_entry *packetparser_functions;
 static uint32_t inbuf_aligned[MAXMESSAGESIZE/sizeof(uint32_t) + 1];
 static char *inbuf = (char *)inbuf_aligned;
 
+#ifdef __linux__
+/* ring of receive buffers filled by one olsr_recvfrom_batch() call */
+static uint32_t inring_aligned[OLSR_RECV_BATCH_MAX][MAXMESSAGESIZE/sizeof(uint32_t) + 1];
+static struct olsr_recv_packet inring[OLSR_RECV_BATCH_MAX];
+#endif /* __linux__ */
+
 /**
  *Initialize the parser.
  *
@@ -87,8 +93,19 @@ static char *inbuf = (char *)inbuf_aligned;
 void
 olsr_init_parser(void)
 {
+#ifdef __linux__
+  int i;
+#endif /* __linux__ */
+
   OLSR_PRINTF(3, "Initializing parser...\n");
 
+#ifdef __linux__
+  for (i = 0; i < OLSR_RECV_BATCH_MAX; i++) {
+    inring[i].buf = inring_aligned[i];
+    inring[i].buflen = sizeof(inring_aligned[i]);
+  }
+#endif /* __linux__ */
+
   /* Initialize the packet functions */
   olsr_init_package_process();
 
@@ -402,6 +419,146 @@ parse_packet(struct olsr *olsr, int size, struct interface_olsr *in_if, union ol
   }                             /* for olsr_msg */
 }
 
+/**
+ *Passes one received datagram through the preprocessors on to
+ *parse_packet().
+ *
+ *@param fd the filedescriptor the datagram was read from.
+ *@param buf the datagram
+ *@param cc length of the datagram
+ *@param from sender address
+ *@param fromlen length of the sender address
+ *
+ *@return false if reading from the socket should stop
+ */
+static bool
+olsr_input_packet(int fd, char *buf, int cc, struct sockaddr_storage *from, socklen_t fromlen)
+{
+  struct interface_olsr *olsr_in_if;
+  union olsr_ip_addr from_addr;
+  struct preprocessor_function_entry *entry;
+  struct ipaddr_str addrbuf;
+  char *packet;
+
+  if (cc <= 0) {
+    return false;
+  }
+
+  if (olsr_cnf->ip_version == AF_INET) {
+    /* IPv4 sender address */
+    void * src = &((struct sockaddr_in *)from)->sin_addr;
+    memcpy(&from_addr.v4, src, sizeof(from_addr.v4));
+  } else {
+    /* IPv6 sender address */
+    void * src = &((struct sockaddr_in6 *)from)->sin6_addr;
+    memcpy(&from_addr.v6, src, sizeof(from_addr.v6));
+  }
+
+#ifdef DEBUG
+  OLSR_PRINTF(5, "Received a packet from %s\n",
+      olsr_ip_to_string(&addrbuf, &from_addr));
+#endif /* DEBUG */
+
+  if ((olsr_cnf->ip_version == AF_INET) && (fromlen != sizeof(struct sockaddr_in)))
+    return false;
+  else if ((olsr_cnf->ip_version == AF_INET6) && (fromlen != sizeof(struct sockaddr_in6)))
+    return false;
+
+  /* are we talking to ourselves? */
+  if (if_ifwithaddr(&from_addr) != NULL)
+    return false;
+
+  if ((olsr_in_if = if_ifwithsock(fd)) == NULL) {
+    OLSR_PRINTF(1, "Could not find input interface for message from %s size %d\n", olsr_ip_to_string(&addrbuf, &from_addr), cc);
+    olsr_syslog(OLSR_LOG_ERR, "Could not find input interface for message from %s size %d\n", olsr_ip_to_string(&addrbuf, &from_addr),
+                cc);
+    return false;
+  }
+  // call preprocessors
+  entry = preprocessor_functions;
+  packet = buf;
+
+  while (entry) {
+    packet = entry->function(packet, olsr_in_if, &from_addr, &cc);
+    // discard package ?
+    if (packet == NULL) {
+      return false;
+    }
+    entry = entry->next;
+  }
+
+  /*
+   * &from - sender
+   * &inbuf.olsr
+   * cc - bytes read
+   */
+  parse_packet((struct olsr *)packet, cc, olsr_in_if, &from_addr);
+  return true;
+}
+
+static void
+olsr_input_error(void)
+{
+  if (errno != EWOULDBLOCK) {
+    OLSR_PRINTF(1, "error recvfrom: %s", strerror(errno));
+#ifndef _WIN32
+    olsr_syslog(OLSR_LOG_ERR, "error recvfrom: %m");
+#endif /* _WIN32 */
+  }
+}
+
+#ifdef __linux__
+/**
+ *Processing OLSR data from socket. Reads up to InputBatchLimit
+ *datagrams in batches with recvmmsg(2) and passes them one by
+ *one to olsr_input_packet().
+ *A datagram that is dropped does not discard the rest of its
+ *batch, but no further batch is read from the socket.
+ *
+ *@param fd the filedescriptor that data should be read from.
+ *@param data unused
+ *@param flags unused
+ */
+void
+olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
+{
+  unsigned int limit = olsr_cnf->input_batch_limit;
+
+  cpu_overload_exit = 0;
+
+  while (cpu_overload_exit < limit) {
+    unsigned int count = limit - cpu_overload_exit;
+    bool cont = true;
+    int i, n;
+
+    if (count > OLSR_RECV_BATCH_MAX) {
+      count = OLSR_RECV_BATCH_MAX;
+    }
+
+    n = olsr_recvfrom_batch(fd, inring, count);
+    if (n <= 0) {
+      if (n < 0) {
+        olsr_input_error();
+      }
+      return;
+    }
+    cpu_overload_exit += n;
+
+    for (i = 0; i < n; i++) {
+      if (!olsr_input_packet(fd, inring[i].buf, inring[i].len, &inring[i].from, inring[i].fromlen)) {
+        cont = false;
+      }
+    }
+
+    /* a short batch means the socket has been drained */
+    if (!cont || (unsigned int)n < count) {
+      return;
+    }
+  }
+
+  OLSR_PRINTF(1, "CPU overload detected, ending olsr_input() loop\n");
+}
+#else /* __linux__ */
 /**
  *Processing OLSR data from socket. Reading data, setting
  *wich interface received the message, Sends IPC(if used)
@@ -414,21 +571,15 @@ parse_packet(struct olsr *olsr, int size, struct interface_olsr *in_if, union ol
 void
 olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
 {
-  struct interface_olsr *olsr_in_if;
-  union olsr_ip_addr from_addr;
-  struct preprocessor_function_entry *entry;
-  char *packet;
-
   cpu_overload_exit = 0;
 
   for (;;) {
-    struct ipaddr_str buf;
     /* sockaddr_in6 is bigger than sockaddr !!!! */
     struct sockaddr_storage from;
     socklen_t fromlen;
     int cc;
 
-    if (32 < ++cpu_overload_exit) {
+    if (olsr_cnf->input_batch_limit < ++cpu_overload_exit) {
       OLSR_PRINTF(1, "CPU overload detected, ending olsr_input() loop\n");
       break;
     }
@@ -436,67 +587,16 @@ olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
     fromlen = sizeof(struct sockaddr_storage);
     cc = olsr_recvfrom(fd, inbuf, sizeof(inbuf_aligned), 0, (struct sockaddr *)&from, &fromlen);
 
-    if (cc <= 0) {
-      if (cc < 0 && errno != EWOULDBLOCK) {
-        OLSR_PRINTF(1, "error recvfrom: %s", strerror(errno));
-#ifndef _WIN32
-        olsr_syslog(OLSR_LOG_ERR, "error recvfrom: %m");
-#endif /* _WIN32 */
-      }
+    if (cc < 0) {
+      olsr_input_error();
       break;
     }
-    if (olsr_cnf->ip_version == AF_INET) {
-      /* IPv4 sender address */
-      void * src = &((struct sockaddr_in *)&from)->sin_addr;
-      memcpy(&from_addr.v4, src, sizeof(from_addr.v4));
-    } else {
-      /* IPv6 sender address */
-      void * src = &((struct sockaddr_in6 *)&from)->sin6_addr;
-      memcpy(&from_addr.v6, src, sizeof(from_addr.v6));
-    }
-
-#ifdef DEBUG
-    OLSR_PRINTF(5, "Received a packet from %s\n",
-        olsr_ip_to_string(&buf, &from_addr));
-#endif /* DEBUG */
-
-    if ((olsr_cnf->ip_version == AF_INET) && (fromlen != sizeof(struct sockaddr_in)))
+    if (!olsr_input_packet(fd, inbuf, cc, &from, fromlen)) {
       break;
-    else if ((olsr_cnf->ip_version == AF_INET6) && (fromlen != sizeof(struct sockaddr_in6)))
-      break;
-
-    /* are we talking to ourselves? */
-    if (if_ifwithaddr(&from_addr) != NULL)
-      return;
-
-    if ((olsr_in_if = if_ifwithsock(fd)) == NULL) {
-      OLSR_PRINTF(1, "Could not find input interface for message from %s size %d\n", olsr_ip_to_string(&buf, &from_addr), cc);
-      olsr_syslog(OLSR_LOG_ERR, "Could not find input interface for message from %s size %d\n", olsr_ip_to_string(&buf, &from_addr),
-                  cc);
-      return;
     }
-    // call preprocessors
-    entry = preprocessor_functions;
-    packet = &inbuf[0];
-
-    while (entry) {
-      packet = entry->function(packet, olsr_in_if, &from_addr, &cc);
-      // discard package ?
-      if (packet == NULL) {
-        return;
-      }
-      entry = entry->next;
-    }
-
-    /*
-     * &from - sender
-     * &inbuf.olsr
-     * cc - bytes read
-     */
-    parse_packet((struct olsr *)packet, cc, olsr_in_if, &from_addr);
-
   }
 }
+#endif /* __linux__ */
 
 /**
  *Processing OLSR data from socket. Reading data, setting
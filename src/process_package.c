@@ -47,6 +47,7 @@
 #include "two_hop_neighbor_table.h"
 #include "tc_set.h"
 #include "mpr_selector_set.h"
+#include "lq_mpr.h"
 #include "mid_set.h"
 #include "olsr.h"
 #include "parser.h"
@@ -146,6 +147,10 @@ process_message_neighbors(struct neighbor_entry *neighbor, const struct hello_me
 
           two_hop_neighbor->neighbor_2_addr = message_neighbors->address;
 
+          two_hop_neighbor->mpr_best_1hop = LINK_COST_BROKEN;
+
+          list_node_init(&two_hop_neighbor->mpr_dirty_node);
+
           olsr_insert_two_hop_neighbor_table(two_hop_neighbor);
 
           linking_this_2_entries(neighbor, two_hop_neighbor, message->vtime);
@@ -259,6 +264,8 @@ linking_this_2_entries(struct neighbor_entry *neighbor, struct neighbor_2_entry
   list_of_1_neighbors->path_linkcost = LINK_COST_BROKEN;
   list_of_1_neighbors->saved_path_linkcost = LINK_COST_BROKEN;
   list_of_1_neighbors->second_hop_linkcost = LINK_COST_BROKEN;
+  list_of_1_neighbors->mpr_path_linkcost = LINK_COST_BROKEN;
+  list_of_1_neighbors->mpr_selected = false;
 
   /* Queue */
   two_hop_neighbor->neighbor_2_nblist.next->prev = list_of_1_neighbors;
@@ -279,6 +286,8 @@ linking_this_2_entries(struct neighbor_entry *neighbor, struct neighbor_2_entry
 
   /*increment the pointer counter */
   two_hop_neighbor->neighbor_2_pointer++;
+
+  olsr_lq_mpr_mark_dirty(two_hop_neighbor);
 }
 
 /**
@@ -484,9 +493,14 @@ olsr_hello_tap(struct hello_message *message, struct interface_olsr *in_if, cons
   }
 
   /* Don't register neighbors of neighbors that announces WILL_NEVER */
-  if (neighbor->willingness != WILL_NEVER)
+  if (neighbor->willingness != WILL_NEVER) {
     process_message_neighbors(neighbor, message);
 
+    /* Queue the 2 hop neighbors whose path cost changed */
+    if (olsr_cnf->lq_level > 0)
+      olsr_lq_mpr_check_paths(neighbor);
+  }
+
   /* Process changes immediately in case of MPR updates */
   olsr_process_changes();
 
@@ -62,6 +62,11 @@ char *StrError(unsigned int ErrNo);
 
 static struct list_node chg_kernel_list;
 
+#ifdef __linux__
+/* true while route changes are queued in a netlink batch */
+static bool kernel_batch;
+#endif /* __linux__ */
+
 /**
  *
  * Calculate the kernel route flags.
@@ -125,6 +130,38 @@ olsr_delete_all_kernel_routes(void)
   olsr_update_kernel_routes();
 }
 
+/**
+ * Start collecting the kernel route changes in a netlink batch,
+ * if this is configured and the builtin route functions are in use.
+ */
+static void
+olsr_kernel_batch_begin(void)
+{
+#ifdef __linux__
+  kernel_batch = olsr_cnf->nl_batch && !olsr_cnf->host_emul
+      && olsr_addroute_function == olsr_ioctl_add_route && olsr_addroute6_function == olsr_ioctl_add_route6
+      && olsr_delroute_function == olsr_ioctl_del_route && olsr_delroute6_function == olsr_ioctl_del_route6;
+#endif /* __linux__ */
+}
+
+#ifdef __linux__
+static void olsr_kernel_batch_done(struct rt_entry *rt, bool set, int error);
+#endif /* __linux__ */
+
+/**
+ * Send the collected route changes to the kernel and process the results.
+ */
+static void
+olsr_kernel_batch_end(void)
+{
+#ifdef __linux__
+  if (kernel_batch) {
+    kernel_batch = false;
+    olsr_os_route_batch_flush(&olsr_kernel_batch_done);
+  }
+#endif /* __linux__ */
+}
+
 /**
  * Enqueue a route on a kernel add/chg/del queue.
  */
@@ -152,11 +189,36 @@ olsr_enqueue_rt(struct list_node *head_node, struct rt_entry *rt)
 }
 
 /**
- * Process a route from the kernel deletion list.
+ * Handle the result of a kernel route deletion.
  *
  *@return -1 on error, else 0
  */
 static int
+olsr_delete_kernel_route_result(struct rt_entry *rt, int error)
+{
+  if (error != 0) {
+    const char *const err_msg = strerror(error > 0 ? error : errno);
+    const char *const routestr = olsr_rt_to_string(rt);
+    OLSR_PRINTF(1, "KERN: ERROR deleting %s: %s\n", routestr, err_msg);
+
+    olsr_syslog(OLSR_LOG_ERR, "Delete route %s: %s", routestr, err_msg);
+    return -1;
+  }
+#ifdef __linux__
+  /* call NIIT handler (always)*/
+  if (olsr_cnf->use_niit) {
+    olsr_niit_handle_route(rt, false);
+  }
+#endif /* __linux__ */
+  return 0;
+}
+
+/**
+ * Process a route from the kernel deletion list.
+ *
+ *@return -1 on error, 1 if the deletion was queued in a netlink batch, else 0
+ */
+static int
 olsr_delete_kernel_route(struct rt_entry *rt)
 {
   if (rt->rt_metric.hops > 1) {
@@ -168,24 +230,46 @@ olsr_delete_kernel_route(struct rt_entry *rt)
   }
 
   if (!olsr_cnf->host_emul) {
-    int16_t error = olsr_cnf->ip_version == AF_INET ? olsr_delroute_function(rt) : olsr_delroute6_function(rt);
+#ifdef __linux__
+    if (kernel_batch && olsr_os_route_batch_add(rt, false)) {
+      return 1;
+    }
+#endif /* __linux__ */
+    return olsr_delete_kernel_route_result(rt,
+        olsr_cnf->ip_version == AF_INET ? olsr_delroute_function(rt) : olsr_delroute6_function(rt));
+  }
+  return 0;
+}
 
-    if (error != 0) {
-      const char *const err_msg = strerror(errno);
-      const char *const routestr = olsr_rt_to_string(rt);
-      OLSR_PRINTF(1, "KERN: ERROR deleting %s: %s\n", routestr, err_msg);
+/**
+ * Handle the result of a kernel route addition.
+ */
+static void
+olsr_add_kernel_route_result(struct rt_entry *rt, int error)
+{
+  if (error != 0) {
+    const char *const err_msg = strerror(error > 0 ? error : errno);
+    const char *const routestr = olsr_rtp_to_string(rt->rt_best);
+    OLSR_PRINTF(1, "KERN: ERROR adding %s: %s\n", routestr, err_msg);
+
+    olsr_syslog(OLSR_LOG_ERR, "Add route %s: %s", routestr, err_msg);
+
+    /* try again on the next RIB update */
+    olsr_rt_mark_dirty(rt);
+  } else {
+    /* route addition has suceeded */
+
+    /* save the nexthop and metric in the route entry */
+    rt->rt_nexthop = rt->rt_best->rtp_nexthop;
+    rt->rt_metric = rt->rt_best->rtp_metric;
 
-      olsr_syslog(OLSR_LOG_ERR, "Delete route %s: %s", routestr, err_msg);
-      return -1;
-    }
 #ifdef __linux__
-    /* call NIIT handler (always)*/
+    /* call NIIT handler */
     if (olsr_cnf->use_niit) {
-      olsr_niit_handle_route(rt, false);
+      olsr_niit_handle_route(rt, true);
     }
 #endif /* __linux__ */
   }
-  return 0;
 }
 
 /**
@@ -204,30 +288,39 @@ olsr_add_kernel_route(struct rt_entry *rt)
     }
   }
   if (!olsr_cnf->host_emul) {
-    int16_t error = (olsr_cnf->ip_version == AF_INET) ? olsr_addroute_function(rt) : olsr_addroute6_function(rt);
-
-    if (error != 0) {
-      const char *const err_msg = strerror(errno);
-      const char *const routestr = olsr_rtp_to_string(rt->rt_best);
-      OLSR_PRINTF(1, "KERN: ERROR adding %s: %s\n", routestr, err_msg);
-
-      olsr_syslog(OLSR_LOG_ERR, "Add route %s: %s", routestr, err_msg);
-    } else {
-      /* route addition has suceeded */
-
-      /* save the nexthop and metric in the route entry */
-      rt->rt_nexthop = rt->rt_best->rtp_nexthop;
-      rt->rt_metric = rt->rt_best->rtp_metric;
-
 #ifdef __linux__
-      /* call NIIT handler */
-      if (olsr_cnf->use_niit) {
-        olsr_niit_handle_route(rt, true);
-      }
+    if (kernel_batch && olsr_os_route_batch_add(rt, true)) {
+      return;
+    }
 #endif /* __linux__ */
+    olsr_add_kernel_route_result(rt,
+        (olsr_cnf->ip_version == AF_INET) ? olsr_addroute_function(rt) : olsr_addroute6_function(rt));
+  }
+}
+
+#ifdef __linux__
+/**
+ * Handle the result of a route change from a netlink batch.
+ */
+static void
+olsr_kernel_batch_done(struct rt_entry *rt, bool set, int error)
+{
+  if (set) {
+    olsr_add_kernel_route_result(rt, error);
+  }
+  else if (olsr_delete_kernel_route_result(rt, error) == 0) {
+    if (!rt->rt_path_tree.count) {
+      /* the route head was flushed by olsr_update_rib_routes() */
+      avl_delete(&routingtree, &rt->rt_tree_node);
+      olsr_cookie_free(rt_mem_cookie, rt);
     }
   }
+  else if (!rt->rt_path_tree.count) {
+    /* keep the route head, try again on the next RIB update */
+    olsr_rt_mark_dirty(rt);
+  }
 }
+#endif /* __linux__ */
 
 /**
  * process the kernel change list.
@@ -245,6 +338,8 @@ olsr_chg_kernel_routes(struct list_node *head_node)
     return;
   }
 
+  olsr_kernel_batch_begin();
+
   /*
    * Traverse from the beginning to the end of the list,
    * such that nexthop routes are added first.
@@ -275,72 +370,83 @@ olsr_chg_kernel_routes(struct list_node *head_node)
 
     list_remove(&rt->rt_change_node);
   }
+
+  olsr_kernel_batch_end();
 }
 
 /**
- * Check the version number of all route paths hanging off a route entry.
- * If a route does not match the current routing tree number, remove it
- * from the global originator tree for that rt_entry.
+ * Remove all route paths which were not refreshed since the last
+ * bump of the routing tree version from their route entries.
+ * They are at the head of the refresh list, so this stops at the
+ * first path of the current version.
  * Reset the best route pointer.
  */
 static void
-olsr_delete_outdated_routes(struct rt_entry *rt)
+olsr_delete_outdated_routes(void)
 {
   struct rt_path *rtp;
-  struct avl_node *rtp_tree_node, *next_rtp_tree_node;
 
-  for (rtp_tree_node = avl_walk_first(&rt->rt_path_tree); rtp_tree_node != NULL; rtp_tree_node = next_rtp_tree_node) {
-    /*
-     * pre-fetch the next node before loosing context.
-     */
-    next_rtp_tree_node = avl_walk_next(rtp_tree_node);
-
-    rtp = rtp_tree2rtp(rtp_tree_node);
+  while (!list_is_empty(&rtp_refresh_list)) {
+    rtp = refreshlist2rtp(rtp_refresh_list.next);
 
     /*
      * check the version number which gets incremented on every SPF run.
      * comparing for unequalness avoids handling version number wraps.
      */
-    if (routingtree_version != rtp->rtp_version) {
-      /* remove from the originator tree */
-      avl_delete(&rt->rt_path_tree, rtp_tree_node);
-      rtp->rtp_rt = NULL;
+    if (routingtree_version == rtp->rtp_version) {
+      break;
+    }
 
-      if (rt->rt_best == rtp) {
-        rt->rt_best = NULL;
-      }
+    if (rtp->rtp_rt->rt_best == rtp) {
+      rtp->rtp_rt->rt_best = NULL;
     }
+
+    /* remove from the originator tree */
+    olsr_rt_unlink_path(rtp);
   }
 }
 
 /**
- * Walk all the routes, remove outdated routes and run
- * best path selection on the remaining set.
+ * Remove outdated routes and run best path selection on the
+ * route entries whose set of paths changed.
  * Finally compare the nexthop of the route head and the best
  * path and enqueue an add/chg operation.
  */
 void
 olsr_update_rib_routes(void)
 {
+  struct list_node retry_list;
   struct rt_entry *rt;
+  unsigned int changed = 0;
 
   OLSR_PRINTF(3, "Updating kernel routes...\n");
 
-  /* walk all routes in the RIB. */
+  olsr_kernel_batch_begin();
 
-  OLSR_FOR_ALL_RT_ENTRIES(rt) {
+  /* eliminate first unused routes */
+  olsr_delete_outdated_routes();
 
-    /* eliminate first unused routes */
-    olsr_delete_outdated_routes(rt);
+  list_head_init(&retry_list);
+
+  /* walk the changed routes in the RIB. */
+
+  while (!list_is_empty(&rt_dirty_list)) {
+    rt = dirtylist2rt(rt_dirty_list.next);
+    list_remove(&rt->rt_dirty_node);
+    changed++;
 
     if (!rt->rt_path_tree.count) {
+      int res;
 
       /* oops, all routes are gone - flush the route head */
-  
-      if (olsr_delete_kernel_route(rt) == 0) {
+      res = olsr_delete_kernel_route(rt);
+      if (res == 0) {
         /*only remove if deletion was successful*/
         avl_delete(&routingtree, &rt->rt_tree_node);
         olsr_cookie_free(rt_mem_cookie, rt);
+      } else if (res < 0) {
+        /* keep the route head, try again on the next RIB update */
+        list_add_before(&retry_list, &rt->rt_dirty_node);
       }
 
       continue;
@@ -357,7 +463,13 @@ olsr_update_rib_routes(void)
         olsr_enqueue_rt(&chg_kernel_list, rt);
     }
   }
-  OLSR_FOR_ALL_RT_ENTRIES_END(rt);
+
+  list_merge(&rt_dirty_list, &retry_list);
+
+  OLSR_PRINTF(3, "RIB: %u of %u routes changed\n", changed, routingtree.count);
+
+  /* route heads with a queued deletion are flushed here */
+  olsr_kernel_batch_end();
 }
 
 void
@@ -382,8 +494,7 @@ olsr_delete_interface_routes(int if_index) {
       /* nexthop use lost interface ? */
       if (rtp->rtp_nexthop.iif_index == if_index) {
         /* remove from the originator tree */
-        avl_delete(&rt->rt_path_tree, rtp_tree_node);
-        rtp->rtp_rt = NULL;
+        olsr_rt_unlink_path(rtp);
 
         if (rt->rt_best == rtp) {
           rt->rt_best = NULL;
@@ -396,6 +507,7 @@ olsr_delete_interface_routes(int if_index) {
       if (!rt->rt_path_tree.count) {
         /* oops, all routes are gone - flush the route head */
         avl_delete(&routingtree, rt_tree_node);
+        list_remove(&rt->rt_dirty_node);
 
         /* do not dequeue route because they are already gone */
       }
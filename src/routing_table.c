@@ -77,6 +77,26 @@ struct avl_tree routingtree;
  */
 unsigned int routingtree_version;
 
+/*
+ * Route entries whose paths changed since the last RIB update,
+ * only these need a new best path election.
+ */
+struct list_node rt_dirty_list;
+
+/*
+ * All rt_paths in the RIB ordered by the time of their last refresh.
+ * Paths which were not refreshed since the last version bump are
+ * at the head of the list.
+ */
+struct list_node rtp_refresh_list;
+
+/*
+ * rt_paths which are not in the RIB, because they are new or were
+ * removed from it. The next SPF run inserts those whose originator
+ * is reachable, even if an incremental run did not touch it.
+ */
+struct list_node rtp_pending_list;
+
 /**
  * Bump the version number of the routing tree.
  *
@@ -172,6 +192,9 @@ olsr_init_routing_table(void)
   /* the routing tree */
   avl_init(&routingtree, avl_comp_prefix_default);
   routingtree_version = 0;
+  list_head_init(&rt_dirty_list);
+  list_head_init(&rtp_refresh_list);
+  list_head_init(&rtp_pending_list);
 
   /*
    * Get some cookies for memory stats and memory recycling.
@@ -205,8 +228,42 @@ olsr_lookup_routing_table(const union olsr_ip_addr *dst)
   return rt_tree_node ? rt_tree2rt(rt_tree_node) : NULL;
 }
 
+/**
+ * Queue a route entry for best path election
+ * in the next olsr_update_rib_routes() run.
+ */
+void
+olsr_rt_mark_dirty(struct rt_entry *rt)
+{
+  if (!list_node_on_list(&rt->rt_dirty_node)) {
+    list_add_before(&rt_dirty_list, &rt->rt_dirty_node);
+  }
+}
+
+/**
+ * Remove a rt_path from the originator tree of its route entry
+ * and queue the route entry for best path election.
+ * The rt_path waits on the pending list for its next insertion.
+ * The caller has to take care of the best path pointer.
+ */
+void
+olsr_rt_unlink_path(struct rt_path *rtp)
+{
+  struct rt_entry *rt = rtp->rtp_rt;
+
+  avl_delete(&rt->rt_path_tree, &rtp->rtp_tree_node);
+  rtp->rtp_rt = NULL;
+
+  if (list_node_on_list(&rtp->rtp_refresh_node)) {
+    list_remove(&rtp->rtp_refresh_node);
+  }
+  list_add_before(&rtp_pending_list, &rtp->rtp_refresh_node);
+  olsr_rt_mark_dirty(rt);
+}
+
 /**
  * Update gateway/interface/etx/hopcount and the version for a route path.
+ * The route entry is queued for best path election if any of them changed.
  */
 void
 olsr_update_rt_path(struct rt_path *rtp, struct tc_entry *tc, struct link_entry *link)
@@ -214,6 +271,17 @@ olsr_update_rt_path(struct rt_path *rtp, struct tc_entry *tc, struct link_entry
 
   rtp->rtp_version = routingtree_version;
 
+  /* move to the tail of the refreshed paths */
+  if (list_node_on_list(&rtp->rtp_refresh_node)) {
+    list_remove(&rtp->rtp_refresh_node);
+  }
+  list_add_before(&rtp_refresh_list, &rtp->rtp_refresh_node);
+
+  if (!ipequal(&rtp->rtp_nexthop.gateway, &link->neighbor_iface_addr) || rtp->rtp_nexthop.iif_index != link->inter->if_index
+      || rtp->rtp_metric.hops != tc->hops || rtp->rtp_metric.cost != tc->path_cost) {
+    olsr_rt_mark_dirty(rtp->rtp_rt);
+  }
+
   /* gateway */
   rtp->rtp_nexthop.gateway = link->neighbor_iface_addr;
 
@@ -282,6 +350,9 @@ olsr_alloc_rt_path(struct tc_entry *tc, struct olsr_ip_prefix *prefix, uint8_t o
   /* store the origin of the route */
   rtp->rtp_origin = origin;
 
+  /* not in the RIB yet */
+  list_add_before(&rtp_pending_list, &rtp->rtp_refresh_node);
+
   return rtp;
 }
 
@@ -338,6 +409,7 @@ olsr_insert_rt_path(struct rt_path *rtp, struct tc_entry *tc, struct link_entry
 
   /* backlink to the owning route entry */
   rtp->rtp_rt = rt;
+  olsr_rt_mark_dirty(rt);
 
   /* update the version field and relevant parameters */
   olsr_update_rt_path(rtp, tc, link);
@@ -352,8 +424,10 @@ olsr_delete_rt_path(struct rt_path *rtp)
 
   /* remove from the originator tree */
   if (rtp->rtp_rt) {
-    avl_delete(&rtp->rtp_rt->rt_path_tree, &rtp->rtp_tree_node);
-    rtp->rtp_rt = NULL;
+    olsr_rt_unlink_path(rtp);
+  }
+  if (list_node_on_list(&rtp->rtp_refresh_node)) {
+    list_remove(&rtp->rtp_refresh_node);
   }
 
   /* remove from the tc prefix tree */
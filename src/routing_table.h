@@ -84,10 +84,12 @@ struct rt_entry {
   struct rt_metric rt_metric;          /* metric of FIB route */
   struct avl_tree rt_path_tree;
   struct list_node rt_change_node;     /* queue for kernel FIB add/chg/del */
+  struct list_node rt_dirty_node;      /* queue for best path election */
 };
 
 AVLNODE2STRUCT(rt_tree2rt, struct rt_entry, rt_tree_node);
 LISTNODE2STRUCT(changelist2rt, struct rt_entry, rt_change_node);
+LISTNODE2STRUCT(dirtylist2rt, struct rt_entry, rt_dirty_node);
 
 /*
  * For every received route a rt_path is added to the RIB.
@@ -107,10 +109,12 @@ struct rt_path {
   struct avl_node rtp_prefix_tree_node; /* tc entry rtp node */
   struct olsr_ip_prefix rtp_dst;       /* the prefix */
   uint32_t rtp_version;                /* for detection of outdated rt_paths */
+  struct list_node rtp_refresh_node;   /* RIB paths, least recently refreshed first, or pending */
   uint8_t rtp_origin;                  /* internal, MID or HNA */
 };
 
 AVLNODE2STRUCT(rtp_tree2rtp, struct rt_path, rtp_tree_node);
+LISTNODE2STRUCT(refreshlist2rtp, struct rt_path, rtp_refresh_node);
 AVLNODE2STRUCT(rtp_prefix_tree2rtp, struct rt_path, rtp_prefix_tree_node);
 
 /*
@@ -189,6 +193,9 @@ union olsr_kernel_route {
 
 extern struct avl_tree routingtree;
 extern unsigned int routingtree_version;
+extern struct list_node rt_dirty_list;
+extern struct list_node rtp_refresh_list;
+extern struct list_node rtp_pending_list;
 extern struct olsr_cookie_info *rt_mem_cookie;
 
 void olsr_init_routing_table(void);
@@ -199,6 +206,8 @@ int avl_comp_ipv4_prefix(const void *, const void *);
 int avl_comp_ipv6_prefix(const void *, const void *);
 
 void olsr_rt_best(struct rt_entry *);
+void olsr_rt_mark_dirty(struct rt_entry *);
+void olsr_rt_unlink_path(struct rt_path *);
 bool olsr_nh_change(const struct rt_nexthop *, const struct rt_nexthop *);
 bool olsr_hopcount_change(const struct rt_metric *, const struct rt_metric *);
 bool olsr_cmp_rt(const struct rt_entry *, const struct rt_entry *);
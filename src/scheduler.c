@@ -45,6 +45,7 @@
 #include "olsr.h"
 #include "olsr_cookie.h"
 #include "net_os.h"
+#include "net_olsr.h"
 #include "mpr_selector_set.h"
 #include "olsr_random.h"
 
@@ -53,6 +54,10 @@
 #include <unistd.h>
 #include <assert.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif /* __linux__ */
+
 #ifdef _WIN32
 #define close(x) closesocket(x)
 #endif /* _WIN32 */
@@ -62,9 +67,15 @@ uint32_t now_times;                    /* relative time compared to startup (in
 struct timeval first_tv;               /* timevalue during startup */
 struct timeval last_tv;                /* timevalue used for last olsr_times() calculation */
 
-/* Hashed root of all timers */
-static struct list_node timer_wheel[TIMER_WHEEL_SLOTS];
-static uint32_t timer_last_run;        /* remember the last timeslot walk */
+/* Hashed root of all timers, level 0 and the higher levels of the wheel */
+static struct list_node timer_wheel0[TIMER_WHEEL_SLOTS0];
+static struct list_node timer_wheel[TIMER_WHEEL_LEVELS - 1][TIMER_WHEEL_SLOTS];
+
+/* bitmaps of the slots that might be non-empty, cleared lazily */
+static uint64_t timer_map0[TIMER_WHEEL_SLOTS0 / 64];
+static uint64_t timer_map[TIMER_WHEEL_LEVELS - 1];
+
+static uint32_t timer_wheel_clock;     /* next clocktick the timer walk has to process */
 
 /* Memory cookie for the block based memory manager */
 static struct olsr_cookie_info *timer_mem_cookie = NULL;
@@ -72,8 +83,34 @@ static struct olsr_cookie_info *timer_mem_cookie = NULL;
 /* Head of all OLSR used sockets */
 static struct list_node socket_head = { &socket_head, &socket_head };
 
+/* number of sockets marked as deleted, but not yet freed */
+static unsigned int socket_removed;
+
+#ifdef __linux__
+/* maximum number of events fetched by one epoll_wait(2) */
+#define SCHED_EPOLL_EVENTS 64
+
+/*
+ * The sockets are kept registered in two epoll sets, one for the pollrate
+ * and one for the immediate handlers, so every loop only has to look at
+ * the sockets that are ready. If epoll fails we fall back to select(2).
+ */
+static int epoll_pr_fd = -1, epoll_imm_fd = -1;
+static unsigned int epoll_pr_count, epoll_imm_count;
+static bool epoll_disabled;
+
+/*
+ * The pollrate set is part of the immediate set as a oneshot event, so
+ * the main loop notices pending pollrate sockets while it sleeps.
+ */
+static bool epoll_pr_wakeup;
+#endif /* __linux__ */
+
 /* Prototypes */
-static void walk_timers(uint32_t *);
+static void walk_timers(void);
+#ifdef __linux__
+static uint32_t olsr_timer_next_due(uint32_t limit);
+#endif /* __linux__ */
 static void poll_sockets(void);
 static uint32_t calc_jitter(unsigned int rel_time, uint8_t jitter_pct, unsigned int random_val);
 
@@ -163,6 +200,232 @@ olsr_isTimedOut(uint32_t s)
   return now_times - s <= (1u << 31);
 }
 
+#ifdef __linux__
+/**
+ * Stop using epoll, the main loop falls back to select(2)
+ */
+static void
+olsr_epoll_disable(void)
+{
+  struct olsr_socket_entry *entry;
+
+  if (epoll_pr_fd >= 0) {
+    close(epoll_pr_fd);
+  }
+  if (epoll_imm_fd >= 0) {
+    close(epoll_imm_fd);
+  }
+  epoll_pr_fd = epoll_imm_fd = -1;
+  epoll_disabled = true;
+
+  OLSR_FOR_ALL_SOCKETS(entry) {
+    entry->epoll_flags = 0;
+  }
+  OLSR_FOR_ALL_SOCKETS_END(entry);
+}
+
+/**
+ * Create the epoll sets on first use
+ *
+ *@return true if epoll can be used
+ */
+static bool
+olsr_epoll_init(void)
+{
+  struct epoll_event ev;
+
+  if (epoll_disabled) {
+    return false;
+  }
+  if (epoll_pr_fd >= 0) {
+    return true;
+  }
+
+  epoll_pr_fd = epoll_create1(EPOLL_CLOEXEC);
+  epoll_imm_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_pr_fd < 0 || epoll_imm_fd < 0) {
+    OLSR_PRINTF(1, "epoll_create error: %s, using select\n", strerror(errno));
+    olsr_epoll_disable();
+    return false;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.ptr = NULL;
+  if (epoll_ctl(epoll_imm_fd, EPOLL_CTL_ADD, epoll_pr_fd, &ev) < 0) {
+    OLSR_PRINTF(1, "epoll_ctl error: %s, using select\n", strerror(errno));
+    olsr_epoll_disable();
+    return false;
+  }
+  epoll_pr_wakeup = false;
+  return true;
+}
+
+/**
+ * Rearm the wakeup of the main loop by the pollrate sockets
+ */
+static void
+olsr_epoll_rearm(void)
+{
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.ptr = NULL;
+  if (epoll_ctl(epoll_imm_fd, EPOLL_CTL_MOD, epoll_pr_fd, &ev) < 0) {
+    OLSR_PRINTF(1, "epoll_ctl error: %s, using select\n", strerror(errno));
+    olsr_epoll_disable();
+    return;
+  }
+  epoll_pr_wakeup = false;
+}
+
+/**
+ * Change the registration of a socket in one epoll set
+ *
+ *@param epfd the epoll set
+ *@param entry the socket entry
+ *@param old the flags registered so far
+ *@param want the flags to register
+ *@param rd the read flag of this set
+ *@param wr the write flag of this set
+ *@return false if epoll_ctl(2) failed
+ */
+static bool
+olsr_epoll_ctl(int epfd, struct olsr_socket_entry *entry, unsigned int old, unsigned int want, unsigned int rd, unsigned int wr)
+{
+  struct epoll_event ev;
+  int op;
+
+  if (old == want) {
+    return true;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.data.ptr = entry;
+  if (want & rd) {
+    ev.events |= EPOLLIN;
+  }
+  if (want & wr) {
+    ev.events |= EPOLLOUT;
+  }
+
+  op = old == 0 ? EPOLL_CTL_ADD : want == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+  if (epoll_ctl(epfd, op, entry->fd, &ev) == 0) {
+    return true;
+  }
+  if (op == EPOLL_CTL_DEL && (errno == EBADF || errno == ENOENT)) {
+    /* socket was closed before it was removed, the kernel dropped it already */
+    return true;
+  }
+
+  OLSR_PRINTF(1, "epoll_ctl error on socket %d: %s, using select\n", entry->fd, strerror(errno));
+  return false;
+}
+
+/**
+ * Bring the epoll registration of a socket in sync with its
+ * handlers and flags
+ */
+static void
+olsr_epoll_update(struct olsr_socket_entry *entry)
+{
+  unsigned int want = 0;
+
+  if (!olsr_epoll_init()) {
+    return;
+  }
+
+  if (entry->process_pollrate != NULL) {
+    want |= entry->flags & (SP_PR_READ | SP_PR_WRITE);
+  }
+  if (entry->process_immediate != NULL) {
+    want |= entry->flags & (SP_IMM_READ | SP_IMM_WRITE);
+  }
+
+  if (!olsr_epoll_ctl(epoll_pr_fd, entry, entry->epoll_flags & (SP_PR_READ | SP_PR_WRITE),
+        want & (SP_PR_READ | SP_PR_WRITE), SP_PR_READ, SP_PR_WRITE)
+      || !olsr_epoll_ctl(epoll_imm_fd, entry, entry->epoll_flags & (SP_IMM_READ | SP_IMM_WRITE),
+        want & (SP_IMM_READ | SP_IMM_WRITE), SP_IMM_READ, SP_IMM_WRITE)) {
+    olsr_epoll_disable();
+    return;
+  }
+
+  /* keep track of the number of sockets in each set */
+  if ((entry->epoll_flags & (SP_PR_READ | SP_PR_WRITE)) != 0) {
+    epoll_pr_count--;
+  }
+  if ((want & (SP_PR_READ | SP_PR_WRITE)) != 0) {
+    epoll_pr_count++;
+  }
+  if ((entry->epoll_flags & (SP_IMM_READ | SP_IMM_WRITE)) != 0) {
+    epoll_imm_count--;
+  }
+  if ((want & (SP_IMM_READ | SP_IMM_WRITE)) != 0) {
+    epoll_imm_count++;
+  }
+  entry->epoll_flags = want;
+}
+
+/**
+ * Wait for ready sockets in an epoll set and call their handlers
+ *
+ *@param epfd the epoll set
+ *@param timeout the maximum time to wait in milliseconds
+ *@param immediate true for the immediate handlers, false for the pollrate ones
+ *@return the number of ready sockets, 0 on timeout, -1 on error
+ */
+static int
+olsr_epoll_dispatch(int epfd, int timeout, bool immediate)
+{
+  struct epoll_event events[SCHED_EPOLL_EVENTS];
+  unsigned int rd = immediate ? SP_IMM_READ : SP_PR_READ;
+  unsigned int wr = immediate ? SP_IMM_WRITE : SP_PR_WRITE;
+  int i, n;
+
+  do {
+    n = epoll_wait(epfd, events, SCHED_EPOLL_EVENTS, timeout);
+  } while (n == -1 && errno == EINTR);
+
+  if (n == -1) {
+    OLSR_PRINTF(1, "epoll_wait error: %s", strerror(errno));
+  }
+  if (n <= 0) {
+    return n;
+  }
+
+  /* Update time since this is much used by the parsing functions */
+  now_times = olsr_times();
+  for (i = 0; i < n; i++) {
+    struct olsr_socket_entry *entry = events[i].data.ptr;
+    socket_handler_func func;
+    unsigned int flags = 0;
+
+    if (entry == NULL) {
+      /* pollrate sockets are ready, see poll_sockets() */
+      epoll_pr_wakeup = true;
+      continue;
+    }
+
+    func = immediate ? entry->process_immediate : entry->process_pollrate;
+    if (func == NULL) {
+      /* removed by one of the handlers before */
+      continue;
+    }
+    if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+      flags |= entry->flags & rd;
+    }
+    if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+      flags |= entry->flags & wr;
+    }
+    if (flags != 0) {
+      func(entry->fd, entry->data, flags);
+    }
+  }
+  return n;
+}
+#endif /* __linux__ */
+
 /**
  * Add a socket and handler to the socketset
  * beeing used in the main select(2) loop
@@ -192,10 +455,15 @@ add_olsr_socket(int fd, socket_handler_func pf_pr, socket_handler_func pf_imm, v
   new_entry->process_pollrate = pf_pr;
   new_entry->data = data;
   new_entry->flags = flags;
+  new_entry->epoll_flags = 0;
 
   /* Queue */
   list_node_init(&new_entry->socket_node);
   list_add_before(&socket_head, &new_entry->socket_node);
+
+#ifdef __linux__
+  olsr_epoll_update(new_entry);
+#endif /* __linux__ */
 }
 
 /**
@@ -224,6 +492,10 @@ remove_olsr_socket(int fd, socket_handler_func pf_pr, socket_handler_func pf_imm
       entry->process_immediate = NULL;
       entry->process_pollrate = NULL;
       entry->flags = 0;
+      socket_removed++;
+#ifdef __linux__
+      olsr_epoll_update(entry);
+#endif /* __linux__ */
       return 1;
     }
   }
@@ -239,6 +511,9 @@ enable_olsr_socket(int fd, socket_handler_func pf_pr, socket_handler_func pf_imm
   OLSR_FOR_ALL_SOCKETS(entry) {
     if (entry->fd == fd && entry->process_immediate == pf_imm && entry->process_pollrate == pf_pr) {
       entry->flags |= flags;
+#ifdef __linux__
+      olsr_epoll_update(entry);
+#endif /* __linux__ */
     }
   }
   OLSR_FOR_ALL_SOCKETS_END(entry);
@@ -252,6 +527,9 @@ disable_olsr_socket(int fd, socket_handler_func pf_pr, socket_handler_func pf_im
   OLSR_FOR_ALL_SOCKETS(entry) {
     if (entry->fd == fd && entry->process_immediate == pf_imm && entry->process_pollrate == pf_pr) {
       entry->flags &= ~flags;
+#ifdef __linux__
+      olsr_epoll_update(entry);
+#endif /* __linux__ */
     }
   }
   OLSR_FOR_ALL_SOCKETS_END(entry);
@@ -270,6 +548,15 @@ olsr_flush_sockets(void)
     list_remove(&entry->socket_node);
     free(entry);
   } OLSR_FOR_ALL_SOCKETS_END(entry);
+
+#ifdef __linux__
+  if (epoll_pr_fd >= 0) {
+    close(epoll_pr_fd);
+    close(epoll_imm_fd);
+    epoll_pr_fd = epoll_imm_fd = -1;
+  }
+  epoll_pr_count = epoll_imm_count = 0;
+#endif /* __linux__ */
 }
 
 static void
@@ -281,6 +568,18 @@ poll_sockets(void)
   struct timeval tvp = { 0, 0 };
   int hfd = 0, fdsets = 0;
 
+#ifdef __linux__
+  if (!epoll_disabled) {
+    if (epoll_pr_count > 0) {
+      olsr_epoll_dispatch(epoll_pr_fd, 0, false);
+    }
+    if (epoll_pr_wakeup) {
+      olsr_epoll_rearm();
+    }
+    return;
+  }
+#endif /* __linux__ */
+
   /* If there are no registered sockets we
    * do not call select(2)
    */
@@ -345,16 +644,14 @@ poll_sockets(void)
 }
 
 static void
-handle_fds(uint32_t next_interval)
+handle_fds_select(uint32_t next_interval)
 {
   struct olsr_socket_entry *entry;
   struct timeval tvp;
   int32_t remaining;
 
-  /* calculate the first timeout */
-  now_times = olsr_times();
-
   remaining = TIME_DUE(next_interval);
+
   if (remaining <= 0) {
     /* we are already over the interval */
     if (list_is_empty(&socket_head)) {
@@ -442,6 +739,73 @@ handle_fds(uint32_t next_interval)
     tvp.tv_sec = remaining / MSEC_PER_SEC;
     tvp.tv_usec = (remaining % MSEC_PER_SEC) * USEC_PER_MSEC;
   }
+}
+
+#ifdef __linux__
+/**
+ * Calculate until when the main loop may sleep. It never wakes up before
+ * the end of the poll interval, but sleeps past it until the next timer
+ * is due if there is nothing else to do.
+ */
+static uint32_t
+handle_fds_deadline(uint32_t next_interval)
+{
+  uint32_t timer_due;
+
+  if (epoll_pr_wakeup || link_changes
+      || changes_neighborhood || changes_topology || changes_hna || changes_force) {
+    return next_interval;
+  }
+  timer_due = olsr_timer_next_due(GET_TIMESTAMP(INT32_MAX / 2));
+  return (int32_t)(timer_due - next_interval) > 0 ? timer_due : next_interval;
+}
+
+static void
+handle_fds_epoll(uint32_t next_interval)
+{
+  uint32_t deadline = handle_fds_deadline(next_interval);
+  int32_t remaining = TIME_DUE(deadline);
+
+  /* do at least one epoll_wait() if there are sockets */
+  while (remaining > 0 || epoll_imm_count > 0) {
+    if (olsr_epoll_dispatch(epoll_imm_fd, remaining > 0 ? remaining : 0, true) <= 0) {
+      /* timeout or error */
+      break;
+    }
+
+    /* calculate the next timeout */
+    deadline = handle_fds_deadline(next_interval);
+    remaining = TIME_DUE(deadline);
+    if (remaining <= 0) {
+      /* we are already over the interval */
+      break;
+    }
+  }
+}
+#endif /* __linux__ */
+
+static void
+handle_fds(uint32_t next_interval)
+{
+  struct olsr_socket_entry *entry;
+
+  /* calculate the first timeout */
+  now_times = olsr_times();
+
+#ifdef __linux__
+  if (olsr_epoll_init()) {
+    handle_fds_epoll(next_interval);
+  } else {
+    handle_fds_select(next_interval);
+  }
+#else /* __linux__ */
+  handle_fds_select(next_interval);
+#endif /* __linux__ */
+
+  if (socket_removed == 0) {
+    return;
+  }
+  socket_removed = 0;
 
   OLSR_FOR_ALL_SOCKETS(entry) {
     if (entry->process_immediate == NULL && entry->process_pollrate == NULL) {
@@ -480,8 +844,10 @@ olsr_scheduler(void)
     /* Read incoming data */
     poll_sockets();
 
-    /* Process timers */
-    walk_timers(&timer_last_run);
+    /* Process timers, the packets they generate are sent together */
+    net_output_hold();
+    walk_timers();
+    net_output_release();
 
     /* Update */
     olsr_process_changes();
@@ -553,117 +919,281 @@ olsr_init_timers(void)
   last_tv = first_tv;
   now_times = olsr_times();
 
-  for (idx = 0; idx < TIMER_WHEEL_SLOTS; idx++) {
-    list_head_init(&timer_wheel[idx]);
+  for (idx = 0; idx < TIMER_WHEEL_SLOTS0; idx++) {
+    list_head_init(&timer_wheel0[idx]);
   }
+  for (idx = 0; idx < (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_SLOTS; idx++) {
+    list_head_init(&timer_wheel[idx / TIMER_WHEEL_SLOTS][idx % TIMER_WHEEL_SLOTS]);
+  }
+  memset(timer_map0, 0, sizeof(timer_map0));
+  memset(timer_map, 0, sizeof(timer_map));
 
   /*
    * Reset the last timer run.
    */
-  timer_last_run = now_times;
+  timer_wheel_clock = now_times;
 
   /* Allocate a cookie for the block based memeory manager. */
   timer_mem_cookie = olsr_alloc_cookie("timer_entry", OLSR_COOKIE_TYPE_MEMORY);
   olsr_cookie_set_memory_size(timer_mem_cookie, sizeof(struct timer_entry));
 }
 
+/* shift of the slot index of a wheel level, level >= 1 */
+#define TIMER_WHEEL_SHIFT(level) (TIMER_WHEEL_BITS0 + ((level) - 1) * TIMER_WHEEL_BITS)
+
 /**
- * Walk through the timer list and check if any timer is ready to fire.
- * Callback the provided function with the context pointer.
+ * Hash a timer into the timer wheel, relative to the current
+ * position of the wheel.
  */
 static void
-walk_timers(uint32_t * last_run)
+olsr_timer_insert(struct timer_entry *timer)
 {
-  unsigned int total_timers_walked = 0, total_timers_fired = 0;
-  unsigned int wheel_slot_walks = 0;
+  uint32_t delta = timer->timer_clock - timer_wheel_clock;
+  unsigned int level, idx;
+
+  if ((int32_t)delta < TIMER_WHEEL_SLOTS0) {
+    /* timers that are already due fire with the next walk */
+    idx = ((int32_t)delta < 0 ? timer_wheel_clock : timer->timer_clock) & TIMER_WHEEL_MASK0;
+    timer_map0[idx / 64] |= (uint64_t)1 << (idx % 64);
+    list_add_before(&timer_wheel0[idx], &timer->timer_list);
+    return;
+  }
+
+  for (level = 1; level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << TIMER_WHEEL_SHIFT(level + 1)); level++);
+
+  idx = (timer->timer_clock >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK;
+  timer_map[level - 1] |= (uint64_t)1 << idx;
+  list_add_before(&timer_wheel[level - 1][idx], &timer->timer_list);
+}
+
+/**
+ * Move the timers of a slot one or more levels down the wheel.
+ *
+ * @return the index of the cascaded slot
+ */
+static unsigned int
+olsr_timer_cascade(unsigned int level)
+{
+  unsigned int idx = (timer_wheel_clock >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK;
+  struct list_node *const timer_head_node = &timer_wheel[level - 1][idx];
+  struct list_node tmp_head_node;
+
+  list_head_init(&tmp_head_node);
+  list_merge(&tmp_head_node, timer_head_node);
+  timer_map[level - 1] &= ~((uint64_t)1 << idx);
+
+  while (!list_is_empty(&tmp_head_node)) {
+    struct list_node *const timer_node = tmp_head_node.next;
+
+    list_remove(timer_node);
+    olsr_timer_insert(list2timer(timer_node));
+  }
+  return idx;
+}
+
+/**
+ * Calculate the earliest time the next timer may fire. For timers on
+ * the higher levels of the wheel this is the start of their slot.
+ *
+ * @return the time relative to timer_wheel_clock, UINT32_MAX if no timer is running
+ */
+static uint32_t
+olsr_timer_next_delta(void)
+{
+  unsigned int idx0 = timer_wheel_clock & TIMER_WHEEL_MASK0;
+  unsigned int level, word;
+  uint64_t best = UINT32_MAX;
+
+  /* level 0 is exact, scan its slots starting at the current one */
+  for (word = 0; word <= TIMER_WHEEL_SLOTS0 / 64 && best == UINT32_MAX; word++) {
+    unsigned int w = (idx0 / 64 + word) % (TIMER_WHEEL_SLOTS0 / 64);
+    uint64_t bits = timer_map0[w];
+
+    if (word == 0) {
+      bits &= ~(uint64_t)0 << (idx0 % 64);
+    } else if (word == TIMER_WHEEL_SLOTS0 / 64) {
+      bits &= ~(~(uint64_t)0 << (idx0 % 64));
+    }
+
+    while (bits) {
+      unsigned int idx = w * 64 + __builtin_ctzll(bits);
+
+      bits &= bits - 1;
+      if (list_is_empty(&timer_wheel0[idx])) {
+        timer_map0[w] &= ~((uint64_t)1 << (idx % 64));
+        continue;
+      }
+      best = (idx - idx0) & TIMER_WHEEL_MASK0;
+      break;
+    }
+  }
 
   /*
-   * Check the required wheel slots since the last time a timer walk was invoked,
-   * or check *all* the wheel slots, whatever is less work.
-   * The latter is meant as a safety belt if the scheduler falls behind.
+   * The higher levels give a lower bound, the start of the first used
+   * slot. It might come before the next level 0 timer, the walk must not
+   * skip the cascade.
    */
-  while ((*last_run <= now_times) && (wheel_slot_walks < TIMER_WHEEL_SLOTS)) {
-    struct list_node tmp_head_node;
-    /* keep some statistics */
-    unsigned int timers_walked = 0, timers_fired = 0;
+  for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+    uint32_t span = 1u << TIMER_WHEEL_SHIFT(level);
+    uint32_t start = (timer_wheel_clock + span - 1) & ~(span - 1);
+    unsigned int first = (start >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK;
+    uint64_t bits = timer_map[level - 1];
+
+    /* rotate the bitmap so that bit 0 is the next slot to cascade */
+    bits = first ? (bits >> first) | (bits << (TIMER_WHEEL_SLOTS - first)) : bits;
+
+    while (bits) {
+      unsigned int offset = __builtin_ctzll(bits);
+      unsigned int idx = (first + offset) & TIMER_WHEEL_MASK;
+
+      bits &= bits - 1;
+      if (list_is_empty(&timer_wheel[level - 1][idx])) {
+        timer_map[level - 1] &= ~((uint64_t)1 << idx);
+        continue;
+      }
+      if ((uint64_t)(start - timer_wheel_clock) + (uint64_t)offset * span < best) {
+        best = (uint64_t)(start - timer_wheel_clock) + (uint64_t)offset * span;
+      }
+      break;
+    }
+  }
+  return (uint32_t)best;
+}
 
-    /* Get the hash slot for this clocktick */
-    struct list_node *const timer_head_node = &timer_wheel[*last_run & TIMER_WHEEL_MASK];
+/**
+ * Fire all timers of the level 0 slot of the current clocktick.
+ *
+ * @return the number of fired timers
+ */
+static unsigned int
+olsr_timer_fire_slot(void)
+{
+  unsigned int idx = timer_wheel_clock & TIMER_WHEEL_MASK0;
+  struct list_node *const timer_head_node = &timer_wheel0[idx];
+  struct list_node pending_head_node, tmp_head_node;
+  unsigned int timers_fired = 0;
 
-    /* Walk all entries hanging off this hash bucket. We treat this basically as a stack
-     * so that we always know if and where the next element is.
+  /*
+   * Take the whole slot and advance the clock first, timers started
+   * by the callbacks are hashed into the next slots.
+   */
+  list_head_init(&pending_head_node);
+  list_merge(&pending_head_node, timer_head_node);
+  timer_map0[idx / 64] &= ~((uint64_t)1 << (idx % 64));
+  timer_wheel_clock++;
+
+  /* Walk all entries of this slot. We treat this basically as a stack
+   * so that we always know if and where the next element is.
+   */
+  list_head_init(&tmp_head_node);
+  while (!list_is_empty(&pending_head_node)) {
+    /* the top element */
+    struct list_node *const timer_node = pending_head_node.next;
+    struct timer_entry *const timer = list2timer(timer_node);
+
+    /*
+     * Dequeue and insert to a temporary list.
+     * We do this to avoid loosing our walking context when
+     * multiple timers fire.
      */
-    list_head_init(&tmp_head_node);
-    while (!list_is_empty(timer_head_node)) {
-      /* the top element */
-      struct list_node *const timer_node = timer_head_node->next;
-      struct timer_entry *const timer = list2timer(timer_node);
+    list_remove(timer_node);
+    list_add_after(&tmp_head_node, timer_node);
+
+    OLSR_PRINTF(7, "TIMER: fire %s timer %p, ctx %p, "
+               "at clocktick %u (%s)\n",
+               timer->timer_cookie->ci_name,
+               timer, timer->timer_cb_context, (unsigned int)(timer_wheel_clock - 1), olsr_wallclock_string());
+
+    /* This timer is expired, call into the provided callback function */
+    timer->timer_cb(timer->timer_cb_context);
 
+    /* Only act on actually running timers */
+    if (timer->timer_flags & OLSR_TIMER_RUNNING) {
       /*
-       * Dequeue and insert to a temporary list.
-       * We do this to avoid loosing our walking context when
-       * multiple timers fire.
+       * Don't restart the periodic timer if the callback function has
+       * stopped the timer.
        */
-      list_remove(timer_node);
-      list_add_after(&tmp_head_node, timer_node);
-      timers_walked++;
-
-      /* Ready to fire ? */
-      if (TIMED_OUT(timer->timer_clock)) {
-
-        OLSR_PRINTF(7, "TIMER: fire %s timer %p, ctx %p, "
-                   "at clocktick %u (%s)\n",
-                   timer->timer_cookie->ci_name,
-                   timer, timer->timer_cb_context, (unsigned int)*last_run, olsr_wallclock_string());
-
-        /* This timer is expired, call into the provided callback function */
-        timer->timer_cb(timer->timer_cb_context);
-
-        /* Only act on actually running timers */
-        if (timer->timer_flags & OLSR_TIMER_RUNNING) {
-          /*
-           * Don't restart the periodic timer if the callback function has
-           * stopped the timer.
-           */
-          if (timer->timer_period) {
-            /* For periodical timers, rehash the random number and restart */
-            timer->timer_random = olsr_random();
-            olsr_change_timer(timer, timer->timer_period, timer->timer_jitter_pct, OLSR_TIMER_PERIODIC);
-          } else {
-            /* Singleshot timers are stopped */
-            olsr_stop_timer(timer);
-          }
-        }
-
-        timers_fired++;
+      if (timer->timer_period) {
+        /* For periodical timers, rehash the random number and restart */
+        timer->timer_random = olsr_random();
+        olsr_change_timer(timer, timer->timer_period, timer->timer_jitter_pct, OLSR_TIMER_PERIODIC);
+      } else {
+        /* Singleshot timers are stopped */
+        olsr_stop_timer(timer);
       }
     }
 
-    /*
-     * Now merge the temporary list back to the old bucket.
-     */
-    list_merge(timer_head_node, &tmp_head_node);
+    timers_fired++;
+  }
+
+  /* timers that were parked here without being restarted go back into the wheel */
+  while (!list_is_empty(&tmp_head_node)) {
+    struct list_node *const timer_node = tmp_head_node.next;
+
+    list_remove(timer_node);
+    olsr_timer_insert(list2timer(timer_node));
+  }
+  return timers_fired;
+}
 
-    /* keep some statistics */
-    total_timers_walked += timers_walked;
-    total_timers_fired += timers_fired;
+/**
+ * Walk through the timer wheel and fire all timers that are due.
+ * Callback the provided function with the context pointer.
+ * Empty clockticks are skipped, so the walk does not depend on
+ * the time since the last run.
+ */
+static void
+walk_timers(void)
+{
+  unsigned int total_timers_fired = 0;
+  unsigned int wheel_slot_walks = 0;
+
+  while ((int32_t)(now_times - timer_wheel_clock) >= 0) {
+    uint32_t delta = olsr_timer_next_delta();
+
+    if (delta > now_times - timer_wheel_clock) {
+      /* nothing more to do until now */
+      break;
+    }
+    timer_wheel_clock += delta;
+
+    /* pull the timers of the higher levels down at the start of their slot */
+    if ((timer_wheel_clock & TIMER_WHEEL_MASK0) == 0) {
+      unsigned int level;
+
+      for (level = 1; level < TIMER_WHEEL_LEVELS && olsr_timer_cascade(level) == 0; level++);
+    }
 
-    /* Increment the time slot and wheel slot walk iteration */
-    (*last_run)++;
+    total_timers_fired += olsr_timer_fire_slot();
     wheel_slot_walks++;
   }
 
-  OLSR_PRINTF(7, "TIMER: processed %4u/%d clockwheel slots, "
-             "timers walked %4u/%u, timers fired %u\n",
-             wheel_slot_walks, TIMER_WHEEL_SLOTS, total_timers_walked, timer_mem_cookie->ci_usage, total_timers_fired);
+  OLSR_PRINTF(7, "TIMER: processed %4u clockwheel slots, "
+             "timers fired %u/%u\n",
+             wheel_slot_walks, total_timers_fired, timer_mem_cookie->ci_usage);
 
-  /*
-   * If the scheduler has slipped and we have walked all wheel slots,
-   * reset the last timer run.
-   */
-  *last_run = now_times;
+  timer_wheel_clock = now_times + 1;
 }
 
+#ifdef __linux__
+/**
+ * Absolute time at which the next timer may fire.
+ *
+ * @param limit latest time of interest
+ * @return the earlier of the next timer expiry and limit
+ */
+static uint32_t
+olsr_timer_next_due(uint32_t limit)
+{
+  uint32_t delta = olsr_timer_next_delta();
+
+  if (delta > limit - timer_wheel_clock) {
+    return limit;
+  }
+  return timer_wheel_clock + delta;
+}
+#endif /* __linux__ */
+
 /**
  * Stop and delete all timers.
  */
@@ -673,8 +1203,17 @@ olsr_flush_timers(void)
   struct list_node *timer_head_node;
   unsigned int wheel_slot = 0;
 
-  for (wheel_slot = 0; wheel_slot < TIMER_WHEEL_SLOTS; wheel_slot++) {
-    timer_head_node = &timer_wheel[wheel_slot & TIMER_WHEEL_MASK];
+  for (wheel_slot = 0; wheel_slot < TIMER_WHEEL_SLOTS0; wheel_slot++) {
+    timer_head_node = &timer_wheel0[wheel_slot];
+
+    /* Kill all entries hanging off this hash bucket. */
+    while (!list_is_empty(timer_head_node)) {
+      olsr_stop_timer(list2timer(timer_head_node->next));
+    }
+  }
+
+  for (wheel_slot = 0; wheel_slot < (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_SLOTS; wheel_slot++) {
+    timer_head_node = &timer_wheel[wheel_slot / TIMER_WHEEL_SLOTS][wheel_slot % TIMER_WHEEL_SLOTS];
 
     /* Kill all entries hanging off this hash bucket. */
     while (!list_is_empty(timer_head_node)) {
@@ -811,7 +1350,7 @@ olsr_start_timer(unsigned int rel_time,
   /*
    * Now insert in the respective timer_wheel slot.
    */
-  list_add_before(&timer_wheel[timer->timer_clock & TIMER_WHEEL_MASK], &timer->timer_list);
+  olsr_timer_insert(timer);
 
   OLSR_PRINTF(7, "TIMER: start %s timer %p firing in %s, ctx %p\n",
              ci->ci_name, timer, olsr_clock_string(timer->timer_clock), context);
@@ -877,7 +1416,7 @@ olsr_change_timer(struct timer_entry *timer, unsigned int rel_time, uint8_t jitt
    * and reinsert into the new slot.
    */
   list_remove(&timer->timer_list);
-  list_add_before(&timer_wheel[timer->timer_clock & TIMER_WHEEL_MASK], &timer->timer_list);
+  olsr_timer_insert(timer);
 
   OLSR_PRINTF(7, "TIMER: change %s timer %p, firing to %s, ctx %p\n",
              timer->timer_cookie->ci_name, timer, olsr_clock_string(timer->timer_clock), timer->timer_cb_context);
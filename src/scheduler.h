@@ -55,7 +55,16 @@
 #define NSEC_PER_USEC 1000
 #define USEC_PER_MSEC 1000
 
-#define TIMER_WHEEL_SLOTS 1024
+/*
+ * The timer wheel has several levels. Level 0 has one slot per millisecond,
+ * each slot of the higher levels spans a full turn of the level below.
+ */
+#define TIMER_WHEEL_LEVELS 5
+#define TIMER_WHEEL_BITS0 8
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS0 (1 << TIMER_WHEEL_BITS0)
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK0 (TIMER_WHEEL_SLOTS0 - 1)
 #define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
 
 typedef void (*timer_cb_func) (void *); /* callback function */
@@ -64,6 +73,8 @@ typedef void (*timer_cb_func) (void *); /* callback function */
  * Our timer implementation is a based on individual timers arranged in
  * a double linked list hanging of hash containers called a timer wheel slot.
  * For every timer a timer_entry is created and attached to the timer wheel slot.
+ * Timers far in the future start on a higher level of the wheel and move
+ * down level by level while their expiry comes closer.
  * When the timer fires, the timer_cb function is called with the
  * context pointer.
  * The implementation supports periodic and oneshot timers.
@@ -137,6 +148,7 @@ struct olsr_socket_entry {
   socket_handler_func process_pollrate;
   void *data;
   unsigned int flags;
+  unsigned int epoll_flags;            /* flags registered with epoll(7), linux only */
   struct list_node socket_node;
 };
 
@@ -0,0 +1,782 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/*
+ * SPF benchmark.
+ *
+ * Builds a synthetic lsdb (grid, random geometric or scale free graph)
+ * through the regular tc_set API and times olsr_calculate_routing_table()
+ * with each of the candidate set backends in each of the SPF modes.
+ * The daemon objects are linked in, so this measures exactly the code
+ * which runs in olsrd. Build it with "make spf_bench".
+ *
+ * With -v nothing is timed. Instead the result of every incremental
+ * run is compared with a full run on the same lsdb.
+ */
+
+#include "defs.h"
+#include "olsr.h"
+#include "olsr_cfg.h"
+#include "olsr_cookie.h"
+#include "scheduler.h"
+#include "tc_set.h"
+#include "lq_plugin.h"
+#include "olsr_spf.h"
+#include "process_routes.h"
+
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* defined by main.c in olsrd */
+struct olsr_cookie_info *def_timer_ci = NULL;
+
+enum spf_bench_topology {
+  SPF_BENCH_GRID,
+  SPF_BENCH_GEOMETRIC,
+  SPF_BENCH_SCALE_FREE,
+  SPF_BENCH_TOPOLOGY_COUNT
+};
+
+static const char *const spf_bench_topology_names[SPF_BENCH_TOPOLOGY_COUNT] = { "grid", "geometric", "scalefree" };
+
+/* the candidate set backends, in the order olsr_spf_cand_set_type() checks them */
+struct spf_bench_backend {
+  const char *name;
+  bool binary_heap;
+  bool array_heap;
+  bool radix_heap;
+  uint8_t arity;
+};
+
+static const struct spf_bench_backend spf_bench_backends[] = {
+  { "avl",          false, false, false, DEF_DIJKSTRA_HEAP_ARITY },
+  { "bin_heap",     true,  false, false, DEF_DIJKSTRA_HEAP_ARITY },
+  { "array_heap/2", true,  true,  false, 2 },
+  { "array_heap/4", true,  true,  false, 4 },
+  { "array_heap/8", true,  true,  false, 8 },
+  { "radix_heap",   false, false, true,  DEF_DIJKSTRA_HEAP_ARITY },
+};
+
+#define SPF_BENCH_BACKEND_COUNT (sizeof(spf_bench_backends) / sizeof(spf_bench_backends[0]))
+
+/* the SPF modes measured with each backend */
+struct spf_bench_mode {
+  const char *name;
+  bool incremental;
+  bool snapshot;
+};
+
+static const struct spf_bench_mode spf_bench_modes[] = {
+  { "full",          false, false },
+  { "full/snapshot", false, true },
+  { "incremental",   true,  false },
+  { "incr/snapshot", true,  true },
+};
+
+#define SPF_BENCH_MODE_COUNT (sizeof(spf_bench_modes) / sizeof(spf_bench_modes[0]))
+
+/* node sizes run if none is given on the command line */
+static const unsigned int spf_bench_default_sizes[] = { 100, 1000, 10000, 50000 };
+
+#define SPF_BENCH_MAX_NODES 0xfffff0
+
+/* average node degree of the random geometric graph */
+#define SPF_BENCH_GEOMETRIC_DEGREE 8
+
+/* edges each new node of the scale free graph brings */
+#define SPF_BENCH_SCALE_FREE_EDGES 2
+
+/* link cost of ETX 1.0 in the default lq plugins */
+#define SPF_BENCH_ETX_ONE 1024
+
+/* nodes of the synthetic graph which are our neighbors */
+#define SPF_BENCH_NEIGHBORS 4
+
+/* total SPF node visits a measurement aims for, if no run count is given */
+#define SPF_BENCH_WORK 1000000
+
+/* one in this many changed edges breaks in verify mode */
+#define SPF_BENCH_VERIFY_BROKEN 8
+
+/* mismatches printed per verification */
+#define SPF_BENCH_VERIFY_REPORT 5
+
+/* path of a vertex as calculated by one SPF run */
+struct spf_bench_path {
+  olsr_linkcost cost;
+  struct link_entry *next_hop;
+  struct tc_entry *parent;
+  bool valid;                          /* the tree edge to the vertex adds up to its cost */
+};
+
+static struct tc_entry **bench_nodes;
+static unsigned int bench_node_count;
+static struct tc_edge_entry **bench_edges;
+static unsigned int bench_edge_count, bench_edge_size;
+static uint32_t bench_random_state;
+static struct spf_bench_path *bench_incr_paths, *bench_full_paths;
+
+#ifdef SPF_BENCH_COUNT_ALLOCS
+/*
+ * The benchmark is linked with --wrap for the libc allocator,
+ * which routes all calls of the daemon code through these counters.
+ */
+static unsigned long bench_allocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+void *
+__wrap_malloc(size_t size)
+{
+  bench_allocs++;
+  return __real_malloc(size);
+}
+
+void *
+__wrap_calloc(size_t nmemb, size_t size)
+{
+  bench_allocs++;
+  return __real_calloc(nmemb, size);
+}
+
+void *
+__wrap_realloc(void *ptr, size_t size)
+{
+  bench_allocs++;
+  return __real_realloc(ptr, size);
+}
+#endif /* SPF_BENCH_COUNT_ALLOCS */
+
+/* keep the kernel out of the measurement */
+static int
+bench_export_route(const struct rt_entry *rt __attribute__ ((unused)))
+{
+  return 0;
+}
+
+/*
+ * Small xorshift generator, so that a seed gives the same
+ * topology on every platform.
+ */
+static uint32_t
+bench_random(void)
+{
+  bench_random_state ^= bench_random_state << 13;
+  bench_random_state ^= bench_random_state >> 17;
+  bench_random_state ^= bench_random_state << 5;
+  return bench_random_state;
+}
+
+static double
+bench_random_unit(void)
+{
+  return (bench_random() >> 8) / (double)(1 << 24);
+}
+
+/* random link cost between ETX 1.0 and ETX 4.0 */
+static olsr_linkcost
+bench_random_cost(void)
+{
+  return SPF_BENCH_ETX_ONE + bench_random() % (3 * SPF_BENCH_ETX_ONE);
+}
+
+static double
+bench_now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void
+bench_node_addr(union olsr_ip_addr *addr, unsigned int idx)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->v4.s_addr = htonl(0x0a000001 + idx);
+}
+
+static void
+bench_add_edge(struct tc_entry *tc, union olsr_ip_addr *addr)
+{
+  struct tc_edge_entry *tc_edge;
+
+  tc_edge = olsr_add_tc_edge_entry(tc, addr, 0);
+  if (!tc_edge) {
+    fprintf(stderr, "out of memory for tc edges\n");
+    exit(EXIT_FAILURE);
+  }
+  tc_edge->cost = bench_random_cost();
+
+  if (bench_edge_count == bench_edge_size) {
+    bench_edge_size = bench_edge_size ? 2 * bench_edge_size : 1024;
+    bench_edges = realloc(bench_edges, bench_edge_size * sizeof(*bench_edges));
+    if (!bench_edges) {
+      fprintf(stderr, "out of memory for %u tc edges\n", bench_edge_size);
+      exit(EXIT_FAILURE);
+    }
+  }
+  bench_edges[bench_edge_count++] = tc_edge;
+}
+
+/*
+ * Add a symmetric link between two nodes, which means one edge
+ * in each direction. Duplicate links are ignored.
+ */
+static void
+bench_link(unsigned int a, unsigned int b)
+{
+  union olsr_ip_addr addr_a, addr_b;
+
+  if (a == b) {
+    return;
+  }
+  bench_node_addr(&addr_a, a);
+  bench_node_addr(&addr_b, b);
+  if (olsr_lookup_tc_edge(bench_nodes[a], &addr_b)) {
+    return;
+  }
+  bench_add_edge(bench_nodes[a], &addr_b);
+  bench_add_edge(bench_nodes[b], &addr_a);
+}
+
+/* square grid, each node is linked to its four neighbors */
+static void
+bench_build_grid(unsigned int count)
+{
+  unsigned int side, i;
+
+  for (side = 1; side * side < count; side++);
+  for (i = 0; i < count; i++) {
+    if ((i % side) + 1 < side && i + 1 < count) {
+      bench_link(i, i + 1);
+    }
+    if (i + side < count) {
+      bench_link(i, i + side);
+    }
+  }
+}
+
+/*
+ * Nodes placed randomly in the unit square, linked if closer than
+ * a radius which gives SPF_BENCH_GEOMETRIC_DEGREE neighbors on average.
+ * The nodes are sorted into cells of the radius size, so only the
+ * surrounding cells have to be checked.
+ */
+static void
+bench_build_geometric(unsigned int count)
+{
+  double *x, *y, radius;
+  unsigned int *cell_first, *cell_next;
+  unsigned int cells, i, cx, cy, ncx, ncy, j;
+
+  radius = sqrt(SPF_BENCH_GEOMETRIC_DEGREE / (M_PI * count));
+  cells = (unsigned int)(1.0 / radius);
+  if (cells == 0) {
+    cells = 1;
+  }
+
+  x = olsr_malloc(count * sizeof(*x), "spf_bench x");
+  y = olsr_malloc(count * sizeof(*y), "spf_bench y");
+  cell_next = olsr_malloc(count * sizeof(*cell_next), "spf_bench cells");
+  cell_first = olsr_malloc(cells * cells * sizeof(*cell_first), "spf_bench cells");
+  for (i = 0; i < cells * cells; i++) {
+    cell_first[i] = count;
+  }
+
+  for (i = 0; i < count; i++) {
+    x[i] = bench_random_unit();
+    y[i] = bench_random_unit();
+    cx = (unsigned int)(x[i] * cells);
+    cy = (unsigned int)(y[i] * cells);
+    cell_next[i] = cell_first[cy * cells + cx];
+    cell_first[cy * cells + cx] = i;
+  }
+
+  for (i = 0; i < count; i++) {
+    cx = (unsigned int)(x[i] * cells);
+    cy = (unsigned int)(y[i] * cells);
+    for (ncy = cy ? cy - 1 : 0; ncy <= cy + 1 && ncy < cells; ncy++) {
+      for (ncx = cx ? cx - 1 : 0; ncx <= cx + 1 && ncx < cells; ncx++) {
+        for (j = cell_first[ncy * cells + ncx]; j < count; j = cell_next[j]) {
+          if (j > i && (x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) < radius * radius) {
+            bench_link(i, j);
+          }
+        }
+      }
+    }
+  }
+
+  free(x);
+  free(y);
+  free(cell_next);
+  free(cell_first);
+}
+
+/*
+ * Barabasi-Albert preferential attachment. Every link end is recorded
+ * once, so picking a random record picks a node proportional to its degree.
+ */
+static void
+bench_build_scale_free(unsigned int count)
+{
+  unsigned int *ends, end_count, i, j;
+
+  ends = olsr_malloc(2 * SPF_BENCH_SCALE_FREE_EDGES * count * sizeof(*ends), "spf_bench ends");
+  end_count = 0;
+
+  for (i = 1; i < count; i++) {
+    for (j = 0; j < SPF_BENCH_SCALE_FREE_EDGES && j < i; j++) {
+      unsigned int peer = end_count ? ends[bench_random() % end_count] : 0;
+
+      bench_link(i, peer);
+      ends[end_count++] = i;
+      ends[end_count++] = peer;
+    }
+  }
+  free(ends);
+}
+
+static void
+bench_build(enum spf_bench_topology topology, unsigned int count)
+{
+  union olsr_ip_addr addr;
+  unsigned int i;
+
+  bench_nodes = olsr_malloc(count * sizeof(*bench_nodes), "spf_bench nodes");
+  bench_node_count = count;
+  bench_edge_count = 0;
+  for (i = 0; i < count; i++) {
+    bench_node_addr(&addr, i);
+    bench_nodes[i] = olsr_locate_tc_entry(&addr);
+  }
+
+  switch (topology) {
+  case SPF_BENCH_GRID:
+    bench_build_grid(count);
+    break;
+  case SPF_BENCH_GEOMETRIC:
+    bench_build_geometric(count);
+    break;
+  case SPF_BENCH_SCALE_FREE:
+  default:
+    bench_build_scale_free(count);
+    break;
+  }
+
+  /* attach ourselves to some random nodes */
+  olsr_change_myself_tc();
+  for (i = 0; i < SPF_BENCH_NEIGHBORS && i < count; i++) {
+    unsigned int idx = bench_random() % count;
+
+    bench_node_addr(&addr, idx);
+    if (!olsr_lookup_tc_edge(tc_myself, &addr)) {
+      bench_add_edge(tc_myself, &addr);
+      bench_add_edge(bench_nodes[idx], &olsr_cnf->main_addr);
+    }
+  }
+}
+
+static void
+bench_teardown(void)
+{
+  struct tc_edge_entry *tc_edge;
+  unsigned int i;
+
+  OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc_myself, tc_edge) {
+    olsr_delete_tc_edge_entry(tc_edge);
+  } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc_myself, tc_edge);
+
+  for (i = 0; i < bench_node_count; i++) {
+    olsr_delete_tc_entry(bench_nodes[i]);
+  }
+  free(bench_nodes);
+  bench_nodes = NULL;
+  bench_node_count = 0;
+  bench_edge_count = 0;
+}
+
+static unsigned int
+bench_reached(void)
+{
+  struct tc_entry *tc;
+  unsigned int reached = 0;
+
+  OLSR_FOR_ALL_TC_ENTRIES(tc) {
+    if (tc->path_cost != ROUTE_COST_BROKEN) {
+      reached++;
+    }
+  }
+  OLSR_FOR_ALL_TC_ENTRIES_END(tc);
+  return reached;
+}
+
+/*
+ * Time a number of SPF runs with one backend. In incremental mode
+ * the cost of a few random edges changes before each run.
+ */
+static void
+bench_measure(enum spf_bench_topology topology, const struct spf_bench_backend *backend,
+              const struct spf_bench_mode *mode, unsigned int runs, unsigned int changes)
+{
+  struct tc_edge_entry *tc_edge;
+  olsr_linkcost old_cost;
+  unsigned long allocs = 0;
+  double elapsed = 0, start;
+  unsigned int run, i, reached;
+
+  olsr_cnf->dijkstra_binary_heap = backend->binary_heap;
+  olsr_cnf->dijkstra_array_heap = backend->array_heap;
+  olsr_cnf->dijkstra_radix_heap = backend->radix_heap;
+  olsr_cnf->dijkstra_heap_arity = backend->arity;
+  olsr_cnf->dijkstra_incremental = mode->incremental;
+  olsr_cnf->dijkstra_snapshot = mode->snapshot;
+
+  /* warm up, also gives the incremental mode a tree to start from */
+  olsr_spf_invalidate();
+  olsr_calculate_routing_table(true);
+  reached = bench_reached();
+
+  for (run = 0; run < runs; run++) {
+    if (mode->incremental) {
+      for (i = 0; i < changes; i++) {
+        tc_edge = bench_edges[bench_random() % bench_edge_count];
+        old_cost = tc_edge->cost;
+        tc_edge->cost = bench_random_cost();
+        olsr_spf_edge_cost_changed(tc_edge, old_cost);
+      }
+    }
+
+#ifdef SPF_BENCH_COUNT_ALLOCS
+    allocs -= bench_allocs;
+#endif /* SPF_BENCH_COUNT_ALLOCS */
+    start = bench_now();
+    olsr_calculate_routing_table(true);
+    elapsed += bench_now() - start;
+#ifdef SPF_BENCH_COUNT_ALLOCS
+    allocs += bench_allocs;
+#endif /* SPF_BENCH_COUNT_ALLOCS */
+  }
+
+  if (elapsed <= 0) {
+    elapsed = 1e-6;
+  }
+  printf("%-10s %8u %9u %-13s %-14s %6u %12.1f %10.1f %14.0f %11.1f\n", spf_bench_topology_names[topology],
+         bench_node_count, bench_edge_count, backend->name, mode->name, runs,
+         elapsed * 1e6 / runs, runs / elapsed, (double)reached * runs / elapsed, (double)allocs / runs);
+}
+
+static void
+bench_topology(enum spf_bench_topology topology, unsigned int count, unsigned int runs, unsigned int changes)
+{
+  unsigned int i, j;
+
+  bench_build(topology, count);
+  if (!runs) {
+    runs = SPF_BENCH_WORK / count;
+    if (runs < 5) {
+      runs = 5;
+    }
+  }
+
+  for (j = 0; j < SPF_BENCH_MODE_COUNT; j++) {
+    for (i = 0; i < SPF_BENCH_BACKEND_COUNT; i++) {
+      bench_measure(topology, &spf_bench_backends[i], &spf_bench_modes[j], runs, changes);
+    }
+  }
+  bench_teardown();
+}
+
+/*
+ * Check the edge from the predecessor in the shortest path tree to a
+ * reachable vertex. If it adds up to the path cost and passes the next
+ * hop on for every vertex, the whole tree holds shortest paths.
+ */
+static bool
+bench_tree_edge_valid(struct tc_entry *tc)
+{
+  struct tc_edge_entry *tc_edge;
+  struct tc_entry *parent = tc->spf_parent;
+
+  if (!parent) {
+    return false;
+  }
+  if (parent != tc_myself && tc->next_hop != parent->next_hop) {
+    return false;
+  }
+  tc_edge = olsr_lookup_tc_edge(parent, &tc->addr);
+  return tc_edge && tc_edge->cost != LINK_COST_BROKEN && parent->path_cost + tc_edge->cost == tc->path_cost;
+}
+
+static void
+bench_record_paths(struct spf_bench_path *paths)
+{
+  unsigned int i;
+
+  for (i = 0; i < bench_node_count; i++) {
+    paths[i].cost = bench_nodes[i]->path_cost;
+    paths[i].next_hop = bench_nodes[i]->next_hop;
+    paths[i].parent = bench_nodes[i]->spf_parent;
+    paths[i].valid = paths[i].cost == ROUTE_COST_BROKEN || bench_tree_edge_valid(bench_nodes[i]);
+  }
+}
+
+/*
+ * Run incremental SPF after random edge changes and compare path cost,
+ * next hop and predecessor of every vertex with a full run on the same
+ * lsdb. A different next hop or predecessor is counted as a tie if the
+ * incremental tree still holds a path of the same cost. The incremental run of each round
+ * starts from the tree of the full run of the round before.
+ *
+ * return the number of mismatches
+ */
+static unsigned int
+bench_verify(enum spf_bench_topology topology, const struct spf_bench_backend *backend,
+             const struct spf_bench_mode *mode, unsigned int runs, unsigned int changes)
+{
+  struct tc_edge_entry *tc_edge;
+  olsr_linkcost old_cost;
+  unsigned int run, i, ties = 0, mismatches = 0;
+  struct ipaddr_str buf;
+
+  olsr_cnf->dijkstra_binary_heap = backend->binary_heap;
+  olsr_cnf->dijkstra_array_heap = backend->array_heap;
+  olsr_cnf->dijkstra_radix_heap = backend->radix_heap;
+  olsr_cnf->dijkstra_heap_arity = backend->arity;
+  olsr_cnf->dijkstra_incremental = mode->incremental;
+  olsr_cnf->dijkstra_snapshot = mode->snapshot;
+
+  olsr_spf_invalidate();
+  olsr_calculate_routing_table(true);
+
+  for (run = 0; run < runs; run++) {
+    for (i = 0; i < changes; i++) {
+      tc_edge = bench_edges[bench_random() % bench_edge_count];
+      old_cost = tc_edge->cost;
+      if (bench_random() % SPF_BENCH_VERIFY_BROKEN == 0) {
+        tc_edge->cost = LINK_COST_BROKEN;
+      } else {
+        tc_edge->cost = bench_random_cost();
+      }
+      olsr_spf_edge_cost_changed(tc_edge, old_cost);
+    }
+
+    olsr_calculate_routing_table(true);
+    bench_record_paths(bench_incr_paths);
+
+    olsr_spf_invalidate();
+    olsr_calculate_routing_table(true);
+    bench_record_paths(bench_full_paths);
+
+    for (i = 0; i < bench_node_count; i++) {
+      struct spf_bench_path *incr = &bench_incr_paths[i], *full = &bench_full_paths[i];
+
+      if (incr->valid && incr->cost == full->cost) {
+        if (incr->next_hop != full->next_hop || incr->parent != full->parent) {
+          ties++;
+        }
+        continue;
+      }
+      if (mismatches++ < SPF_BENCH_VERIFY_REPORT) {
+        printf("  run %u: %s incremental cost %u%s, full cost %u\n", run, olsr_ip_to_string(&buf, &bench_nodes[i]->addr),
+               incr->cost, incr->valid ? "" : " (broken tree)", full->cost);
+      }
+    }
+  }
+
+  printf("%-10s %8u %9u %-13s %-14s %6u %12u %10u %10s\n", spf_bench_topology_names[topology],
+         bench_node_count, bench_edge_count, backend->name, mode->name, runs, ties, mismatches,
+         mismatches ? "FAIL" : "ok");
+  return mismatches;
+}
+
+static unsigned int
+bench_verify_topology(enum spf_bench_topology topology, unsigned int count, unsigned int runs, unsigned int changes)
+{
+  unsigned int i, j, mismatches = 0;
+
+  bench_build(topology, count);
+  bench_incr_paths = olsr_malloc(count * sizeof(*bench_incr_paths), "spf_bench paths");
+  bench_full_paths = olsr_malloc(count * sizeof(*bench_full_paths), "spf_bench paths");
+  if (!runs) {
+    runs = SPF_BENCH_WORK / count;
+    if (runs < 5) {
+      runs = 5;
+    }
+  }
+
+  for (j = 0; j < SPF_BENCH_MODE_COUNT; j++) {
+    if (!spf_bench_modes[j].incremental) {
+      continue;
+    }
+    for (i = 0; i < SPF_BENCH_BACKEND_COUNT; i++) {
+      mismatches += bench_verify(topology, &spf_bench_backends[i], &spf_bench_modes[j], runs, changes);
+    }
+  }
+
+  free(bench_incr_paths);
+  free(bench_full_paths);
+  bench_incr_paths = NULL;
+  bench_full_paths = NULL;
+  bench_teardown();
+  return mismatches;
+}
+
+static void
+bench_usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-v] [-t grid|geometric|scalefree] [-n nodes] [-r runs] [-c changes] [-s seed]\n"
+          "  -v  compare incremental with full SPF instead of timing\n"
+          "  -t  topology to build, default all\n"
+          "  -n  number of nodes, default 100, 1000, 10000 and 50000\n"
+          "  -r  SPF runs per measurement, default scaled to the number of nodes\n"
+          "  -c  edges changed before each incremental run, default 4\n"
+          "  -s  seed of the topology generator, default 1\n", name);
+  exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int topology = -1, opt, t;
+  unsigned int nodes = 0, runs = 0, changes = 4, mismatches = 0, i;
+  bool verify = false;
+
+  bench_random_state = 1;
+  while ((opt = getopt(argc, argv, "vt:n:r:c:s:")) != -1) {
+    switch (opt) {
+    case 'v':
+      verify = true;
+      break;
+    case 't':
+      for (topology = 0; topology < SPF_BENCH_TOPOLOGY_COUNT; topology++) {
+        if (strcmp(optarg, spf_bench_topology_names[topology]) == 0) {
+          break;
+        }
+      }
+      if (topology == SPF_BENCH_TOPOLOGY_COUNT) {
+        bench_usage(argv[0]);
+      }
+      break;
+    case 'n':
+      nodes = strtoul(optarg, NULL, 0);
+      if (nodes < 2 || nodes > SPF_BENCH_MAX_NODES) {
+        bench_usage(argv[0]);
+      }
+      break;
+    case 'r':
+      runs = strtoul(optarg, NULL, 0);
+      break;
+    case 'c':
+      changes = strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      bench_random_state = strtoul(optarg, NULL, 0);
+      if (!bench_random_state) {
+        bench_random_state = 1;
+      }
+      break;
+    default:
+      bench_usage(argv[0]);
+      break;
+    }
+  }
+
+  olsr_cnf = olsrd_get_default_cnf(strdup(argv[0]));
+  olsr_cnf->ip_version = AF_INET;
+  olsr_cnf->ipsize = sizeof(struct in_addr);
+  olsr_cnf->maxplen = 32;
+  olsr_cnf->debug_level = 0;
+  bench_node_addr(&olsr_cnf->main_addr, SPF_BENCH_MAX_NODES);
+
+  olsr_init_timers();
+  def_timer_ci = olsr_alloc_cookie("Default Timer Cookie", OLSR_COOKIE_TYPE_TIMER);
+  olsr_init_tables();
+  olsr_init_export_route();
+  olsr_addroute_function = bench_export_route;
+  olsr_addroute6_function = bench_export_route;
+  olsr_delroute_function = bench_export_route;
+  olsr_delroute6_function = bench_export_route;
+
+  if (verify) {
+    printf("%-10s %8s %9s %-13s %-14s %6s %12s %10s %10s\n", "topology", "nodes", "edges", "backend", "mode", "runs",
+           "ties", "mismatches", "result");
+  } else {
+    printf("%-10s %8s %9s %-13s %-14s %6s %12s %10s %14s %11s\n", "topology", "nodes", "edges", "backend", "mode", "runs",
+           "usec/run", "runs/sec", "vertices/sec", "allocs/run");
+  }
+
+  for (t = 0; t < SPF_BENCH_TOPOLOGY_COUNT; t++) {
+    if (topology != -1 && topology != t) {
+      continue;
+    }
+    for (i = 0; i < sizeof(spf_bench_default_sizes) / sizeof(spf_bench_default_sizes[0]); i++) {
+      unsigned int count = nodes ? nodes : spf_bench_default_sizes[i];
+
+      if (verify) {
+        mismatches += bench_verify_topology(t, count, runs, changes);
+      } else {
+        bench_topology(t, count, runs, changes);
+      }
+      if (nodes) {
+        break;
+      }
+    }
+  }
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
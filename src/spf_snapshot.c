@@ -0,0 +1,179 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#include "spf_snapshot.h"
+#include "tc_set.h"
+#include "olsr.h"
+#include "log.h"
+
+#include <stdlib.h>
+
+struct spf_snapshot spf_snapshot = { 0, 0, 0, 0, 0, NULL, NULL, NULL, NULL, true };
+
+/*
+ * olsr_spf_snapshot_invalidate
+ *
+ * The structure of the lsdb has changed, rebuild
+ * the snapshot before the next SPF run uses it.
+ */
+void
+olsr_spf_snapshot_invalidate(void)
+{
+  spf_snapshot.stale = true;
+}
+
+/*
+ * olsr_spf_snapshot_update_cost
+ *
+ * Copy the new cost of an edge into its slot of the snapshot.
+ */
+void
+olsr_spf_snapshot_update_cost(struct tc_edge_entry *tc_edge)
+{
+  if (spf_snapshot.stale || !tc_edge->edge_inv) {
+    return;
+  }
+  spf_snapshot.edge_cost[tc_edge->spf_slot] = tc_edge->cost;
+}
+
+/*
+ * olsr_spf_snapshot_grow
+ *
+ * Make room for the vertices and edges of the lsdb.
+ * return false if we are out of memory.
+ */
+static bool
+olsr_spf_snapshot_grow(uint32_t vertex_count, uint32_t edge_count)
+{
+  void *ptr;
+
+  if (vertex_count + 1 > spf_snapshot.vertex_size) {
+    ptr = realloc(spf_snapshot.vertex, (vertex_count + 1) * sizeof(*spf_snapshot.vertex));
+    if (!ptr) {
+      return false;
+    }
+    spf_snapshot.vertex = ptr;
+
+    ptr = realloc(spf_snapshot.edge_first, (vertex_count + 1) * sizeof(*spf_snapshot.edge_first));
+    if (!ptr) {
+      return false;
+    }
+    spf_snapshot.edge_first = ptr;
+    spf_snapshot.vertex_size = vertex_count + 1;
+  }
+
+  if (edge_count > spf_snapshot.edge_size) {
+    ptr = realloc(spf_snapshot.edge_target, edge_count * sizeof(*spf_snapshot.edge_target));
+    if (!ptr) {
+      return false;
+    }
+    spf_snapshot.edge_target = ptr;
+
+    ptr = realloc(spf_snapshot.edge_cost, edge_count * sizeof(*spf_snapshot.edge_cost));
+    if (!ptr) {
+      return false;
+    }
+    spf_snapshot.edge_cost = ptr;
+    spf_snapshot.edge_size = edge_count;
+  }
+  return true;
+}
+
+/*
+ * olsr_spf_snapshot_build
+ *
+ * Rebuild the snapshot from the lsdb if it is stale.
+ * return false if the snapshot cannot be used for the next SPF run.
+ */
+bool
+olsr_spf_snapshot_build(void)
+{
+  struct tc_entry *tc;
+  struct tc_edge_entry *tc_edge;
+  uint32_t vertex_count = 0, edge_count = 0;
+
+  if (!spf_snapshot.stale) {
+    return true;
+  }
+
+  OLSR_FOR_ALL_TC_ENTRIES(tc) {
+    tc->spf_index = vertex_count++;
+    edge_count += tc->edge_tree.count;
+  }
+  OLSR_FOR_ALL_TC_ENTRIES_END(tc);
+
+  if (!olsr_spf_snapshot_grow(vertex_count, edge_count)) {
+    OLSR_PRINTF(1, "SPF: out of memory for a snapshot of %u vertices and %u edges\n", vertex_count, edge_count);
+    return false;
+  }
+
+  vertex_count = 0;
+  edge_count = 0;
+  OLSR_FOR_ALL_TC_ENTRIES(tc) {
+    spf_snapshot.vertex[vertex_count] = tc;
+    spf_snapshot.edge_first[vertex_count++] = edge_count;
+
+    OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc, tc_edge) {
+      /* dead-end edges are never used by the SPF */
+      if (!tc_edge->edge_inv) {
+        continue;
+      }
+      tc_edge->spf_slot = edge_count;
+      spf_snapshot.edge_target[edge_count] = tc_edge->edge_inv->tc->spf_index;
+      spf_snapshot.edge_cost[edge_count++] = tc_edge->cost;
+    } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc, tc_edge);
+  }
+  OLSR_FOR_ALL_TC_ENTRIES_END(tc);
+  spf_snapshot.edge_first[vertex_count] = edge_count;
+
+  spf_snapshot.vertex_count = vertex_count;
+  spf_snapshot.edge_count = edge_count;
+  spf_snapshot.generation++;
+  spf_snapshot.stale = false;
+  return true;
+}
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,85 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifndef _OLSR_SPF_SNAPSHOT_H
+#define _OLSR_SPF_SNAPSHOT_H
+
+#include "olsr_types.h"
+
+struct tc_entry;
+struct tc_edge_entry;
+
+/*
+ * Compressed sparse row copy of the lsdb adjacency for the SPF.
+ * The edges of the vertex with the spf_index i are the slots
+ * edge_first[i] up to edge_first[i + 1] - 1 of the edge arrays,
+ * in the order of the edge_tree. Only edges with an inverse edge
+ * are copied, so the SPF walks packed arrays instead of the
+ * edge_tree and the edge_inv pointers. Edges refer to their target
+ * by index, so the arrays can be copied and used without the lsdb.
+ */
+struct spf_snapshot {
+  uint32_t vertex_count;               /* number of vertices in the snapshot */
+  uint32_t vertex_size;                /* allocated size of vertex and edge_first */
+  uint32_t edge_count;                 /* number of edges in the snapshot */
+  uint32_t edge_size;                  /* allocated size of the edge arrays */
+  uint32_t generation;                 /* incremented on every rebuild */
+  struct tc_entry **vertex;            /* vertex of each index */
+  uint32_t *edge_first;                /* first slot of each vertex, vertex_count + 1 entries */
+  uint32_t *edge_target;               /* index of the destination vertex of each edge */
+  olsr_linkcost *edge_cost;            /* cost of each edge */
+  bool stale;                          /* lsdb structure changed since the last build */
+};
+
+extern struct spf_snapshot spf_snapshot;
+
+void olsr_spf_snapshot_invalidate(void);
+void olsr_spf_snapshot_update_cost(struct tc_edge_entry *tc_edge);
+bool olsr_spf_snapshot_build(void);
+
+#endif /* _OLSR_SPF_SNAPSHOT_H */
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
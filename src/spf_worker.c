@@ -0,0 +1,354 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifdef __linux__
+
+#include "spf_worker.h"
+#include "lq_plugin.h"
+#include "scheduler.h"
+#include "olsr.h"
+#include "log.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/*
+ * The worker thread sleeps on spf_worker_cond until the main loop
+ * submits the job. When done it writes a byte into the pipe, which
+ * makes the scheduler of the main loop hand the result back.
+ * All fields below except spf_worker_job are protected by spf_worker_mutex,
+ * the job belongs to the worker while spf_worker_running is set.
+ */
+static pthread_t spf_worker_thread;
+static pthread_mutex_t spf_worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t spf_worker_cond = PTHREAD_COND_INITIALIZER;
+static bool spf_worker_started = false;
+static bool spf_worker_running = false;
+static bool spf_worker_stopping = false;
+static int spf_worker_pipe[2] = { -1, -1 };
+static spf_worker_done_func spf_worker_done = NULL;
+static struct spf_job spf_worker_job;
+
+/*
+ * olsr_spf_worker_run
+ *
+ * Run the Dijkstra algorithm on the job with an array heap as candidate
+ * set. Same as the full SPF run, the 1st hop of a vertex is the one of
+ * its predecessor or the vertex itself if it is a neighbor.
+ */
+static void
+olsr_spf_worker_run(struct spf_job *job)
+{
+  struct array_heap heap;
+  struct array_heap_node *node;
+  uint32_t v, w, slot;
+  olsr_linkcost new_cost;
+
+  for (v = 0; v < job->vertex_count; v++) {
+    job->path_cost[v] = ROUTE_COST_BROKEN;
+    job->first_hop[v] = SPF_JOB_NO_HOP;
+    job->hops[v] = 0;
+    array_heap_init_node(&job->cand[v]);
+  }
+
+  /* a vertex is on the heap at most once, so the heap never grows */
+  if (array_heap_init(&heap, job->arity, job->vertex_count)) {
+    job->failed = true;
+    return;
+  }
+  job->failed = false;
+
+  job->path_cost[job->source] = ZERO_ROUTE_COST;
+  job->cand[job->source].key = ZERO_ROUTE_COST;
+  array_heap_insert(&heap, &job->cand[job->source]);
+
+  while ((node = array_heap_extract_min(&heap))) {
+    v = node - job->cand;
+
+    for (slot = job->edge_first[v]; slot < job->edge_first[v + 1]; slot++) {
+      if (job->edge_cost[slot] == LINK_COST_BROKEN) {
+        continue;
+      }
+
+      w = job->edge_target[slot];
+      new_cost = job->path_cost[v] + job->edge_cost[slot];
+      if (new_cost >= job->path_cost[w]) {
+        continue;
+      }
+
+      job->path_cost[w] = new_cost;
+      job->cand[w].key = new_cost;
+      if (array_heap_is_node_added(&job->cand[w])) {
+        array_heap_decrease_key(&heap, &job->cand[w]);
+      } else {
+        array_heap_insert(&heap, &job->cand[w]);
+      }
+
+      /* pull-up the next-hop and bump the hop count */
+      job->first_hop[w] = job->first_hop[v] != SPF_JOB_NO_HOP ? job->first_hop[v] : (job->direct[w] ? w : SPF_JOB_NO_HOP);
+      job->hops[w] = job->hops[v] + 1;
+    }
+  }
+  array_heap_free(&heap);
+}
+
+/*
+ * olsr_spf_worker_main
+ *
+ * Main function of the worker thread.
+ */
+static void *
+olsr_spf_worker_main(void *arg __attribute__ ((unused)))
+{
+  static const char done = 0;
+
+  pthread_mutex_lock(&spf_worker_mutex);
+  while (!spf_worker_stopping) {
+    if (!spf_worker_running) {
+      pthread_cond_wait(&spf_worker_cond, &spf_worker_mutex);
+      continue;
+    }
+    pthread_mutex_unlock(&spf_worker_mutex);
+
+    olsr_spf_worker_run(&spf_worker_job);
+
+    pthread_mutex_lock(&spf_worker_mutex);
+    spf_worker_running = false;
+    while (write(spf_worker_pipe[1], &done, sizeof(done)) < 0 && errno == EINTR);
+  }
+  pthread_mutex_unlock(&spf_worker_mutex);
+  return NULL;
+}
+
+/*
+ * olsr_spf_worker_event
+ *
+ * Scheduler callback, the worker has finished its job.
+ */
+static void
+olsr_spf_worker_event(int fd, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
+{
+  char buf[16];
+
+  while (read(fd, buf, sizeof(buf)) > 0);
+
+  if (!olsr_spf_worker_busy() && spf_worker_done) {
+    spf_worker_done(&spf_worker_job);
+  }
+}
+
+/*
+ * olsr_spf_worker_start
+ *
+ * Start the worker thread, if it is not running yet.
+ * return false if there is no worker thread.
+ */
+bool
+olsr_spf_worker_start(spf_worker_done_func done)
+{
+  static bool failed = false;
+  sigset_t all, old;
+
+  if (spf_worker_started) {
+    return true;
+  }
+  if (failed) {
+    return false;
+  }
+
+  if (pipe(spf_worker_pipe) < 0) {
+    OLSR_PRINTF(1, "SPF: cannot create worker pipe: %s\n", strerror(errno));
+    failed = true;
+    return false;
+  }
+  fcntl(spf_worker_pipe[0], F_SETFL, fcntl(spf_worker_pipe[0], F_GETFL) | O_NONBLOCK);
+
+  /* signals must be handled by the main loop, not by the worker */
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  if (pthread_create(&spf_worker_thread, NULL, &olsr_spf_worker_main, NULL)) {
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    OLSR_PRINTF(1, "SPF: cannot start worker thread, running SPF inline\n");
+    close(spf_worker_pipe[0]);
+    close(spf_worker_pipe[1]);
+    failed = true;
+    return false;
+  }
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  add_olsr_socket(spf_worker_pipe[0], NULL, &olsr_spf_worker_event, NULL, SP_IMM_READ);
+  spf_worker_done = done;
+  spf_worker_started = true;
+  return true;
+}
+
+/*
+ * olsr_spf_worker_stop
+ *
+ * Wait for the worker thread to finish and release its resources.
+ */
+void
+olsr_spf_worker_stop(void)
+{
+  if (!spf_worker_started) {
+    return;
+  }
+
+  pthread_mutex_lock(&spf_worker_mutex);
+  spf_worker_stopping = true;
+  pthread_cond_signal(&spf_worker_cond);
+  pthread_mutex_unlock(&spf_worker_mutex);
+  pthread_join(spf_worker_thread, NULL);
+
+  remove_olsr_socket(spf_worker_pipe[0], NULL, &olsr_spf_worker_event);
+  close(spf_worker_pipe[0]);
+  close(spf_worker_pipe[1]);
+  spf_worker_started = false;
+
+  free(spf_worker_job.edge_first);
+  free(spf_worker_job.edge_target);
+  free(spf_worker_job.edge_cost);
+  free(spf_worker_job.direct);
+  free(spf_worker_job.cand);
+  free(spf_worker_job.path_cost);
+  free(spf_worker_job.first_hop);
+  free(spf_worker_job.hops);
+  memset(&spf_worker_job, 0, sizeof(spf_worker_job));
+}
+
+/*
+ * olsr_spf_worker_busy
+ *
+ * return true if the worker is running a job.
+ */
+bool
+olsr_spf_worker_busy(void)
+{
+  bool running;
+
+  if (!spf_worker_started) {
+    return false;
+  }
+
+  pthread_mutex_lock(&spf_worker_mutex);
+  running = spf_worker_running;
+  pthread_mutex_unlock(&spf_worker_mutex);
+  return running;
+}
+
+/*
+ * olsr_spf_worker_job
+ *
+ * Make room for a job with the given size.
+ * return the job to be filled in, NULL if the worker is busy
+ * or we are out of memory.
+ */
+struct spf_job *
+olsr_spf_worker_job(uint32_t vertex_count, uint32_t edge_count)
+{
+  struct spf_job *job = &spf_worker_job;
+  void *ptr;
+
+  if (olsr_spf_worker_busy()) {
+    return NULL;
+  }
+
+  if (vertex_count + 1 > job->vertex_size) {
+#define SPF_JOB_GROW(field) \
+    if (!(ptr = realloc(job->field, (vertex_count + 1) * sizeof(*job->field)))) { \
+      return NULL; \
+    } \
+    job->field = ptr;
+
+    SPF_JOB_GROW(edge_first);
+    SPF_JOB_GROW(direct);
+    SPF_JOB_GROW(cand);
+    SPF_JOB_GROW(path_cost);
+    SPF_JOB_GROW(first_hop);
+    SPF_JOB_GROW(hops);
+#undef SPF_JOB_GROW
+    job->vertex_size = vertex_count + 1;
+  }
+
+  if (edge_count > job->edge_size) {
+    if (!(ptr = realloc(job->edge_target, edge_count * sizeof(*job->edge_target)))) {
+      return NULL;
+    }
+    job->edge_target = ptr;
+    if (!(ptr = realloc(job->edge_cost, edge_count * sizeof(*job->edge_cost)))) {
+      return NULL;
+    }
+    job->edge_cost = ptr;
+    job->edge_size = edge_count;
+  }
+
+  job->vertex_count = vertex_count;
+  job->edge_count = edge_count;
+  return job;
+}
+
+/*
+ * olsr_spf_worker_submit
+ *
+ * Hand the job over to the worker thread.
+ */
+void
+olsr_spf_worker_submit(void)
+{
+  pthread_mutex_lock(&spf_worker_mutex);
+  spf_worker_running = true;
+  pthread_cond_signal(&spf_worker_cond);
+  pthread_mutex_unlock(&spf_worker_mutex);
+}
+
+#endif /* __linux__ */
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,91 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifndef _OLSR_SPF_WORKER_H
+#define _OLSR_SPF_WORKER_H
+
+#include "olsr_types.h"
+#include "common/heap.h"
+
+/* no 1st hop neighbor on the path to a vertex */
+#define SPF_JOB_NO_HOP ((uint32_t)-1)
+
+/*
+ * A SPF calculation for the worker thread. The input is a private
+ * copy of the lsdb snapshot, so the main loop can keep changing the
+ * lsdb while the worker runs. Vertices are referred to by their
+ * index in the snapshot.
+ */
+struct spf_job {
+  uint32_t generation;                 /* generation of the snapshot the job was copied from */
+  uint32_t vertex_count;               /* number of vertices */
+  uint32_t edge_count;                 /* number of edges */
+  uint32_t vertex_size;                /* allocated size of the vertex arrays */
+  uint32_t edge_size;                  /* allocated size of the edge arrays */
+  uint32_t source;                     /* index of our own vertex */
+  unsigned int arity;                  /* arity of the candidate heap */
+  uint32_t *edge_first;                /* first edge slot of each vertex, vertex_count + 1 entries */
+  uint32_t *edge_target;               /* index of the destination vertex of each edge */
+  olsr_linkcost *edge_cost;            /* cost of each edge */
+  uint8_t *direct;                     /* vertex is a 1st hop neighbor */
+  struct array_heap_node *cand;        /* candidate heap node of each vertex */
+  olsr_linkcost *path_cost;            /* result, SPF calculated distance */
+  uint32_t *first_hop;                 /* result, index of the 1st hop neighbor on the path */
+  uint8_t *hops;                       /* result, SPF calculated hopcount */
+  bool failed;                         /* result, the worker ran out of memory */
+};
+
+typedef void (*spf_worker_done_func) (struct spf_job *job);
+
+bool olsr_spf_worker_start(spf_worker_done_func done);
+void olsr_spf_worker_stop(void);
+bool olsr_spf_worker_busy(void);
+struct spf_job *olsr_spf_worker_job(uint32_t vertex_count, uint32_t edge_count);
+void olsr_spf_worker_submit(void);
+
+#endif /* _OLSR_SPF_WORKER_H */
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
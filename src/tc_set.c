@@ -164,6 +164,7 @@ olsr_add_tc_entry(union olsr_ip_addr *adr)
    */
   avl_insert(&tc_tree, &tc->vertex_node, AVL_DUP_NO);
   olsr_lock_tc_entry(tc);
+  olsr_spf_invalidate();
 
   /*
    * Initialize subtrees for edges and prefixes.
@@ -306,6 +307,7 @@ olsr_delete_tc_entry(struct tc_entry *tc)
   tc->validity_timer = NULL;
 
   avl_delete(&tc_tree, &tc->vertex_node);
+  olsr_spf_invalidate();
   olsr_unlock_tc_entry(tc);
 }
 
@@ -410,6 +412,8 @@ olsr_expire_tc_edge_gc(void *context)
 bool
 olsr_calc_tc_edge_entry_etx(struct tc_edge_entry *tc_edge)
 {
+  olsr_linkcost old_cost;
+
   /*
    * Some sanity check before recalculating the etx.
    */
@@ -417,7 +421,11 @@ olsr_calc_tc_edge_entry_etx(struct tc_edge_entry *tc_edge)
     return false;
   }
 
+  old_cost = tc_edge->cost;
   tc_edge->cost = olsr_calc_tc_cost(tc_edge);
+  if (tc_edge->cost != old_cost) {
+    olsr_spf_edge_cost_changed(tc_edge, old_cost);
+  }
   return true;
 }
 
@@ -453,6 +461,7 @@ olsr_add_tc_edge_entry(struct tc_entry *tc, union olsr_ip_addr *addr, uint16_t a
    */
   avl_insert(&tc->edge_tree, &tc_edge->edge_node, AVL_DUP_NO);
   olsr_lock_tc_entry(tc);
+  olsr_spf_invalidate();
 
   /*
    * Connect backpointer.
@@ -513,6 +522,7 @@ olsr_delete_tc_edge_entry(struct tc_edge_entry *tc_edge)
 
   tc = tc_edge->tc;
   avl_delete(&tc->edge_tree, &tc_edge->edge_node);
+  olsr_spf_invalidate();
   olsr_unlock_tc_entry(tc);
 
   /*
@@ -667,6 +677,183 @@ olsr_tc_update_edge(struct tc_entry *tc, uint16_t ansn, const unsigned char **cu
   return edge_change;
 }
 
+/**
+ * Check if the neighbor addresses of a TC are strictly ascending
+ * and fill the message completely, so the edges can be merged
+ * in a single pass.
+ *
+ * @param curr pointer to the first advertised neighbor
+ * @param limit end of the message
+ * @return true if the edges can be merged
+ */
+static bool
+olsr_tc_edges_sorted(const unsigned char *curr, const unsigned char *limit)
+{
+  const size_t entry_size = olsr_cnf->ipsize + olsr_sizeof_tc_lq_pair();
+  const unsigned char *prev;
+
+  if ((size_t)(limit - curr) % entry_size != 0) {
+    return false;
+  }
+
+  for (prev = curr, curr += entry_size; curr < limit; prev = curr, curr += entry_size) {
+    if (avl_comp_default(prev, curr) >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Known edges of the TC being merged, their costs are
+ * recalculated in one pass after the whole message is parsed.
+ */
+static struct {
+  uint32_t count, size;
+  struct tc_edge_entry **edge;
+  const void **lq;
+  olsr_linkcost *cost;
+} tc_recost = { 0, 0, NULL, NULL, NULL };
+
+static void
+olsr_tc_recost_reserve(uint32_t needed)
+{
+  uint32_t new_size = tc_recost.size;
+
+  if (needed <= new_size) {
+    return;
+  }
+  while (new_size < needed) {
+    new_size = new_size * 2 + 16;
+  }
+  tc_recost.edge = realloc(tc_recost.edge, new_size * sizeof(*tc_recost.edge));
+  tc_recost.lq = realloc(tc_recost.lq, new_size * sizeof(*tc_recost.lq));
+  tc_recost.cost = realloc(tc_recost.cost, new_size * sizeof(*tc_recost.cost));
+  if (!tc_recost.edge || !tc_recost.lq || !tc_recost.cost) {
+    OLSR_PRINTF(1, "TC: out of memory for %u edges\n", new_size);
+    olsr_exit(__func__, EXIT_FAILURE);
+  }
+  tc_recost.size = new_size;
+}
+
+/*
+ * Same as olsr_calc_tc_edge_entry_etx() for all collected edges.
+ */
+static void
+olsr_tc_recost_edges(void)
+{
+  olsr_linkcost old_cost;
+  uint32_t i;
+
+  olsr_calc_tc_costs(tc_recost.cost, tc_recost.lq, tc_recost.count);
+  for (i = 0; i < tc_recost.count; i++) {
+    old_cost = tc_recost.edge[i]->cost;
+    tc_recost.edge[i]->cost = tc_recost.cost[i];
+    if (tc_recost.cost[i] != old_cost) {
+      olsr_spf_edge_cost_changed(tc_recost.edge[i], old_cost);
+    }
+  }
+  tc_recost.count = 0;
+}
+
+/**
+ * Merge the sorted neighbor addresses of a TC into the edge tree
+ * of its entry in a single pass, see olsr_tc_edges_sorted().
+ * Edges inside the borders that are not part of the TC and have
+ * an older ANSN are deleted on the way.
+ *
+ * @param tc the TC entry to update
+ * @param ansn the advertised neighbor set sequence number
+ * @param curr pointer to the first advertised neighbor
+ * @param limit end of the message
+ * @param lower_border the lower border, NULL if no edges are revoked
+ * @param upper_border the upper border
+ * @return true if the edges have changed
+ */
+static bool
+olsr_merge_tc_edges(struct tc_entry *tc, uint16_t ansn, const unsigned char *curr, const unsigned char *limit,
+                    union olsr_ip_addr *lower_border, union olsr_ip_addr *upper_border)
+{
+  struct avl_node *edge_node, *next_edge_node;
+  struct tc_edge_entry *tc_edge;
+  union olsr_ip_addr neighbor;
+  bool last = false, retval = false;
+  int cmp = 0;
+
+  olsr_tc_recost_reserve((limit - curr) / (olsr_cnf->ipsize + olsr_sizeof_tc_lq_pair()) + 1);
+
+  edge_node = avl_walk_first(&tc->edge_tree);
+  while (!last) {
+    last = curr >= limit;
+    if (!last) {
+      pkt_get_ipaddress(&curr, &neighbor);
+    }
+
+    /*
+     * Edges in front of the neighbor are not part of this TC,
+     * after the last neighbor only the ones within the borders matter.
+     */
+    for (; edge_node; edge_node = next_edge_node) {
+      tc_edge = edge_tree2tc_edge(edge_node);
+      if (!last) {
+        cmp = avl_comp_default(&tc_edge->T_dest_addr, &neighbor);
+        if (cmp >= 0) {
+          break;
+        }
+      } else if (!lower_border || avl_comp_default(upper_border, &tc_edge->T_dest_addr) <= 0) {
+        break;
+      }
+      next_edge_node = avl_walk_next(edge_node);
+
+      if (lower_border && avl_comp_default(lower_border, &tc_edge->T_dest_addr) <= 0
+          && avl_comp_default(upper_border, &tc_edge->T_dest_addr) > 0 && SEQNO_GREATER_THAN(ansn, tc_edge->ansn)) {
+        olsr_delete_tc_edge_entry(tc_edge);
+        retval = true;
+      }
+    }
+
+    if (last) {
+      break;
+    }
+
+    if (edge_node && cmp == 0) {
+
+      /*
+       * We know this edge - Update entry.
+       */
+      tc_edge = edge_tree2tc_edge(edge_node);
+      edge_node = avl_walk_next(edge_node);
+
+      tc_edge->ansn = ansn;
+      olsr_deserialize_tc_lq_pair(&curr, tc_edge);
+      tc_recost.edge[tc_recost.count] = tc_edge;
+      tc_recost.lq[tc_recost.count++] = tc_edge->linkquality;
+      retval = true;
+      continue;
+    }
+
+    /*
+     * Yet unknown - create it.
+     * Check if the address is allowed.
+     */
+    if (!olsr_validate_address(&neighbor)) {
+      curr += olsr_sizeof_tc_lq_pair();
+      continue;
+    }
+
+    tc_edge = olsr_add_tc_edge_entry(tc, &neighbor, ansn);
+    if (!tc_edge) {
+      curr += olsr_sizeof_tc_lq_pair();
+      continue;
+    }
+    olsr_deserialize_tc_lq_pair(&curr, tc_edge);
+    retval = true;
+  }
+
+  olsr_tc_recost_edges();
+  return retval;
+}
+
 /**
  * Lookup an edge hanging off a TC entry.
  *
@@ -778,7 +965,7 @@ olsr_input_tc(union olsr_message * msg, struct interface_olsr * input_if __attri
   union olsr_ip_addr originator;
   const unsigned char *limit, *curr;
   struct tc_entry *tc;
-  bool emptyTC;
+  bool emptyTC, merged = false;
 
   union olsr_ip_addr lower_border_ip, upper_border_ip;
   int borderSet = 0;
@@ -882,7 +1069,24 @@ olsr_input_tc(union olsr_message * msg, struct interface_olsr * input_if __attri
   limit = (unsigned char *)msg + size;
   borderSet = 0;
   emptyTC = curr >= limit;
-  while (curr < limit) {
+
+  if (!emptyTC && olsr_cnf->lq_level > 0 && olsr_tc_edges_sorted(curr, limit)) {
+
+    /*
+     * The borders are known in advance, so revoked edges are
+     * deleted while the sorted neighbors are merged.
+     */
+    memcpy(&lower_border_ip, curr, olsr_cnf->ipsize);
+    memcpy(&upper_border_ip, limit - olsr_cnf->ipsize - olsr_sizeof_tc_lq_pair(), olsr_cnf->ipsize);
+    borderSet = olsr_calculate_tc_border(lower_border, &lower_border_ip, upper_border, &upper_border_ip);
+
+    if (olsr_merge_tc_edges(tc, ansn, curr, limit, borderSet ? &lower_border_ip : NULL, &upper_border_ip)) {
+      changes_topology = true;
+    }
+    merged = true;
+  }
+
+  while (!merged && curr < limit) {
     if (olsr_tc_update_edge(tc, ansn, &curr, &upper_border_ip)) {
       changes_topology = true;
     }
@@ -896,7 +1100,7 @@ olsr_input_tc(union olsr_message * msg, struct interface_olsr * input_if __attri
   /*
    * Calculate real border IPs.
    */
-  if (borderSet) {
+  if (borderSet && !merged) {
     borderSet = olsr_calculate_tc_border(lower_border, &lower_border_ip, upper_border, &upper_border_ip);
   }
 
@@ -918,7 +1122,9 @@ olsr_input_tc(union olsr_message * msg, struct interface_olsr * input_if __attri
     /*
      * Delete all old tc edges within borders.
      */
-    olsr_delete_revoked_tc_edges(tc, ansn, &lower_border_ip, &upper_border_ip);
+    if (!merged) {
+      olsr_delete_revoked_tc_edges(tc, ansn, &lower_border_ip, &upper_border_ip);
+    }
   } else {
 
     /*
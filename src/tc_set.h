@@ -47,6 +47,7 @@
 #include "packet.h"
 #include "common/avl.h"
 #include "common/heap.h"
+#include "common/radix_heap.h"
 #include "common/list.h"
 #include "scheduler.h"
 
@@ -64,6 +65,9 @@ struct tc_edge_entry {
   struct tc_entry *tc;                 /* backpointer to owning tc entry */
   olsr_linkcost cost;                  /* metric used for SPF calculation */
   uint16_t ansn;                       /* ansn of this edge, used for multipart msgs */
+  olsr_linkcost spf_old_cost;          /* cost during the last SPF run, if changed since */
+  struct list_node spf_change_node;    /* list of edges changed since the last SPF run */
+  uint32_t spf_slot;                   /* position in the SPF snapshot */
   uint32_t linkquality[0];
 };
 
@@ -74,8 +78,18 @@ struct tc_entry {
   union olsr_ip_addr addr;             /* vertex_node key */
   struct avl_node cand_tree_node;      /* SPF candidate heap, node keyed by path_etx */
   struct heap_node cand_heap_node;     /* SPF candidate binary heap, node keyed by path_etx */
+  struct array_heap_node cand_array_node; /* SPF candidate array heap, node keyed by path_etx */
+  struct radix_heap_node cand_radix_node; /* SPF candidate radix heap, node keyed by path_etx */
   olsr_linkcost path_cost;             /* SPF calculated distance, cand_tree_node key */
   struct list_node path_list_node;     /* SPF result list */
+  struct tc_entry *spf_parent;         /* SPF calculated predecessor in the shortest path tree */
+  struct list_node spf_child_list;     /* head of the SPF children, used by incremental SPF */
+  struct list_node spf_sibling_node;   /* node in the spf_child_list of spf_parent */
+  struct link_entry *spf_link;         /* link to this vertex if it is a 1st hop neighbor */
+  uint32_t spf_link_version;           /* SPF run which has set spf_link */
+  uint32_t spf_index;                  /* position in the SPF snapshot */
+  bool spf_cand;                       /* vertex is on the SPF candidate set */
+  bool spf_affected;                   /* vertex lost its path during incremental SPF */
   struct avl_tree edge_tree;           /* subtree for edges */
   struct avl_tree prefix_tree;         /* subtree for prefixes */
   struct link_entry *next_hop;         /* SPF calculated link to the 1st hop neighbor */
@@ -104,7 +118,11 @@ struct tc_entry {
 AVLNODE2STRUCT(vertex_tree2tc, struct tc_entry, vertex_node);
 AVLNODE2STRUCT(cand_tree2tc, struct tc_entry, cand_tree_node);
 HEAPNODE2STRUCT(cand_heap2tc, struct tc_entry, cand_heap_node);
+ARRAYHEAPNODE2STRUCT(cand_array2tc, struct tc_entry, cand_array_node);
+RADIXHEAPNODE2STRUCT(cand_radix2tc, struct tc_entry, cand_radix_node);
 LISTNODE2STRUCT(pathlist2tc, struct tc_entry, path_list_node);
+LISTNODE2STRUCT(spf_sibling2tc, struct tc_entry, spf_sibling_node);
+LISTNODE2STRUCT(spf_change2tc_edge, struct tc_edge_entry, spf_change_node);
 
 /*
  * macros for traversing vertices, edges and prefixes in the link state database.
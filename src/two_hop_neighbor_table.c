@@ -46,8 +46,10 @@
 #include "neighbor_table.h"
 #include "net_olsr.h"
 #include "scheduler.h"
+#include "olsr.h"
+#include "lq_mpr.h"
 
-struct neighbor_2_entry two_hop_neighbortable[HASHSIZE];
+struct hash_table two_hop_neighbortable;
 
 /**
  *Initialize 2 hop neighbor table
@@ -55,10 +57,8 @@ struct neighbor_2_entry two_hop_neighbortable[HASHSIZE];
 void
 olsr_init_two_hop_table(void)
 {
-  int idx;
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    two_hop_neighbortable[idx].next = &two_hop_neighbortable[idx];
-    two_hop_neighbortable[idx].prev = &two_hop_neighbortable[idx];
+  if (hash_table_init(&two_hop_neighbortable, HASHSIZE)) {
+    olsr_exit(__func__, EXIT_FAILURE);
   }
 }
 
@@ -82,6 +82,8 @@ olsr_delete_neighbor_pointer(struct neighbor_2_entry *two_hop_entry, struct neig
       struct neighbor_list_entry *entry_to_delete = entry;
       entry = entry->next;
 
+      olsr_lq_mpr_forget_link(two_hop_entry, entry_to_delete);
+
       /* dequeue */
       DEQUEUE_ELEM(entry_to_delete);
 
@@ -104,6 +106,8 @@ olsr_delete_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 {
   struct neighbor_list_entry *one_hop_list;
 
+  olsr_lq_mpr_forget(two_hop_neighbor);
+
   one_hop_list = two_hop_neighbor->neighbor_2_nblist.next;
 
   /* Delete one hop links */
@@ -118,7 +122,7 @@ olsr_delete_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
   }
 
   /* dequeue */
-  DEQUEUE_ELEM(two_hop_neighbor);
+  hash_table_remove(&two_hop_neighbortable, &two_hop_neighbor->nbr2_hash);
   free(two_hop_neighbor);
 }
 
@@ -132,10 +136,10 @@ olsr_delete_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 void
 olsr_insert_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 {
-  uint32_t hash = olsr_ip_hashing(&two_hop_neighbor->neighbor_2_addr);
+  uint32_t hash = olsr_ip_hash(&two_hop_neighbor->neighbor_2_addr);
 
   /* Queue */
-  QUEUE_ELEM(two_hop_neighbortable[hash], two_hop_neighbor);
+  hash_table_add(&two_hop_neighbortable, &two_hop_neighbor->nbr2_hash, hash);
 }
 
 /**
@@ -149,26 +153,18 @@ olsr_insert_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 struct neighbor_2_entry *
 olsr_lookup_two_hop_neighbor_table(const union olsr_ip_addr *dest)
 {
-
   struct neighbor_2_entry *neighbor_2;
-  uint32_t hash = olsr_ip_hashing(dest);
+  union olsr_ip_addr *main_addr;
 
   /* printf("LOOKING FOR %s\n", olsr_ip_to_string(&buf, dest)); */
-  for (neighbor_2 = two_hop_neighbortable[hash].next; neighbor_2 != &two_hop_neighbortable[hash]; neighbor_2 = neighbor_2->next) {
-    struct mid_address *adr;
-
-    /* printf("Checking %s\n", olsr_ip_to_string(&buf, dest)); */
-    if (ipequal(&neighbor_2->neighbor_2_addr, dest))
-      return neighbor_2;
+  neighbor_2 = olsr_lookup_two_hop_neighbor_table_mid(dest);
+  if (neighbor_2 != NULL)
+    return neighbor_2;
 
-    adr = mid_lookup_aliases(&neighbor_2->neighbor_2_addr);
-
-    while (adr) {
-      if (ipequal(&adr->alias, dest))
-        return neighbor_2;
-      adr = adr->next_alias;
-    }
-  }
+  /* dest might be an alias of the two hop neighbor */
+  main_addr = mid_lookup_main_addr(dest);
+  if (main_addr != NULL)
+    return olsr_lookup_two_hop_neighbor_table_mid(main_addr);
 
   return NULL;
 }
@@ -185,16 +181,19 @@ olsr_lookup_two_hop_neighbor_table(const union olsr_ip_addr *dest)
 struct neighbor_2_entry *
 olsr_lookup_two_hop_neighbor_table_mid(const union olsr_ip_addr *dest)
 {
-  struct neighbor_2_entry *neighbor_2;
+  struct list_node *node;
   uint32_t hash;
 
   /* printf("LOOKING FOR %s\n", olsr_ip_to_string(&buf, dest)); */
-  hash = olsr_ip_hashing(dest);
+  hash = olsr_ip_hash(dest);
+
+  HASH_TABLE_FOR_EACH_HASH(&two_hop_neighbortable, node, hash) {
+    struct neighbor_2_entry *neighbor_2 = list2nbr2(node);
 
-  for (neighbor_2 = two_hop_neighbortable[hash].next; neighbor_2 != &two_hop_neighbortable[hash]; neighbor_2 = neighbor_2->next) {
     if (ipequal(&neighbor_2->neighbor_2_addr, dest))
       return neighbor_2;
   }
+  HASH_TABLE_FOR_EACH_HASH_END(node);
 
   return NULL;
 }
@@ -209,32 +208,30 @@ void
 olsr_print_two_hop_neighbor_table(void)
 {
   /* The whole function makes no sense without it. */
-  int i;
+  struct neighbor_2_entry *neigh2;
   const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
 
   OLSR_PRINTF(1, "\n--- %s ----------------------- TWO-HOP NEIGHBORS\n\n" "IP addr (2-hop)  IP addr (1-hop)  Total cost\n",
               olsr_wallclock_string());
 
-  for (i = 0; i < HASHSIZE; i++) {
-    struct neighbor_2_entry *neigh2;
-    for (neigh2 = two_hop_neighbortable[i].next; neigh2 != &two_hop_neighbortable[i]; neigh2 = neigh2->next) {
-      struct neighbor_list_entry *entry;
-      bool first = true;
-
-      for (entry = neigh2->neighbor_2_nblist.next; entry != &neigh2->neighbor_2_nblist; entry = entry->next) {
-        struct ipaddr_str buf;
-        struct lqtextbuffer lqbuffer;
-        if (first) {
-          OLSR_PRINTF(1, "%-*s  ", ipwidth, olsr_ip_to_string(&buf, &neigh2->neighbor_2_addr));
-          first = false;
-        } else {
-          OLSR_PRINTF(1, "                 ");
-        }
-        OLSR_PRINTF(1, "%-*s  %s\n", ipwidth, olsr_ip_to_string(&buf, &entry->neighbor->neighbor_main_addr),
-                    get_linkcost_text(entry->path_linkcost, false, &lqbuffer));
+  OLSR_FOR_ALL_NBR2_ENTRIES(neigh2) {
+    struct neighbor_list_entry *entry;
+    bool first = true;
+
+    for (entry = neigh2->neighbor_2_nblist.next; entry != &neigh2->neighbor_2_nblist; entry = entry->next) {
+      struct ipaddr_str buf;
+      struct lqtextbuffer lqbuffer;
+      if (first) {
+        OLSR_PRINTF(1, "%-*s  ", ipwidth, olsr_ip_to_string(&buf, &neigh2->neighbor_2_addr));
+        first = false;
+      } else {
+        OLSR_PRINTF(1, "                 ");
       }
+      OLSR_PRINTF(1, "%-*s  %s\n", ipwidth, olsr_ip_to_string(&buf, &entry->neighbor->neighbor_main_addr),
+                  get_linkcost_text(entry->path_linkcost, false, &lqbuffer));
     }
   }
+  OLSR_FOR_ALL_NBR2_ENTRIES_END(neigh2);
 }
 #endif /* NODEBUG */
 
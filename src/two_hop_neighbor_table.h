@@ -45,6 +45,7 @@
 #include "defs.h"
 #include "hashing.h"
 #include "lq_plugin.h"
+#include "common/hash_table.h"
 
 #define	NB2S_COVERED 	0x1     /* node has been covered by a MPR */
 
@@ -53,6 +54,8 @@ struct neighbor_list_entry {
   olsr_linkcost second_hop_linkcost;
   olsr_linkcost path_linkcost;
   olsr_linkcost saved_path_linkcost;
+  olsr_linkcost mpr_path_linkcost;     /* path cost seen by the last LQ-MPR run */
+  bool mpr_selected;                   /* neighbor chosen as LQ-MPR for this entry */
   struct neighbor_list_entry *next;
   struct neighbor_list_entry *prev;
 };
@@ -63,11 +66,22 @@ struct neighbor_2_entry {
   uint8_t processed;                   /*used in mpr calculation */
   int16_t neighbor_2_pointer;          /* Neighbor count */
   struct neighbor_list_entry neighbor_2_nblist;
-  struct neighbor_2_entry *prev;
-  struct neighbor_2_entry *next;
+  struct hash_node nbr2_hash;          /* hashed by neighbor_2_addr */
+  olsr_linkcost mpr_best_1hop;         /* direct link cost seen by the last LQ-MPR run */
+  struct list_node mpr_dirty_node;     /* queued for the next LQ-MPR run */
 };
 
-extern struct neighbor_2_entry two_hop_neighbortable[HASHSIZE];
+LISTNODE2STRUCT(list2nbr2, struct neighbor_2_entry, nbr2_hash.list);
+LISTNODE2STRUCT(mpr_dirty2nbr2, struct neighbor_2_entry, mpr_dirty_node);
+
+#define OLSR_FOR_ALL_NBR2_ENTRIES(nbr2) \
+{ \
+  struct list_node *_nbr2_node; \
+  HASH_TABLE_FOR_EACH(&two_hop_neighbortable, _nbr2_node) \
+    nbr2 = list2nbr2(_nbr2_node);
+#define OLSR_FOR_ALL_NBR2_ENTRIES_END(nbr2) HASH_TABLE_FOR_EACH_END(_nbr2_node) }
+
+extern struct hash_table two_hop_neighbortable;
 
 void olsr_init_two_hop_table(void);
 